@@ -41,6 +41,8 @@
 
 #include "Utils/FontLoader.h"
 #include <Utils/ToolboxUtils.h>
+#include <Utils/FrameProfiler.h>
+#include <Utils/SettingsStore.h>
 
 #include <EmbeddedResource.h>
 #include "resource.h"
@@ -60,6 +62,7 @@ namespace {
     utf8::string imgui_inifile;
     bool imgui_inifile_changed = false;
     bool settings_folder_changed = false;
+    SettingsStore settings_store;
 
     bool must_self_destruct = false; // is true when toolbox should quit
     GW::HookEntry Update_Entry;
@@ -367,8 +370,12 @@ namespace {
             return false; // Not finished terminating
         }
         vec.push_back(&m);
-        m.Initialize();
-        m.LoadSettings(OpenSettingsFile());
+        {
+            // StoC callbacks registered while the module sets itself up are profiled under its name
+            FrameProfiler::OwnerScope owner(m.Name());
+            m.Initialize();
+            m.LoadSettings(OpenSettingsFile());
+        }
         ReorderModules(vec);
         return true; // Added successfully
     }
@@ -402,6 +409,12 @@ namespace {
 
 
 
+    bool ModuleWndProc(ToolboxModule* m, const UINT Message, const WPARAM wParam, const LPARAM lParam)
+    {
+        FrameProfiler::Scope scope(m->Name(), FrameProfiler::Phase::WndProc);
+        return m->WndProc(Message, wParam, lParam);
+    }
+
     LRESULT CALLBACK WndProc(const HWND hWnd, const UINT Message, const WPARAM wParam, const LPARAM lParam)
     {
         static bool right_mouse_down = false;
@@ -437,7 +450,7 @@ namespace {
                 io.MousePos = { (float)GET_X_LPARAM(right_click_lparam), (float)GET_Y_LPARAM(right_click_lparam) };
 #pragma warning( pop )
                 for (const auto m : tb.GetAllModules()) {
-                    m->WndProc(WM_GW_RBUTTONCLICK, 0, right_click_lparam);
+                    ModuleWndProc(m, WM_GW_RBUTTONCLICK, 0, right_click_lparam);
                 }
             }
             mouse_moved_whilst_right_clicking = 0;
@@ -490,7 +503,7 @@ namespace {
             }
 
             for (const auto m : tb.GetAllModules()) {
-                m->WndProc(Message, wParam, lParam);
+                ModuleWndProc(m, Message, wParam, lParam);
             }
         }
                      break;
@@ -513,7 +526,7 @@ namespace {
             }
             bool captured = false;
             for (const auto m : tb.GetAllModules()) {
-                if (m->WndProc(Message, wParam, lParam)) {
+                if (ModuleWndProc(m, Message, wParam, lParam)) {
                     captured = true;
                 }
             }
@@ -556,7 +569,7 @@ namespace {
         {
             bool captured = false;
             for (const auto m : tb.GetAllModules()) {
-                if (m->WndProc(Message, wParam, lParam)) {
+                if (ModuleWndProc(m, Message, wParam, lParam)) {
                     captured = true;
                 }
             }
@@ -577,7 +590,7 @@ namespace {
             // Custom messages registered via RegisterWindowMessage
             if (Message >= 0xC000 && Message <= 0xFFFF) {
                 for (const auto m : tb.GetAllModules()) {
-                    m->WndProc(Message, wParam, lParam);
+                    ModuleWndProc(m, Message, wParam, lParam);
                 }
             }
             break;
@@ -852,11 +865,13 @@ std::filesystem::path GWToolbox::SaveSettings()
         m->SaveSettings(ini);
     }
     ToolboxSettings::LoadModules(ini);
-    ASSERT(Resources::SaveIniToFile(ini->location_on_disk, ini) == 0);
-    const auto dir = ini->location_on_disk.parent_path();
-    const auto dirstr = dir.wstring();
-    const std::wstring printable = std::regex_replace(dirstr, std::wregex(L"\\\\"), L"/");
-    Log::LogW(L"Toolbox settings saved to %s", printable.c_str());
+    // Written on a worker thread, unless we're about to unload and the workers may not get to it
+    const bool async = gwtoolbox_state != GWToolboxState::DrawTerminating;
+    const auto result = settings_store.Save(ini, ini->location_on_disk, async);
+    ASSERT(result != SettingsStore::Result::Failed);
+    if (result != SettingsStore::Result::Unchanged) {
+        Log::LogW(L"Toolbox settings saved to %s", ini->location_on_disk.parent_path().generic_wstring().c_str());
+    }
     settings_folder_changed = false;
     return ini->location_on_disk;
 }
@@ -906,16 +921,18 @@ bool GWToolbox::CanTerminate()
 
 void GWToolbox::Update(GW::HookStatus*)
 {
-    static DWORD last_tick_count;
-    if (last_tick_count == 0) {
-        last_tick_count = GetTickCount();
+    static int64_t ticks_per_second = 0;
+    static int64_t last_tick = 0;
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    const int64_t tick = counter.QuadPart;
+    if (!ticks_per_second) {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        ticks_per_second = frequency.QuadPart;
+        last_tick = tick;
     }
-
-    // @Enhancement:
-    // Improve precision with QueryPerformanceCounter
-    const auto tick = GetTickCount();
-    const auto delta = tick - last_tick_count;
-    const auto delta_f = static_cast<float>(delta) / 1000.f;
+    const auto delta_f = static_cast<float>(static_cast<double>(tick - last_tick) / static_cast<double>(ticks_per_second));
 
     switch (gwtoolbox_state) {
         case GWToolboxState::Terminating:
@@ -930,9 +947,9 @@ void GWToolbox::Update(GW::HookStatus*)
 
     UpdateModulesTerminating(delta_f);
 
-    // Update loop
+    // Update loop; each module decides whether it's due
     for (const auto m : modules_enabled) {
-        m->Update(delta_f);
+        m->ScheduledUpdate(tick, ticks_per_second);
     }
 
     if (!greeted && GW::Map::GetInstanceType() != GW::Constants::InstanceType::Loading) {
@@ -943,7 +960,7 @@ void GWToolbox::Update(GW::HookStatus*)
         }
     }
 
-    last_tick_count = tick;
+    last_tick = tick;
 }
 
 void GWToolbox::Draw(IDirect3DDevice9* device)
@@ -988,6 +1005,7 @@ void GWToolbox::Draw(IDirect3DDevice9* device)
     const bool world_map_showing = GW::UI::GetIsWorldMapShowing();
 
     if (!world_map_showing && minimap_enabled) {
+        FrameProfiler::Scope scope(Minimap::Instance().Name(), FrameProfiler::Phase::Draw);
         Minimap::Render(device);
     }
 
@@ -1014,6 +1032,7 @@ void GWToolbox::Draw(IDirect3DDevice9* device)
         if (world_map_showing && !uielement->ShowOnWorldMap()) {
             continue;
         }
+        FrameProfiler::Scope scope(uielement->Name(), FrameProfiler::Phase::Draw);
         uielement->Draw(device);
     }
 
@@ -1036,6 +1055,7 @@ void GWToolbox::Draw(IDirect3DDevice9* device)
         ImGui::RenderPlatformWindowsDefault();
         // TODO for OpenGL: restore current GL context.
     }
+    FrameProfiler::EndFrame();
 }
 
 void GWToolbox::DrawInitialising(IDirect3DDevice9* device)
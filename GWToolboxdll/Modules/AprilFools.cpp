@@ -13,6 +13,7 @@
 
 #include <Logger.h>
 #include <Modules/AprilFools.h>
+#include <Utils/FrameProfiler.h>
 
 #include <Defines.h>
 
@@ -88,9 +89,9 @@ namespace {
         if (listeners_added) {
             return;
         }
-        GW::StoC::RegisterPostPacketCallback<GW::Packet::StoC::AgentAdd>(&AgentAdd_Hook, OnAgentAdd);
-        GW::StoC::RegisterPacketCallback<GW::Packet::StoC::AgentRemove>(&AgentRemove_Hook, OnAgentRemove);
-        GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GameSrvTransfer>(&GameSrvTransfer_Hook, OnGameSrvTransfer);
+        FrameProfiler::RegisterPostPacketCallback<GW::Packet::StoC::AgentAdd>(&AgentAdd_Hook, OnAgentAdd);
+        FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::AgentRemove>(&AgentRemove_Hook, OnAgentRemove);
+        FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::GameSrvTransfer>(&GameSrvTransfer_Hook, OnGameSrvTransfer);
         listeners_added = true;
     }
 
@@ -1834,10 +1834,7 @@ void CHAT_CMD_FUNC(ChatCommands::CmdTB)
             // e.g. /tb save
             GWToolbox::SetSettingsFolder({});
             const auto file_location = GWToolbox::SaveSettings();
-            const auto dir = file_location.parent_path();
-            const auto dirstr = dir.wstring();
-            const auto printable = std::regex_replace(dirstr, std::wregex(L"\\\\"), L"/");
-            Log::InfoW(L"Settings saved to %s", printable.c_str());
+            Log::InfoW(L"Settings saved to %s", file_location.parent_path().generic_wstring().c_str());
         }
         else if (arg1 == L"load") {
             // e.g. /tb load
@@ -1913,10 +1910,7 @@ void CHAT_CMD_FUNC(ChatCommands::CmdTB)
         const auto sanitised_foldername = TextUtils::SanitiseFilename(arg2);
         GWToolbox::SetSettingsFolder(sanitised_foldername);
         const auto file_location = GWToolbox::SaveSettings();
-        const auto dir = file_location.parent_path();
-        const auto dirstr = dir.wstring();
-        const auto printable = std::regex_replace(dirstr, std::wregex(L"\\\\"), L"/");
-        Log::InfoW(L"Settings saved to %s", printable.c_str());
+        Log::InfoW(L"Settings saved to %s", file_location.parent_path().generic_wstring().c_str());
     }
     else if (arg1 == L"load") {
         // e.g. /tb load tas
@@ -23,6 +23,7 @@
 
 #include <GWToolbox.h>
 #include <Utils/TextUtils.h>
+#include <Utils/TextMatcher.h>
 
 //#define PRINT_CHAT_PACKETS
 
@@ -85,7 +86,7 @@ namespace {
     constexpr uint32_t NOISE_REDUCTION_DELAY_MS = 1000;
 
     // Chat filter
-    std::vector<std::wstring> bycontent_words;
+    TextMatcher bycontent_words;
     char bycontent_word_buf[FILTER_BUF_SIZE] = "";
     bool bycontent_filedirty = false;
 
@@ -167,11 +168,11 @@ namespace {
 
 
 
-    void ParseBuffer(const char* text, std::vector<std::wstring>& words)
+    void ParseBuffer(const char* text, TextMatcher& matcher)
     {
         using namespace TextUtils;
-        words.clear();
-        const auto text_ws = RemoveDiacritics(ToLower(StringToWString(text)));
+        std::vector<std::wstring> words;
+        const auto text_ws = StringToWString(text);
         std::wstringstream stream(text_ws.c_str());
         std::wstring word;
         while (std::getline(stream, word)) {
@@ -180,6 +181,7 @@ namespace {
             }
             words.push_back(word);
         }
+        matcher.Build(words);
     }
 
     void ParseBuffer(const char* text, std::vector<std::wregex>& regex)
@@ -254,12 +256,76 @@ namespace {
         return true;
     }
 
-    const wchar_t* rare_item_names[] = {
-        L"\x22D9\xE7B8\xE9DD\x2322", // Glob of ectoplasm
-        L"\x22EA\xFDA9\xDE53\x2D16", // Obsidian shard
-        L"\x8101\x730E"              // Lockpick
+    // Leading encoded word of a string (its string id, see GetSegmentLength) packed into an integer; 0 if there isn't one
+    constexpr uint64_t EncodedWordKey(const wchar_t* encoded_string)
+    {
+        if (!(encoded_string && *encoded_string > 0x100)) {
+            return 0;
+        }
+        uint64_t key = 0;
+        size_t length = 0;
+        do {
+            if (++length > 4) {
+                return 0;
+            }
+            key = key << 16 | static_cast<uint16_t>(*encoded_string);
+        } while (*encoded_string++ & 0x8000);
+        return key;
+    }
+
+    enum class ItemNameClass : uint8_t {
+        Other,
+        Rare,
+        Ashes
     };
 
+    struct ItemNameEntry {
+        uint64_t key;
+        ItemNameClass item_class;
+    };
+
+    // Sorted by key at compile time, so an item name is classified with one binary search
+    constexpr auto item_name_classes = [] {
+        std::array entries = {
+            ItemNameEntry{EncodedWordKey(L"\x22D9\xE7B8\xE9DD\x2322"), ItemNameClass::Rare}, // Glob of ectoplasm
+            ItemNameEntry{EncodedWordKey(L"\x22EA\xFDA9\xDE53\x2D16"), ItemNameClass::Rare}, // Obsidian shard
+            ItemNameEntry{EncodedWordKey(L"\x8101\x730E"), ItemNameClass::Rare},               // Lockpick
+
+            ItemNameEntry{EncodedWordKey(L"\x6C1F"), ItemNameClass::Ashes}, // Factions ashes.  0x6C20 is unused content "Ashes of Li".
+            ItemNameEntry{EncodedWordKey(L"\x6C21"), ItemNameClass::Ashes},
+            ItemNameEntry{EncodedWordKey(L"\x6C22"), ItemNameClass::Ashes},
+            ItemNameEntry{EncodedWordKey(L"\x6C23"), ItemNameClass::Ashes},
+            ItemNameEntry{EncodedWordKey(L"\x6C24"), ItemNameClass::Ashes},
+            ItemNameEntry{EncodedWordKey(L"\x6C25"), ItemNameClass::Ashes},
+            ItemNameEntry{EncodedWordKey(L"\x6C26"), ItemNameClass::Ashes},
+            ItemNameEntry{EncodedWordKey(L"\x6C27"), ItemNameClass::Ashes},
+            ItemNameEntry{EncodedWordKey(L"\x6C28"), ItemNameClass::Ashes},
+            ItemNameEntry{EncodedWordKey(L"\x6C29"), ItemNameClass::Ashes},
+            ItemNameEntry{EncodedWordKey(L"\x6C2A"), ItemNameClass::Ashes},
+            ItemNameEntry{EncodedWordKey(L"\x6C2B"), ItemNameClass::Ashes},
+            ItemNameEntry{EncodedWordKey(L"\x6C2C"), ItemNameClass::Ashes},
+            ItemNameEntry{EncodedWordKey(L"\x8101\x45D1"), ItemNameClass::Ashes}, // Ashes of Vocal Sogolon
+            ItemNameEntry{EncodedWordKey(L"\x8101\x45D2"), ItemNameClass::Ashes}, // Destructive Was Glaive
+            ItemNameEntry{EncodedWordKey(L"\x8101\x6B78"), ItemNameClass::Ashes}, // Ashes of Energetic Lee Sa
+            ItemNameEntry{EncodedWordKey(L"\x8101\x7325"), ItemNameClass::Ashes}, // Ashes of Pure Li Ming
+            ItemNameEntry{EncodedWordKey(L"\x8102\x5F7F"), ItemNameClass::Ashes}, // Destructive was Glaive (PvP)
+        };
+        std::ranges::sort(entries, {}, &ItemNameEntry::key);
+        return entries;
+    }();
+    static_assert(std::ranges::adjacent_find(item_name_classes, {}, &ItemNameEntry::key) == item_name_classes.end(), "Duplicate item name in item_name_classes");
+    static_assert(item_name_classes.front().key != 0, "Invalid encoded item name in item_name_classes");
+
+    ItemNameClass ClassifyItemName(const wchar_t* item_name)
+    {
+        const auto key = EncodedWordKey(item_name);
+        if (!key) {
+            return ItemNameClass::Other;
+        }
+        const auto found = std::ranges::lower_bound(item_name_classes, key, {}, &ItemNameEntry::key);
+        return found != item_name_classes.end() && found->key == key ? found->item_class : ItemNameClass::Other;
+    }
+
     bool IsRare(const wchar_t* encoded_string)
     {
         if (!encoded_string) {
@@ -268,53 +334,25 @@ namespace {
         if (encoded_string[0] == 0xA40) {
             return true; // don't ignore gold items
         }
-
         const auto item_name = GetFirstSegment(encoded_string);
         if (!item_name) {
             return false;
         }
-        const auto item_name_len = GetSegmentLength(item_name);
-        for (const auto cmp : rare_item_names) {
-            if (wcsncmp(item_name, cmp, item_name_len) == 0) {
-                return true;
-            }
+        if (!GetSegmentLength(item_name)) {
+            return true; // No encoded word to look up e.g. an empty item name; matches like any listed name
         }
-        return false;
+        return ClassifyItemName(item_name) == ItemNameClass::Rare;
     }
 
-    const wchar_t* encoded_ashes_names[] = {
-        L"\x6C1F", // Factions ashes.  0x6C20 is unused content "Ashes of Li".
-        L"\x6C21",
-        L"\x6C22",
-        L"\x6C23",
-        L"\x6C24",
-        L"\x6C25",
-        L"\x6C26",
-        L"\x6C27",
-        L"\x6C28",
-        L"\x6C29",
-        L"\x6C2A",
-        L"\x6C2B",
-        L"\x6C2C",
-        L"\x8101\x45D1", // Ashes of Vocal Sogolon
-        L"\x8101\x45D2", // Destructive Was Glaive
-        L"\x8101\x6B78", // Ashes of Energetic Lee Sa
-        L"\x8101\x7325", // Ashes of Pure Li Ming
-        L"\x8102\x5F7F", // Destructive was Glaive (PvP)
-    };
-
     bool IsAshes(const wchar_t* encoded_string)
     {
         if (!encoded_string) {
             return false;
         }
-        const auto item_name_length = GetSegmentLength(encoded_string);
-        for (const auto cmp : encoded_ashes_names) {
-            if (wcsncmp(encoded_string, cmp, item_name_length) == 0) {
-                return true;
-            }
+        if (!GetSegmentLength(encoded_string)) {
+            return true; // Same as IsRare
         }
-        return false;
+        return ClassifyItemName(encoded_string) == ItemNameClass::Ashes;
     }
 
     bool IsInChallengeMission()
@@ -678,17 +716,17 @@ namespace {
         }
 
         using namespace TextUtils;
-        const auto str = std::wstring(start, end);
+        const auto str = std::wstring_view(start, end);
         if (str.empty()) {
             return false;
         }
-        const auto sanitized = RemoveDiacritics(str);
-        const auto lowercase = ToLower(sanitized);
-        for (const auto& s : bycontent_words) {
-            if (lowercase.find(s) != std::wstring::npos) {
-                return true;
-            }
+        if (bycontent_words.Contains(str)) {
+            return true;
         }
+        if (bycontent_regex.empty()) {
+            return false;
+        }
+        const auto sanitized = RemoveDiacritics(str);
         for (const auto& r : bycontent_regex) {
             if (std::regex_search(sanitized, r)) {
                 return true;
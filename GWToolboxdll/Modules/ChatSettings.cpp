@@ -16,6 +16,7 @@
 #include <Utils/ToolboxUtils.h>
 #include <Defines.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 #include "ChatSettings.h"
 #include <Utils/TextUtils.h>
 #include <GWCA/Utilities/Scanner.h>
@@ -409,8 +410,8 @@ void ChatSettings::Initialize()
 {
     ToolboxModule::Initialize();
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::SpeechBubble>(&SpeechBubble_Entry, OnSpeechBubble);
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::DisplayDialogue>(&DisplayDialogue_Entry, OnSpeechDialogue);
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::SpeechBubble>(&SpeechBubble_Entry, OnSpeechBubble);
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::DisplayDialogue>(&DisplayDialogue_Entry, OnSpeechDialogue);
 
     const GW::UI::UIMessage ui_messages[] = {
         GW::UI::UIMessage::kPreferenceFlagChanged,
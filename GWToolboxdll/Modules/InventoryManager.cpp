@@ -27,6 +27,7 @@
 #include <Timer.h>
 #include <Logger.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 #include <Modules/InventoryManager.h>
 #include <Modules/GameSettings.h>
 
@@ -1128,13 +1129,13 @@ void InventoryManager::AttachTransactionListeners()
     if (transaction_listeners_attached) {
         return;
     }
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::TransactionDone>(&salvage_hook_entry, [this](GW::HookStatus* status, GW::Packet::StoC::TransactionDone*) {
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::TransactionDone>(&salvage_hook_entry, [this](GW::HookStatus* status, GW::Packet::StoC::TransactionDone*) {
         pending_transaction_amount--;
         status->blocked = true;
         //Log::Info("Transacted item; %d to go", pending_transaction_amount);
         Instance().pending_transaction.setState(PendingTransaction::State::Pending);
     });
-    GW::StoC::RegisterPacketCallback(&salvage_hook_entry, GAME_SMSG_TRANSACTION_REJECT, [this](GW::HookStatus* status, void*) {
+    FrameProfiler::RegisterPacketCallback(&salvage_hook_entry, GAME_SMSG_TRANSACTION_REJECT, [this](GW::HookStatus* status, void*) {
         if (!pending_transaction.in_progress()) {
             return;
         }
@@ -1142,7 +1143,7 @@ void InventoryManager::AttachTransactionListeners()
         Log::WarningW(L"Trader rejected transaction");
         status->blocked = true;
     });
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::QuotedItemPrice>(&salvage_hook_entry, [this](GW::HookStatus* status, const GW::Packet::StoC::QuotedItemPrice* packet) {
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::QuotedItemPrice>(&salvage_hook_entry, [this](GW::HookStatus* status, const GW::Packet::StoC::QuotedItemPrice* packet) {
         if (pending_transaction.item_id != packet->itemid) {
             pending_cancel_transaction = true;
             return;
@@ -22,6 +22,7 @@
 #include <Modules/ChatSettings.h>
 #include <Modules/Obfuscator.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 #include <Windows/FriendListWindow.h>
 
 #include <Defines.h>
@@ -257,10 +258,70 @@ namespace {
     std::wstring speech_message_temp_message;
 
 
+    // Name to name lookup used to swap names in messages
+    class NameMap {
+    public:
+        [[nodiscard]] const std::wstring* Find(const std::wstring_view name) const
+        {
+            const auto found = names.find(name);
+            return found == names.end() ? nullptr : &found->second;
+        }
+
+        [[nodiscard]] bool Contains(const std::wstring_view name) const { return Find(name) != nullptr; }
+
+        void Emplace(const std::wstring& from, const std::wstring& to)
+        {
+            if (from.empty() || !names.emplace(from, to).second) {
+                return;
+            }
+            first_chars.set(static_cast<uint16_t>(from[0]));
+            if (std::ranges::find(lengths, from.size()) == lengths.end()) {
+                lengths.push_back(from.size());
+                std::ranges::sort(lengths, std::greater());
+            }
+        }
+
+        void Clear()
+        {
+            names.clear();
+            lengths.clear();
+            first_chars.reset();
+        }
+
+        // Longest name that text starts with, or nullptr
+        [[nodiscard]] const std::pair<const std::wstring, std::wstring>* MatchPrefix(const std::wstring_view text) const
+        {
+            if (text.empty() || !first_chars.test(static_cast<uint16_t>(text[0]))) {
+                return nullptr;
+            }
+            for (const auto length : lengths) {
+                if (length > text.size()) {
+                    continue;
+                }
+                const auto found = names.find(text.substr(0, length));
+                if (found != names.end()) {
+                    return &*found;
+                }
+            }
+            return nullptr;
+        }
+
+    private:
+        struct Hash {
+            using is_transparent = void;
+            size_t operator()(const std::wstring_view str) const { return std::hash<std::wstring_view>{}(str); }
+        };
+
+        std::unordered_map<std::wstring, std::wstring, Hash, std::equal_to<>> names;
+        // Distinct name lengths, longest first
+        std::vector<size_t> lengths;
+        std::bitset<0x10000> first_chars;
+    };
+
     // List of obfuscated names, keyed by obfuscated
-    std::map<std::wstring, std::wstring> obfuscated_by_obfuscation;
+    NameMap obfuscated_by_obfuscation;
     // List of obfuscated names, keyed by original
-    std::map<std::wstring, std::wstring> obfuscated_by_original;
+    NameMap obfuscated_by_original;
     // Current position in the list of obfuscated names
     size_t pool_index = 0;
 
@@ -329,9 +390,8 @@ namespace {
         if (_original_name.empty()) {
             return false;
         }
-        const auto found_original = obfuscated_by_original.find(original_name);
-        if (found_original != obfuscated_by_original.end()) {
-            out.assign(found_original->second);
+        if (const auto found_original = obfuscated_by_original.Find(original_name)) {
+            out.assign(*found_original);
             return true;
         }
 
@@ -339,20 +399,19 @@ namespace {
         if (tmp_out.empty()) {
             return false;
         }
-        if (obfuscated_by_original.contains(original_name)) {
-            out.assign(obfuscated_by_original.at(original_name));
+        if (const auto found_original = obfuscated_by_original.Find(original_name)) {
+            out.assign(*found_original);
             return true;
         }
-        if (obfuscated_by_obfuscation.contains(original_name)) {
-            const auto& obfuscated_orig = obfuscated_by_obfuscation.at(original_name);
-            if (obfuscated_by_original.contains(obfuscated_orig)) {
-                out.assign(obfuscated_orig);
+        if (const auto obfuscated_orig = obfuscated_by_obfuscation.Find(original_name)) {
+            if (obfuscated_by_original.Contains(*obfuscated_orig)) {
+                out.assign(*obfuscated_orig);
                 return true;
             }
         }
-        if (!obfuscated_by_original.contains(original_name)) {
-            obfuscated_by_obfuscation.emplace(tmp_out, original_name);
-            obfuscated_by_original.emplace(original_name, tmp_out);
+        if (!obfuscated_by_original.Contains(original_name)) {
+            obfuscated_by_obfuscation.Emplace(tmp_out, original_name);
+            obfuscated_by_original.Emplace(original_name, tmp_out);
             out.assign(tmp_out);
             return true;
         }
@@ -365,34 +424,60 @@ namespace {
             return false;
         }
         const auto obfuscated_name = TextUtils::SanitizePlayerName(std::wstring(_obfuscated_name));
-        const auto found = obfuscated_by_obfuscation.find(obfuscated_name);
-        if (found == obfuscated_by_obfuscation.end()) {
+        const auto found = obfuscated_by_obfuscation.Find(obfuscated_name);
+        if (!found) {
             return false;
         }
-        out.assign(found->second);
+        out.assign(*found);
         return true;
     }
 
+    // Swaps names found in the literal (0x107 ... 0x1) segments of an encoded message
     bool ObfuscateMessage(const std::wstring_view message, std::wstring& out, const bool obfuscate = true)
     {
-        if (!wcschr(message.data(),0x107))
+        auto segment = message.find(static_cast<wchar_t>(0x107));
+        if (segment == std::wstring_view::npos)
             return false; // Message contains no player names
-        std::wstring replacemsg{message};
-        const auto& to_search = obfuscate ? obfuscated_by_original : obfuscated_by_obfuscation;
-        bool was_changed = false;
-        for (const auto& [from, to] : to_search) {
-            if (from.empty()) {
-                break;
+        const auto& names = obfuscate ? obfuscated_by_original : obfuscated_by_obfuscation;
+
+        // Only allocated once a name is swapped; moved to out at the end
+        std::wstring buffer;
+        size_t copied = 0; // message[0, copied) is already in buffer
+        const auto replace = [&](const size_t pos, const size_t length, const std::wstring& to) {
+            if (buffer.empty()) {
+                buffer.reserve(message.size() + to.size());
             }
-            size_t start_pos = 0;
-            while ((start_pos = replacemsg.find(from, start_pos)) != std::string::npos) {
-                replacemsg.replace(start_pos, from.length(), to);
-                start_pos += to.length(); // In case 'to' contains 'from', like replacing 'x' with 'yx'
-                was_changed = true;
+            buffer.append(message.substr(copied, pos - copied));
+            buffer.append(to);
+            copied = pos + length;
+        };
+
+        while (segment != std::wstring_view::npos) {
+            const auto text_start = segment + 1;
+            const auto text_end = std::min(message.find(static_cast<wchar_t>(0x1), text_start), message.size());
+            const auto text = message.substr(text_start, text_end - text_start);
+            if (const auto to = names.Find(text)) {
+                replace(text_start, text.size(), *to); // The whole segment is a name; the usual case
             }
+            else {
+                for (size_t i = 0; i < text.size();) {
+                    const auto match = names.MatchPrefix(text.substr(i));
+                    if (!match) {
+                        i++;
+                        continue;
+                    }
+                    replace(text_start + i, match->first.size(), match->second);
+                    i += match->first.size();
+                }
+            }
+            segment = message.find(static_cast<wchar_t>(0x107), text_end);
+        }
+        if (!copied) {
+            return false;
         }
-        out.assign(replacemsg);
-        return !out.empty() && was_changed;
+        buffer.append(message.substr(copied));
+        out = std::move(buffer);
+        return !out.empty();
     }
 
     bool UnobfuscateMessage(const wchar_t* message, std::wstring& out)
@@ -543,8 +628,8 @@ namespace {
         }
         std::ranges::shuffle(obfuscated_name_pool, dre);
         pool_index = 0;
-        obfuscated_by_obfuscation.clear();
-        obfuscated_by_original.clear();
+        obfuscated_by_obfuscation.Clear();
+        obfuscated_by_original.Clear();
         // Don't use clear() on this; the game uses the pointer so we don't want to mess with it
         account_info_obfuscated_name[0] = '\0';
         // Don't use clear() on this; the game uses the pointer so we don't want to mess with it
@@ -884,7 +969,7 @@ void Obfuscator::Initialize()
         GAME_SMSG_CINEMATIC_TEXT,
     };
     for (const auto header : pre_hook_headers) {
-        GW::StoC::RegisterPacketCallback(&stoc_hook, header, OnStoCPacket, pre_hook_altitude);
+        FrameProfiler::RegisterPacketCallback(&stoc_hook, header, OnStoCPacket, pre_hook_altitude);
     }
     constexpr std::array pre_hook_ui_messages = {
         GW::UI::UIMessage::kShowMapEntryMessage,
@@ -1020,5 +1105,5 @@ void Obfuscator::DrawSettingsInternal()
 
 bool Obfuscator::IsObfuscatedName(const std::wstring& name)
 {
-    return obfuscated_by_original.contains(name) || obfuscated_by_obfuscation.contains(name);
+    return obfuscated_by_original.Contains(name) || obfuscated_by_obfuscation.Contains(name);
 }
@@ -22,6 +22,7 @@
 #include <Modules/ObserverModule.h>
 
 #include <Logger.h>
+#include <Utils/PacketReplay.h>
 #include <Utils/TextUtils.h>
 #include <Utils/ToolboxUtils.h>
 namespace {
@@ -32,6 +33,40 @@ namespace {
     {
         ObserverModule::Instance().Reset();
     }
+
+    uint64_t AgentSkillKey(const uint32_t agent_id, const GW::Constants::SkillID skill_id)
+    {
+        return static_cast<uint64_t>(agent_id) << 32 | static_cast<uint32_t>(skill_id);
+    }
+
+    // Keeps skill_ids sorted
+    void InsertSkillId(std::vector<GW::Constants::SkillID>& skill_ids, const GW::Constants::SkillID skill_id)
+    {
+        skill_ids.insert(std::ranges::upper_bound(skill_ids, skill_id), skill_id);
+    }
+
+    // Counts a handled packet and the time spent handling it
+    class PacketTimer {
+    public:
+        PacketTimer(size_t& count, std::chrono::steady_clock::duration& total)
+            : count(count)
+            , total(total)
+            , started(std::chrono::steady_clock::now()) { }
+
+        ~PacketTimer()
+        {
+            count++;
+            total += std::chrono::steady_clock::now() - started;
+        }
+
+        PacketTimer(const PacketTimer&) = delete;
+        PacketTimer& operator=(const PacketTimer&) = delete;
+
+    private:
+        size_t& count;
+        std::chrono::steady_clock::duration& total;
+        const std::chrono::steady_clock::time_point started;
+    };
 }
 
 constexpr auto INI_FILENAME = L"observerlog.ini";
@@ -111,12 +146,12 @@ void ObserverModule::Initialize()
     is_explorable = GW::Map::GetInstanceType() == GW::Constants::InstanceType::Explorable;
     is_observer = GW::Map::GetIsObserving();
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::InstanceLoadInfo>(
+    PacketReplay::RegisterPacketCallback<GW::Packet::StoC::InstanceLoadInfo>(
         &InstanceLoadInfo_Entry, [this](const GW::HookStatus* status, const GW::Packet::StoC::InstanceLoadInfo* packet) -> void {
             HandleInstanceLoadInfo(status, packet);
         });
 
-    GW::StoC::RegisterPacketCallback<JumboMessage>(
+    PacketReplay::RegisterPacketCallback<JumboMessage>(
         &JumboMessage_Entry, [this](const GW::HookStatus*, const JumboMessage* packet) -> void {
             if (!IsActive()) {
                 return;
@@ -124,10 +159,11 @@ void ObserverModule::Initialize()
             if (!InitializeObserverSession()) {
                 return;
             }
+            PacketTimer timer(handled_packet_count, handled_packet_time);
             HandleJumboMessage(packet->type, packet->value);
         });
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::AgentState>(
+    PacketReplay::RegisterPacketCallback<GW::Packet::StoC::AgentState>(
         &AgentState_Entry, [this](const GW::HookStatus*, const GW::Packet::StoC::AgentState* packet) -> void {
             if (!IsActive()) {
                 return;
@@ -135,10 +171,11 @@ void ObserverModule::Initialize()
             if (!InitializeObserverSession()) {
                 return;
             }
+            PacketTimer timer(handled_packet_count, handled_packet_time);
             HandleAgentState(packet->agent_id, packet->state);
         });
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::AgentAdd>(
+    PacketReplay::RegisterPacketCallback<GW::Packet::StoC::AgentAdd>(
         &AgentAdd_Entry,
         [this](const GW::HookStatus*, const GW::Packet::StoC::AgentAdd* packet) -> void {
             if (!IsActive()) {
@@ -147,10 +184,11 @@ void ObserverModule::Initialize()
             if (!InitializeObserverSession()) {
                 return;
             }
+            PacketTimer timer(handled_packet_count, handled_packet_time);
             HandleAgentAdd(packet->agent_id);
         });
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::AgentProjectileLaunched>(
+    PacketReplay::RegisterPacketCallback<GW::Packet::StoC::AgentProjectileLaunched>(
         &AgentProjectileLaunched_Entry,
         [this](const GW::HookStatus*, const GW::Packet::StoC::AgentProjectileLaunched* packet) -> void {
             if (!IsActive()) {
@@ -159,10 +197,11 @@ void ObserverModule::Initialize()
             if (!InitializeObserverSession()) {
                 return;
             }
+            PacketTimer timer(handled_packet_count, handled_packet_time);
             HandleAgentProjectileLaunched(packet);
         });
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericModifier>(
+    PacketReplay::RegisterPacketCallback<GW::Packet::StoC::GenericModifier>(
         &GenericModifier_Entry,
         [this](const GW::HookStatus*, const GW::Packet::StoC::GenericModifier* packet) -> void {
             if (!IsActive()) {
@@ -171,6 +210,7 @@ void ObserverModule::Initialize()
             if (!InitializeObserverSession()) {
                 return;
             }
+            PacketTimer timer(handled_packet_count, handled_packet_time);
 
             const uint32_t value_id = packet->type;
             const uint32_t caster_id = packet->cause_id;
@@ -181,7 +221,7 @@ void ObserverModule::Initialize()
         }
     );
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericValueTarget>(
+    PacketReplay::RegisterPacketCallback<GW::Packet::StoC::GenericValueTarget>(
         &GenericValueTarget_Entry,
         [this](const GW::HookStatus*, const GW::Packet::StoC::GenericValueTarget* packet) -> void {
             if (!IsActive()) {
@@ -190,6 +230,7 @@ void ObserverModule::Initialize()
             if (!InitializeObserverSession()) {
                 return;
             }
+            PacketTimer timer(handled_packet_count, handled_packet_time);
 
             const uint32_t value_id = packet->Value_id;
             const uint32_t caster_id = packet->caster;
@@ -199,7 +240,7 @@ void ObserverModule::Initialize()
             HandleGenericPacket(value_id, caster_id, target_id, value, no_target);
         });
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericValue>(
+    PacketReplay::RegisterPacketCallback<GW::Packet::StoC::GenericValue>(
         &GenericValue_Entry,
         [this](const GW::HookStatus*, const GW::Packet::StoC::GenericValue* packet) -> void {
             if (!IsActive()) {
@@ -208,6 +249,7 @@ void ObserverModule::Initialize()
             if (!InitializeObserverSession()) {
                 return;
             }
+            PacketTimer timer(handled_packet_count, handled_packet_time);
 
             const uint32_t value_id = packet->value_id;
             const uint32_t caster_id = packet->agent_id;
@@ -217,7 +259,7 @@ void ObserverModule::Initialize()
             HandleGenericPacket(value_id, caster_id, target_id, value, no_target);
         });
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericFloat>(
+    PacketReplay::RegisterPacketCallback<GW::Packet::StoC::GenericFloat>(
         &GenericFloat_Entry, [this](const GW::HookStatus*, const GW::Packet::StoC::GenericFloat* packet) -> void {
             if (!IsActive()) {
                 return;
@@ -225,6 +267,7 @@ void ObserverModule::Initialize()
             if (!InitializeObserverSession()) {
                 return;
             }
+            PacketTimer timer(handled_packet_count, handled_packet_time);
 
             const uint32_t value_id = packet->type;
             const uint32_t caster_id = packet->agent_id;
@@ -248,7 +291,10 @@ void ObserverModule::Terminate()
     GW::Chat::DeleteCommand(&ChatCmd_HookEntry);
     Reset();
 
-    // TODO: Clear stoc callbacks
+    for (const auto entry : {&InstanceLoadInfo_Entry, &JumboMessage_Entry, &AgentState_Entry, &AgentAdd_Entry, &AgentProjectileLaunched_Entry,
+                             &GenericModifier_Entry, &GenericValueTarget_Entry, &GenericValue_Entry, &GenericFloat_Entry}) {
+        PacketReplay::RemoveCallbacks(entry);
+    }
 }
 
 
@@ -1143,6 +1189,11 @@ void ObserverModule::Reset()
         }
     }
     observable_parties.clear();
+
+    // agents are gone, so nothing refers to their stats anymore
+    stat_arena.Clear();
+    handled_packet_count = 0;
+    handled_packet_time = {};
 }
 
 
@@ -1256,6 +1307,17 @@ void ObserverModule::DrawSettingsInternal()
     ImGui::Checkbox("Enabled", &is_enabled);
     ImGui::Checkbox("Trim henchman names", &trim_hench_names);
     ImGui::Checkbox("Enable in all Explorable Areas (experimental and unsupported)", &enable_in_explorable_areas);
+
+    size_t table_bytes = 0;
+    for (const auto agent : observable_agents | std::views::values) {
+        table_bytes += agent ? agent->stats.MemoryUsage() : 0;
+    }
+    const auto handled_ms = std::chrono::duration<double, std::milli>(handled_packet_time).count();
+    ImGui::TextDisabled("Stats memory: %zu records, %.1f KB used of %.1f KB reserved, %.1f KB in lookup tables",
+                        stat_arena.ObjectCount(), static_cast<double>(stat_arena.BytesUsed()) / 1024.0,
+                        static_cast<double>(stat_arena.BytesReserved()) / 1024.0, static_cast<double>(table_bytes) / 1024.0);
+    ImGui::TextDisabled("Packets handled: %zu in %.2f ms (%.2f us per packet)", handled_packet_count, handled_ms,
+                        handled_packet_count ? handled_ms * 1000.0 / static_cast<double>(handled_packet_count) : 0.0);
 }
 
 
@@ -1567,87 +1629,16 @@ void ObserverModule::SharedStats::HandleKill()
 }
 
 
-ObserverModule::ObservableAgentStats::~ObservableAgentStats()
-{
-    // attacks received (by agent)
-    for (const auto& [_, o_atk] : attacks_received_from_agents) {
-        if (o_atk) {
-            delete o_atk;
-        }
-    }
-    attacks_received_from_agents.clear();
-
-    // attacks dealed (by agent)
-    for (const auto& [_, o_atk] : attacks_dealt_to_agents) {
-        if (o_atk) {
-            delete o_atk;
-        }
-    }
-    attacks_dealt_to_agents.clear();
-
-    // skills used
-    skill_ids_used.clear();
-    for (const auto& [_, o_skill] : skills_used) {
-        if (o_skill) {
-            delete o_skill;
-        }
-    }
-    skills_used.clear();
-
-    // skills received
-    skill_ids_received.clear();
-    for (const auto& [_, o_skill] : skills_received) {
-        if (o_skill) {
-            delete o_skill;
-        }
-    }
-    skills_received.clear();
-
-    // skill received (by agent)
-    for (auto& [_, skill_ids] : skill_ids_received_from_agents) {
-        skill_ids.clear();
-    }
-    skill_ids_received_from_agents.clear();
-    for (auto& [_, agent_skills] : skills_received_from_agents) {
-        for (const auto [__, o_skill] : agent_skills) {
-            if (o_skill) {
-                delete o_skill;
-            }
-        }
-        agent_skills.clear();
-    }
-    skills_received_from_agents.clear();
-
-    // skill used (by agent)
-    for (auto& [_, skill_ids] : skill_ids_used_on_agents) {
-        skill_ids.clear();
-    }
-    skill_ids_used_on_agents.clear();
-    for (auto& [_, agent_skills] : skills_used_on_agents) {
-        for (const auto [__, o_skill] : agent_skills) {
-            if (o_skill) {
-                delete o_skill;
-            }
-        }
-        agent_skills.clear();
-    }
-    skills_used_on_agents.clear();
-}
-
-
 // Get attacks dealed against this agent, by a caster_agent_id
 // Lazy initialises the caster_agent_id
 ObserverModule::ObservedAction& ObserverModule::ObservableAgentStats::LazyGetAttacksDealedAgainst(const uint32_t target_agent_id)
 {
-    const auto it = attacks_dealt_to_agents.find(target_agent_id);
-    if (it == attacks_dealt_to_agents.end()) {
+    auto& observed_action = attacks_dealt_to_agents.FindOrAdd(target_agent_id);
+    if (!observed_action) {
         // receiver not registered
-        auto observed_action = new ObservedAction();
-        attacks_dealt_to_agents.insert({target_agent_id, observed_action});
-        return *observed_action;
+        observed_action = arena.New<ObservedAction>();
     }
-    // receiver is already reigstered
-    return *it->second;
+    return *observed_action;
 }
 
 
@@ -1655,15 +1646,12 @@ ObserverModule::ObservedAction& ObserverModule::ObservableAgentStats::LazyGetAtt
 // Lazy initialises the caster_agent_id
 ObserverModule::ObservedAction& ObserverModule::ObservableAgentStats::LazyGetAttacksReceivedFrom(const uint32_t caster_agent_id)
 {
-    const auto it = attacks_received_from_agents.find(caster_agent_id);
-    if (it == attacks_received_from_agents.end()) {
+    auto& observed_action = attacks_received_from_agents.FindOrAdd(caster_agent_id);
+    if (!observed_action) {
         // attacker not registered
-        auto observed_action = new ObservedAction();
-        attacks_received_from_agents.insert({caster_agent_id, observed_action});
-        return *observed_action;
+        observed_action = arena.New<ObservedAction>();
     }
-    // attacker is already reigstered
-    return *it->second;
+    return *observed_action;
 }
 
 
@@ -1671,18 +1659,13 @@ ObserverModule::ObservedAction& ObserverModule::ObservableAgentStats::LazyGetAtt
 // Lazy initialises the skill_id
 ObserverModule::ObservedAction& ObserverModule::ObservableAgentStats::LazyGetSkillUsed(const GW::Constants::SkillID skill_id)
 {
-    const auto it_skill = skills_used.find(skill_id);
-    if (it_skill == skills_used.end()) {
+    auto& observed_skill = skills_used.FindOrAdd(static_cast<uint32_t>(skill_id));
+    if (!observed_skill) {
         // skill not registered
-        skill_ids_used.push_back(skill_id);
-        // re-sort skills
-        std::ranges::sort(skill_ids_used);
-        auto observed_skill = new ObservedSkill(skill_id);
-        skills_used.insert({skill_id, observed_skill});
-        return *observed_skill;
+        InsertSkillId(skill_ids_used, skill_id);
+        observed_skill = arena.New<ObservedSkill>(skill_id);
     }
-    // skill already registered
-    return *it_skill->second;
+    return *observed_skill;
 }
 
 
@@ -1690,18 +1673,13 @@ ObserverModule::ObservedAction& ObserverModule::ObservableAgentStats::LazyGetSki
 // Lazy initialises the skill_id
 ObserverModule::ObservedAction& ObserverModule::ObservableAgentStats::LazyGetSkillReceived(const GW::Constants::SkillID skill_id)
 {
-    const auto it_skill = skills_received.find(skill_id);
-    if (it_skill == skills_received.end()) {
+    auto& observed_skill = skills_received.FindOrAdd(static_cast<uint32_t>(skill_id));
+    if (!observed_skill) {
         // skill not registered
-        skill_ids_received.push_back(skill_id);
-        // re-sort skills
-        std::ranges::sort(skill_ids_received);
-        auto observed_skill = new ObservedSkill(skill_id);
-        skills_received.insert({skill_id, observed_skill});
-        return *observed_skill;
+        InsertSkillId(skill_ids_received, skill_id);
+        observed_skill = arena.New<ObservedSkill>(skill_id);
     }
-    // skill already registered
-    return *it_skill->second;
+    return *observed_skill;
 }
 
 
@@ -1709,69 +1687,55 @@ ObserverModule::ObservedAction& ObserverModule::ObservableAgentStats::LazyGetSki
 // Lazy initialises the skill_id and caster_agent_id
 ObserverModule::ObservedSkill& ObserverModule::ObservableAgentStats::LazyGetSkillReceivedFrom(const uint32_t caster_agent_id, const GW::Constants::SkillID skill_id)
 {
-    const auto it_caster = skills_received_from_agents.find(caster_agent_id);
-    if (it_caster == skills_received_from_agents.end()) {
-        // receiver and his skills are not registered with this agent
-        std::vector received_skill_ids = {skill_id};
-        skill_ids_received_from_agents.insert({caster_agent_id, received_skill_ids});
-        auto observed_skill = new ObservedSkill(skill_id);
-        std::unordered_map<GW::Constants::SkillID, ObservedSkill*> received_skills = {{skill_id, observed_skill}};
-        skills_received_from_agents.insert({caster_agent_id, received_skills});
-        return *observed_skill;
-    }
-    // receiver is registered with this agent
-    std::unordered_map<GW::Constants::SkillID, ObservedSkill*>& used_by_caster = it_caster->second;
-    const auto it_observed_skill = used_by_caster.find(skill_id);
-    // does receiver have the skill registered from/against us?
-    if (it_observed_skill == used_by_caster.end()) {
+    auto& observed_skill = skills_received_from_agents.FindOrAdd(AgentSkillKey(caster_agent_id, skill_id));
+    if (!observed_skill) {
         // caster hasn't registered this skill with this agent
-        // add & re-sort skill_ids by the caster
-        std::vector<GW::Constants::SkillID>& skills_ids_received_by_agent_vec = skill_ids_received_from_agents.find(caster_agent_id)->second;
-        skills_ids_received_by_agent_vec.push_back(skill_id);
-        // re-sort
-        std::ranges::sort(skills_ids_received_by_agent_vec);
-        // add the observed skill for the caster
-        auto observed_skill = new ObservedSkill(skill_id);
-        used_by_caster.insert({skill_id, observed_skill});
-        return *observed_skill;
+        InsertSkillId(skill_ids_received_from_agents[caster_agent_id], skill_id);
+        observed_skill = arena.New<ObservedSkill>(skill_id);
     }
-    // receivers already registered this skill
-    return *it_observed_skill->second;
+    return *observed_skill;
 }
 
 
-// Get a skill received by this agent, from another agent
-// Lazy initialises the skill_id and caster_agent_id
+ObserverModule::ObservedSkill* ObserverModule::ObservableAgentStats::GetSkillReceivedFrom(const uint32_t caster_agent_id, const GW::Constants::SkillID skill_id) const
+{
+    return skills_received_from_agents.Find(AgentSkillKey(caster_agent_id, skill_id));
+}
+
+
+// Get a skill used by this agent, on another agent
+// Lazy initialises the skill_id and target_agent_id
 ObserverModule::ObservedSkill& ObserverModule::ObservableAgentStats::LazyGetSkillUsedOn(const uint32_t target_agent_id, const GW::Constants::SkillID skill_id)
 {
-    const auto it_target = skills_used_on_agents.find(target_agent_id);
-    if (it_target == skills_used_on_agents.end()) {
-        // receiver and his skills are not registered with this agent
-        std::vector used_skill_ids = {skill_id};
-        skill_ids_used_on_agents.insert({target_agent_id, used_skill_ids});
-        auto observed_skill = new ObservedSkill(skill_id);
-        std::unordered_map<GW::Constants::SkillID, ObservedSkill*> used_skills = {{skill_id, observed_skill}};
-        skills_used_on_agents.insert({target_agent_id, used_skills});
-        return *observed_skill;
-    }
-    std::unordered_map<GW::Constants::SkillID, ObservedSkill*>& used_on_target = it_target->second;
-    // receiver is registered with this agent
-    const auto it_observed_skill = used_on_target.find(skill_id);
-    // does receiver have the skill registered from/against us?
-    if (it_observed_skill == used_on_target.end()) {
+    auto& observed_skill = skills_used_on_agents.FindOrAdd(AgentSkillKey(target_agent_id, skill_id));
+    if (!observed_skill) {
         // target hasn't registered this skill with this agent
-        // add & re-sort skill_ids by the caster
-        std::vector<GW::Constants::SkillID>& skills_ids_used_on_agent_vec = skill_ids_used_on_agents.find(target_agent_id)->second;
-        skills_ids_used_on_agent_vec.push_back(skill_id);
-        // re-sort
-        std::ranges::sort(skills_ids_used_on_agent_vec);
-        // add the observed skill for the caster
-        auto observed_skill = new ObservedSkill(skill_id);
-        used_on_target.insert({skill_id, observed_skill});
-        return *observed_skill;
+        InsertSkillId(skill_ids_used_on_agents[target_agent_id], skill_id);
+        observed_skill = arena.New<ObservedSkill>(skill_id);
+    }
+    return *observed_skill;
+}
+
+
+ObserverModule::ObservedSkill* ObserverModule::ObservableAgentStats::GetSkillUsedOn(const uint32_t target_agent_id, const GW::Constants::SkillID skill_id) const
+{
+    return skills_used_on_agents.Find(AgentSkillKey(target_agent_id, skill_id));
+}
+
+
+size_t ObserverModule::ObservableAgentStats::MemoryUsage() const
+{
+    size_t bytes = attacks_dealt_to_agents.MemoryUsage() + attacks_received_from_agents.MemoryUsage()
+                   + skills_used.MemoryUsage() + skills_received.MemoryUsage()
+                   + skills_received_from_agents.MemoryUsage() + skills_used_on_agents.MemoryUsage()
+                   + (skill_ids_used.capacity() + skill_ids_received.capacity()) * sizeof(GW::Constants::SkillID);
+    for (const auto& skill_ids : skill_ids_received_from_agents | std::views::values) {
+        bytes += skill_ids.capacity() * sizeof(GW::Constants::SkillID);
+    }
+    for (const auto& skill_ids : skill_ids_used_on_agents | std::views::values) {
+        bytes += skill_ids.capacity() * sizeof(GW::Constants::SkillID);
     }
-    // receivers already registered this skill
-    return *it_observed_skill->second;
+    return bytes;
 }
 
 
@@ -2022,6 +1986,7 @@ ObserverModule::ObservableAgent::ObservableAgent(ObserverModule& parent, const G
     , secondary(static_cast<GW::Constants::Profession>(agent_living.secondary))
     , is_player(agent_living.IsPlayer())
     , is_npc(agent_living.IsNPC())
+    , stats(parent.stat_arena)
 {
     // async initialise the agents name now because we probably want it later
     GW::UI::AsyncDecodeStr(GW::Agents::GetAgentEncName(&agent_living), &_raw_name_w);
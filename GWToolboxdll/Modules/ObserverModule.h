@@ -187,42 +187,180 @@ public:
         void HandleKill();
     };
 
+    // Per match storage for observed stats.
+    // Stats are carved out of large blocks instead of being allocated one by one, and all released at once when the module resets;
+    // the blocks are kept for the next match so memory stays flat over long sessions.
+    class StatArena {
+    public:
+        template <typename T, typename... Args>
+        T* New(Args&&... args)
+        {
+            static_assert(std::is_trivially_destructible_v<T>, "StatArena never runs destructors");
+            static_assert(sizeof(T) <= block_size);
+            const size_t offset = (block_used + alignof(T) - 1) & ~(alignof(T) - 1);
+            if (current_block >= blocks.size() || offset + sizeof(T) > block_size) {
+                if (current_block < blocks.size()) {
+                    current_block++;
+                }
+                if (current_block == blocks.size()) {
+                    blocks.push_back(std::make_unique<std::byte[]>(block_size));
+                }
+                block_used = 0;
+                return New<T>(std::forward<Args>(args)...);
+            }
+            block_used = offset + sizeof(T);
+            bytes_used += sizeof(T);
+            object_count++;
+            return new(blocks[current_block].get() + offset) T(std::forward<Args>(args)...);
+        }
+
+        // Forgets everything allocated so far; keeps the blocks
+        void Clear()
+        {
+            current_block = 0;
+            block_used = 0;
+            bytes_used = 0;
+            object_count = 0;
+        }
+
+        [[nodiscard]] size_t BytesReserved() const { return blocks.size() * block_size; }
+        [[nodiscard]] size_t BytesUsed() const { return bytes_used; }
+        [[nodiscard]] size_t ObjectCount() const { return object_count; }
+
+    private:
+        static constexpr size_t block_size = 64 * 1024;
+        std::vector<std::unique_ptr<std::byte[]>> blocks;
+        size_t current_block = 0;
+        size_t block_used = 0;
+        size_t bytes_used = 0;
+        size_t object_count = 0;
+    };
+
+    // Open addressing (linear probing) table from a packed id to arena allocated stats
+    template <typename T>
+    class StatTable {
+    public:
+        [[nodiscard]] T* Find(const uint64_t key) const
+        {
+            if (keys.empty()) {
+                return nullptr;
+            }
+            for (size_t i = Hash(key);; i = (i + 1) & (keys.size() - 1)) {
+                if (keys[i] == key) {
+                    return values[i];
+                }
+                if (keys[i] == empty_key) {
+                    return nullptr;
+                }
+            }
+        }
+
+        // Slot for key, added as nullptr if it wasn't in the table yet
+        T*& FindOrAdd(const uint64_t key)
+        {
+            if ((count + 1) * 4 > keys.size() * 3) {
+                Grow();
+            }
+            for (size_t i = Hash(key);; i = (i + 1) & (keys.size() - 1)) {
+                if (keys[i] == key) {
+                    return values[i];
+                }
+                if (keys[i] == empty_key) {
+                    keys[i] = key;
+                    values[i] = nullptr;
+                    count++;
+                    return values[i];
+                }
+            }
+        }
+
+        // fn(key, T*) for every entry, in no particular order
+        template <typename Fn>
+        void ForEach(Fn&& fn) const
+        {
+            for (size_t i = 0; i < keys.size(); i++) {
+                if (keys[i] != empty_key) {
+                    fn(keys[i], values[i]);
+                }
+            }
+        }
+
+        [[nodiscard]] size_t Size() const { return count; }
+        [[nodiscard]] size_t MemoryUsage() const { return keys.capacity() * sizeof(uint64_t) + values.capacity() * sizeof(T*); }
+
+    private:
+        static constexpr uint64_t empty_key = ~0ull;
+
+        [[nodiscard]] size_t Hash(const uint64_t key) const
+        {
+            // Fibonacci hashing; ids are mostly small and sequential
+            return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & (keys.size() - 1);
+        }
+
+        void Grow()
+        {
+            auto old_keys = std::move(keys);
+            auto old_values = std::move(values);
+            keys.assign(old_keys.empty() ? 16 : old_keys.size() * 2, empty_key);
+            values.assign(keys.size(), nullptr);
+            count = 0;
+            for (size_t i = 0; i < old_keys.size(); i++) {
+                if (old_keys[i] != empty_key) {
+                    FindOrAdd(old_keys[i]) = old_values[i];
+                }
+            }
+        }
+
+        std::vector<uint64_t> keys;
+        std::vector<T*> values;
+        size_t count = 0;
+    };
+
     // Stats for Agents
     class ObservableAgentStats : public SharedStats {
     public:
-        ~ObservableAgentStats();
+        ObservableAgentStats(StatArena& arena)
+            : arena(arena) { }
 
-        // map of agent_id -> ObservedAction
-        std::unordered_map<uint32_t, ObservedAction*> attacks_dealt_to_agents = {};
+        // agent_id -> ObservedAction
+        StatTable<ObservedAction> attacks_dealt_to_agents;
         ObservedAction& LazyGetAttacksDealedAgainst(uint32_t target_agent_id);
 
-        // map of agent_id -> ObservedAction
-        std::unordered_map<uint32_t, ObservedAction*> attacks_received_from_agents = {};
+        // agent_id -> ObservedAction
+        StatTable<ObservedAction> attacks_received_from_agents;
         ObservedAction& LazyGetAttacksReceivedFrom(uint32_t attacker_agent_id);
 
         // skills
 
-        // map of skill_id -> count of times received
-        std::unordered_map<GW::Constants::SkillID, ObservedSkill*> skills_used = {};
+        // skill_id -> count of times used; skill_ids_used is sorted
+        StatTable<ObservedSkill> skills_used;
         std::vector<GW::Constants::SkillID> skill_ids_used = {};
         ObservedAction& LazyGetSkillUsed(GW::Constants::SkillID skill_id);
 
-        // map of skill_id -> count of times used
-        std::unordered_map<GW::Constants::SkillID, ObservedSkill*> skills_received = {};
+        // skill_id -> count of times received; skill_ids_received is sorted
+        StatTable<ObservedSkill> skills_received;
         std::vector<GW::Constants::SkillID> skill_ids_received = {};
         ObservedAction& LazyGetSkillReceived(GW::Constants::SkillID skill_id);
 
         // skills by agent
 
-        // map of agent_id -> skill_id -> count of times received
-        std::unordered_map<uint32_t, std::unordered_map<GW::Constants::SkillID, ObservedSkill*>> skills_received_from_agents = {};
+        // (agent_id, skill_id) -> count of times received; the skill ids of each agent are sorted
+        StatTable<ObservedSkill> skills_received_from_agents;
         std::unordered_map<uint32_t, std::vector<GW::Constants::SkillID>> skill_ids_received_from_agents = {};
         ObservedSkill& LazyGetSkillReceivedFrom(uint32_t caster_agent_id, GW::Constants::SkillID skill_id);
+        [[nodiscard]] ObservedSkill* GetSkillReceivedFrom(uint32_t caster_agent_id, GW::Constants::SkillID skill_id) const;
 
-        // map of agent_id -> skill_id -> count of times used
-        std::unordered_map<uint32_t, std::unordered_map<GW::Constants::SkillID, ObservedSkill*>> skills_used_on_agents = {};
+        // (agent_id, skill_id) -> count of times used; the skill ids of each agent are sorted
+        StatTable<ObservedSkill> skills_used_on_agents;
         std::unordered_map<uint32_t, std::vector<GW::Constants::SkillID>> skill_ids_used_on_agents = {};
         ObservedSkill& LazyGetSkillUsedOn(uint32_t target_agent_id, GW::Constants::SkillID skill_id);
+        [[nodiscard]] ObservedSkill* GetSkillUsedOn(uint32_t target_agent_id, GW::Constants::SkillID skill_id) const;
+
+        // Bytes used by the lookup tables; the stats themselves live in the arena
+        [[nodiscard]] size_t MemoryUsage() const;
+
+    private:
+        StatArena& arena;
     };
 
     // Stats for Parties
@@ -286,7 +424,7 @@ public:
         bool is_npc;
 
         // stats:
-        ObservableAgentStats stats;;
+        ObservableAgentStats stats;
 
         // name fns with excessive caching & lazy loading
         std::string DisplayName();
@@ -539,6 +677,13 @@ private:
 
     ObservableMap* map{};
 
+    // storage for the stats of every observed agent this match
+    StatArena stat_arena;
+
+    // packets handled this session and time spent handling them, for the report in settings
+    size_t handled_packet_count = 0;
+    std::chrono::steady_clock::duration handled_packet_time{};
+
     // lazy loaded observed guilds
     std::unordered_map<uint32_t, ObservableGuild*> observable_guilds = {};
     std::vector<uint32_t> observable_guild_ids = {};
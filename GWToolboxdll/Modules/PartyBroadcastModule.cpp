@@ -22,6 +22,7 @@
 #include <Modules/Updater.h>
 
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 #include <Utils/TextUtils.h>
 
 #include <easywsclient/easywsclient.hpp>
@@ -456,7 +457,7 @@ void PartyBroadcast::Initialize()
     for (auto message_id : ui_messages) {
         GW::UI::RegisterUIMessageCallback(&OnUIMessage_Hook, message_id, OnUIMessage, 0x8000);
     }
-    GW::StoC::RegisterPacketCallback(&OnUIMessage_Hook, GAME_SMSG_AGENT_DESPAWNED, OnStoCPacket, 0x8000);
+    FrameProfiler::RegisterPacketCallback(&OnUIMessage_Hook, GAME_SMSG_AGENT_DESPAWNED, OnStoCPacket, 0x8000);
 }
 
 void PartyBroadcast::Terminate() {
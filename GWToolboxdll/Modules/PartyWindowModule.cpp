@@ -27,6 +27,7 @@
 #include <Defines.h>
 #include <Modules/PartyWindowModule.h>
 #include <Windows/FriendListWindow.h>
+#include <Utils/FrameProfiler.h>
 #include "Resources.h"
 
 namespace {
@@ -434,7 +435,7 @@ void PartyWindowModule::Initialize()
 {
     ToolboxModule::Initialize();
     // Remove certain NPCs from party window when dead
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::AgentState>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::AgentState>(
         &AgentState_Entry,
         [&](const GW::HookStatus*, const GW::Packet::StoC::AgentState* pak) -> void {
             if (!add_npcs_to_party_window || pak->state != 16) {
@@ -446,7 +447,7 @@ void PartyWindowModule::Initialize()
             pending_remove.push(pak->agent_id);
         });
     // Remove certain NPCs from party window when despawned
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::AgentRemove>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::AgentRemove>(
         &AgentRemove_Entry,
         [&](const GW::HookStatus*, const GW::Packet::StoC::AgentRemove* pak) -> void {
             if (remove_dead_imperials) {
@@ -470,7 +471,7 @@ void PartyWindowModule::Initialize()
             pending_remove.push(pak->agent_id);
         });
     // Add certain NPCs to party window when spawned
-    GW::StoC::RegisterPostPacketCallback<GW::Packet::StoC::AgentAdd>(
+    FrameProfiler::RegisterPostPacketCallback<GW::Packet::StoC::AgentAdd>(
         &AgentAdd_Entry,
         [&](const GW::HookStatus*, GW::Packet::StoC::AgentAdd* pak) -> void {
             if (!add_npcs_to_party_window) {
@@ -485,7 +486,7 @@ void PartyWindowModule::Initialize()
             pending_add.emplace_back(pak->agent_id, pak->allegiance_bits, pak->agent_type ^ 0x20000000);
         });
     // Flash/focus window on zoning (and a bit of housekeeping)
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::InstanceLoadInfo>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::InstanceLoadInfo>(
         &GameSrvTransfer_Entry,
         [&](const GW::HookStatus*, const GW::Packet::StoC::InstanceLoadInfo* pak) -> void {
             allies_added_to_party.clear();
@@ -496,7 +497,7 @@ void PartyWindowModule::Initialize()
             aliased_player_names.clear();
         });
     // Player numbers in party window
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::PlayerJoinInstance>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::PlayerJoinInstance>(
         &GameSrvTransfer_Entry,
         [&](const GW::HookStatus*, GW::Packet::StoC::PlayerJoinInstance* pak) -> void {
             if (!add_player_numbers_to_party_window || !is_explorable || IsPvP()) {
@@ -519,7 +520,7 @@ void PartyWindowModule::Initialize()
         }
     });
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::AgentAdd>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::AgentAdd>(
         &Summon_AgentAdd_Entry,
         [&](GW::HookStatus*, const GW::Packet::StoC::AgentAdd* pak) -> void {
             if (!add_elite_skill_to_summons) {
@@ -608,7 +608,7 @@ const std::unordered_map<std::string,uint32_t>& PriceCheckerModule::FetchPrices(
         Resources::Download(trader_quotes_url, [](bool success, const std::string& response, void*) {
             if (success)
                 ParsePriceJson(response);
-            });
+            }, nullptr, Resources::TaskPriority::High);
     }
     return prices_by_identifier;
 }
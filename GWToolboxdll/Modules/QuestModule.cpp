@@ -573,6 +573,8 @@ void QuestModule::DrawSettingsInternal()
 #endif
     ImGui::DragFloat("Max distance between two points##max_visibility_range", &Pathing::max_visibility_range, 1'000.f, 1'000.f, 50'000.f);
     ImGui::ShowHelp("The higher this value, the more accurate the path will be, but the more CPU it will use.");
+    ImGui::Checkbox("Use landmark heuristic##use_landmark_heuristic", &Pathing::use_landmark_heuristic);
+    ImGui::ShowHelp("Precomputes distances to a few landmarks after a map is processed, which makes path searches faster at the cost of some memory.");
 }
 
 void QuestModule::LoadSettings(ToolboxIni* ini)
@@ -584,6 +586,7 @@ void QuestModule::LoadSettings(ToolboxIni* ini)
     LOAD_BOOL(show_paths_to_all_quests);
     using namespace Pathing;
     LOAD_FLOAT(max_visibility_range);
+    LOAD_BOOL(use_landmark_heuristic);
     float custom_quest_marker_world_pos_x = .0f;
     float custom_quest_marker_world_pos_y = .0f;
     LOAD_FLOAT(custom_quest_marker_world_pos_x);
@@ -604,6 +607,7 @@ void QuestModule::SaveSettings(ToolboxIni* ini)
     SAVE_BOOL(show_paths_to_all_quests);
     using namespace Pathing;
     SAVE_FLOAT(max_visibility_range);
+    SAVE_BOOL(use_landmark_heuristic);
     float custom_quest_marker_world_pos_x = custom_quest_marker_world_pos.x;
     float custom_quest_marker_world_pos_y = custom_quest_marker_world_pos.y;
     SAVE_FLOAT(custom_quest_marker_world_pos_x);
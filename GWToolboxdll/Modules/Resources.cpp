@@ -1,5 +1,7 @@
 #include "stdafx.h"
 
+#include <condition_variable>
+
 #include <DDSTextureLoader/DDSTextureLoader9.h>
 #include <WICTextureLoader/WICTextureLoader9.h>
 
@@ -29,11 +31,11 @@
 #include <nfd_common.c>
 #include <nfd_win.cpp>
 #pragma warning(pop)
-#include <wolfssl/wolfcrypt/asn.h>
 
 #include <Modules/GwDatTextureModule.h>
 #include <Constants/EncStrings.h>
 #include <Utils/TextUtils.h>
+#include <Utils/HttpCache.h>
 
 namespace {
     bool initialised_curl = false;
@@ -99,17 +101,70 @@ namespace {
     const wchar_t* PROF_ICONS_PATH = L"img\\professions";
     const wchar_t* DMGTYPE_ICONS_PATH = L"img\\damagetypes";
 
-    std::recursive_mutex worker_mutex;
+    std::mutex worker_mutex;
+    std::condition_variable worker_cv;
     std::recursive_mutex main_mutex;
     std::recursive_mutex dx_mutex;
 
-    // tasks to be done async by the worker thread
-    std::queue<std::function<void()>> thread_jobs;
+    struct WorkerTask {
+        std::function<void()> func;
+        Resources::CancellationToken cancellation_token;
+        std::chrono::steady_clock::time_point enqueued_at;
+    };
+    // tasks to be done async by the worker threads, one queue per Resources::TaskPriority
+    std::array<std::deque<WorkerTask>, 3> thread_jobs;
+    // guarded by worker_mutex
+    Resources::WorkerQueueStats worker_stats;
+    std::chrono::steady_clock::duration total_worker_wait{};
     // tasks to be done in the render thread
     std::queue<std::function<void(IDirect3DDevice9*)>> dx_jobs;
     // tasks to be done in main thread
     std::queue<std::function<void()>> main_jobs;
 
+    // Time per frame that queued main/dx callbacks may use before the rest wait for the next frame
+    constexpr float main_jobs_budget_ms = 1.5f;
+    constexpr float dx_jobs_budget_ms = 1.5f;
+
+    // How often the http cache index is written out while entries are changing
+    constexpr auto http_cache_flush_interval = std::chrono::seconds(10);
+    std::chrono::steady_clock::time_point http_cache_flushed_at;
+
+    // Running average of how long a callback from a queue takes, used to avoid starting one that would blow the budget
+    struct JobCost {
+        float average_ms = 0.f;
+
+        void Add(const float ms) { average_ms = average_ms ? average_ms * 0.8f + ms * 0.2f : ms; }
+    };
+    JobCost main_jobs_cost;
+    JobCost dx_jobs_cost;
+
+    // Runs queued callbacks until the frame budget is spent. At least one callback runs per frame so the queue always drains.
+    template <typename Job, typename... Args>
+    void RunJobs(std::recursive_mutex& mutex, std::queue<Job>& jobs, JobCost& cost, const float budget_ms, Args&&... args)
+    {
+        using clock = std::chrono::steady_clock;
+        const auto frame_start = clock::now();
+        bool ran_one = false;
+        while (true) {
+            const auto task_start = clock::now();
+            const auto elapsed_ms = std::chrono::duration<float, std::milli>(task_start - frame_start).count();
+            if (ran_one && elapsed_ms + cost.average_ms > budget_ms) {
+                return;
+            }
+            mutex.lock();
+            if (jobs.empty()) {
+                mutex.unlock();
+                return;
+            }
+            const Job func = std::move(jobs.front());
+            jobs.pop();
+            mutex.unlock();
+            func(std::forward<Args>(args)...);
+            cost.Add(std::chrono::duration<float, std::milli>(clock::now() - task_start).count());
+            ran_one = true;
+        }
+    }
+
 
     IDirect3DTexture9* empty_texture_ptr = 0;
 
@@ -144,9 +199,54 @@ namespace {
         }
     }
 
+    // Tells the worker threads to exit once they're done with their current task
+    void StopWorkers()
+    {
+        {
+            std::lock_guard lock(worker_mutex);
+            should_stop = true;
+        }
+        worker_cv.notify_all();
+    }
+
+    // Blocks until there's a task to run or the workers are stopping. Returns false if stopping.
+    bool WaitForWorkerTask(WorkerTask& out)
+    {
+        std::unique_lock lock(worker_mutex);
+        worker_cv.wait(lock, [] {
+            return should_stop || std::ranges::any_of(thread_jobs, [](const auto& jobs) { return !jobs.empty(); });
+        });
+        if (should_stop) {
+            return false;
+        }
+        const auto jobs = std::ranges::find_if(thread_jobs, [](const auto& jobs) { return !jobs.empty(); });
+        out = std::move(jobs->front());
+        jobs->pop_front();
+
+        const auto waited = std::chrono::steady_clock::now() - out.enqueued_at;
+        const auto waited_ms = std::chrono::duration<float, std::milli>(waited).count();
+        worker_stats.queued[jobs - thread_jobs.begin()]--;
+        worker_stats.max_wait_ms = std::max(worker_stats.max_wait_ms, waited_ms);
+        total_worker_wait += waited;
+        worker_stats.running++;
+        return true;
+    }
+
+    void OnWorkerTaskFinished(const bool cancelled)
+    {
+        std::lock_guard lock(worker_mutex);
+        worker_stats.running--;
+        if (cancelled) {
+            worker_stats.cancelled++;
+        }
+        else {
+            worker_stats.completed++;
+        }
+    }
+
     class WorkerThread {
     public:
-        bool is_running = false;
+        std::atomic<bool> is_running = false;
         std::jthread thread;
 
         WorkerThread()
@@ -154,18 +254,14 @@ namespace {
             ASSERT(!is_running);
             is_running = true;
             thread = std::jthread([&] {
-                while (!should_stop) {
-                    worker_mutex.lock();
-                    if (thread_jobs.empty()) {
-                        worker_mutex.unlock();
-                        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                    }
-                    else {
-                        std::function<void()> func = thread_jobs.front();
-                        thread_jobs.pop();
-                        worker_mutex.unlock();
-                        func();
+                WorkerTask task;
+                while (WaitForWorkerTask(task)) {
+                    const bool cancelled = task.cancellation_token && *task.cancellation_token;
+                    if (!cancelled) {
+                        task.func();
                     }
+                    task = {};
+                    OnWorkerTaskFinished(cancelled);
                 }
                 is_running = false;
             });
@@ -190,32 +286,131 @@ namespace {
         r->SetVerifyHost(false);
     }
 
-    const std::string HashStr(const std::string& str)
+    void InitPostRestClient(RestClient* r, const std::string& payload, const ContentFlag flag)
     {
-        const auto bytes_to_hash = std::vector<byte>(str.begin(), str.end());
-        auto hash = std::vector<byte>(WC_SHA256_DIGEST_SIZE);
-        wc_Sha256Hash(bytes_to_hash.data(), bytes_to_hash.size(), hash.data());
-        std::stringstream hexstream;
-        hexstream << std::hex << std::setfill('0');
-        for (auto b : hash) {
-            hexstream << std::setw(2) << static_cast<unsigned>(b);
-        }
-        return hexstream.str();
+        r->SetMethod(HttpMethod::Post);
+        r->SetPostContent(payload, flag);
+        const auto content_type = nlohmann::json::accept(payload) ? "application/json" : "application/x-www-form-urlencoded";
+        r->SetHeader("Content-Type", content_type);
+    }
+
+    // 415 is accepted for POST; some endpoints reply with it while still taking the request
+    bool IsPostSuccessful(const RestClient& r)
+    {
+        return r.IsSuccessful() || r.GetStatusCode() == 415;
+    }
+
+    std::string DownloadError(const std::string& url, RestClient& r)
+    {
+        return std::format("Failed to download {}, curl status {} {}", url, r.GetStatusCode(), r.GetStatusStr());
+    }
+
+    std::string PostError(const std::string& url, RestClient& r)
+    {
+        std::string error;
+        StrSprintf(error, "Failed to POST %s, curl status %d %s", url.c_str(), r.GetStatusCode(), r.GetStatusStr());
+        return error;
+    }
+
+    // Request run by the shared curl multi thread, so transfers overlap and reuse connections instead of each one blocking a worker.
+    // on_done runs on a worker thread once the transfer is finished, after which the request deletes itself.
+    class AsyncRequest final : public AsyncRestClient {
+    public:
+        using OnDone = std::function<void(AsyncRequest& request)>;
+
+        static void Get(const std::string& url, OnDone on_done, const Resources::TaskPriority priority, const std::vector<std::string>& headers = {})
+        {
+            const auto request = new AsyncRequest(std::move(on_done), priority);
+            for (const auto& header : headers) {
+                request->SetHeader(header.c_str());
+            }
+            request->SetUrl(url.c_str());
+            request->ExecuteAsync();
+        }
+
+        static void Post(const std::string& url, const std::string& payload, OnDone on_done, const Resources::TaskPriority priority)
+        {
+            const auto request = new AsyncRequest(std::move(on_done), priority);
+            InitPostRestClient(request, payload, ContentFlag::Copy);
+            request->SetUrl(url.c_str());
+            request->ExecuteAsync();
+        }
+
+    private:
+        AsyncRequest(OnDone&& _on_done, const Resources::TaskPriority _priority)
+            : on_done(std::move(_on_done)),
+              priority(_priority)
+        {
+            InitRestClient(this);
+        }
+
+        // Called on the curl thread; anything slow is left to the worker so other transfers keep moving
+        void OnPerformed() override
+        {
+            Resources::EnqueueWorkerTask([this] {
+                Wait(); // OnCompletion marks the request as done right after this returns
+                on_done(*this);
+                delete this;
+            }, priority);
+        }
+
+        OnDone on_done;
+        Resources::TaskPriority priority;
     };
+
+    // Writes downloaded content over path_to_file. If an error occurs, details are held in response string
+    bool WriteDownloadToFile(const std::filesystem::path& path_to_file, const std::string& url, const std::string& content, std::wstring& response)
+    {
+        if (exists(path_to_file)) {
+            if (!std::filesystem::remove(path_to_file)) {
+                return StrSwprintf(response, L"Failed to delete existing file %s, err %d", path_to_file.wstring().c_str(), GetLastError()), false;
+            }
+        }
+        if (exists(path_to_file)) {
+            return StrSwprintf(response, L"File already exists @ %s", path_to_file.wstring().c_str()), false;
+        }
+        if (!content.length()) {
+            return StrSwprintf(response, L"Failed to download %S, no content length", url.c_str()), false;
+        }
+        FILE* fp = fopen(path_to_file.string().c_str(), "wb");
+        if (!fp) {
+            return StrSwprintf(response, L"Failed to call fopen for %s, err %d", path_to_file.wstring().c_str(), GetLastError()), false;
+        }
+        const auto written = fwrite(content.data(), content.size() + 1, 1, fp);
+        fclose(fp);
+        if (written != 1) {
+            return StrSwprintf(response, L"Failed to call fwrite for %s, err %d", path_to_file.wstring().c_str(), GetLastError()), false;
+        }
+        return true;
+    }
 } // namespace
 
 Resources::Resources()
 {
-    InitCurl();
+    InitAsyncRest();
     initialised_curl = true;
     co_initialized = SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
 }
 
-void Resources::EnqueueWorkerTask(const std::function<void()>& f)
+void Resources::EnqueueWorkerTask(const std::function<void()>& f, TaskPriority priority, CancellationToken cancellation_token)
 {
-    worker_mutex.lock();
-    thread_jobs.push(f);
-    worker_mutex.unlock();
+    const auto idx = std::to_underlying(priority);
+    {
+        std::lock_guard lock(worker_mutex);
+        thread_jobs[idx].emplace_back(f, std::move(cancellation_token), std::chrono::steady_clock::now());
+        worker_stats.queued[idx]++;
+    }
+    worker_cv.notify_one();
+}
+
+Resources::WorkerQueueStats Resources::GetWorkerQueueStats()
+{
+    std::lock_guard lock(worker_mutex);
+    auto stats = worker_stats;
+    if (const auto started = stats.completed + stats.cancelled + stats.running) {
+        stats.average_wait_ms = std::chrono::duration<float, std::milli>(total_worker_wait).count() / static_cast<float>(started);
+    }
+    return stats;
 }
 
 void Resources::EnqueueMainTask(const std::function<void()>& f)
@@ -409,8 +604,9 @@ void Resources::Terminate()
     GW::UI::RemoveUIMessageCallback(&OnUIMessage_Hook);
 
     Cleanup();
+    HttpCache::Flush(); // Workers have stopped by now, so nothing else will touch the cache
     if (initialised_curl)
-        ShutdownCurl();
+        ShutdownAsyncRest();
     initialised_curl = false;
     if (co_initialized) {
         CoUninitialize();
@@ -441,14 +637,14 @@ bool Resources::CanTerminate()
 void Resources::SignalTerminate()
 {
     ToolboxModule::SignalTerminate();
-    should_stop = true;
+    StopWorkers();
 }
 
 void Resources::EndLoading() const
 {
-    EnqueueWorkerTask([this] {
-        should_stop = true;
-    });
+    EnqueueWorkerTask([] {
+        StopWorkers();
+    }, TaskPriority::Low);
 }
 
 std::filesystem::path Resources::GetComputerFolderPath()
@@ -515,39 +711,25 @@ utf8::string Resources::GetPathUtf8(const std::wstring& file)
 
 bool Resources::Download(const std::filesystem::path& path_to_file, const std::string& url, std::wstring& response)
 {
-    if (exists(path_to_file)) {
-        if (!std::filesystem::remove(path_to_file)) {
-            return StrSwprintf(response, L"Failed to delete existing file %s, err %d", path_to_file.wstring().c_str(), GetLastError()), false;
-        }
-    }
-    if (exists(path_to_file)) {
-        return StrSwprintf(response, L"File already exists @ %s", path_to_file.wstring().c_str()), false;
-    }
-
     std::string content;
     if (!Download(url, content)) {
         return StrSwprintf(response, L"%S", content.c_str()), false;
     }
-    if (!content.length()) {
-        return StrSwprintf(response, L"Failed to download %S, no content length", url.c_str()), false;
-    }
-    FILE* fp = fopen(path_to_file.string().c_str(), "wb");
-    if (!fp) {
-        return StrSwprintf(response, L"Failed to call fopen for %s, err %d", path_to_file.wstring().c_str(), GetLastError()), false;
-    }
-    const auto written = fwrite(content.data(), content.size() + 1, 1, fp);
-    fclose(fp);
-    if (written != 1) {
-        return StrSwprintf(response, L"Failed to call fwrite for %s, err %d", path_to_file.wstring().c_str(), GetLastError()), false;
-    }
-    return true;
+    return WriteDownloadToFile(path_to_file, url, content, response);
 }
 
 void Resources::Download(const std::filesystem::path& path_to_file, const std::string& url, const AsyncLoadCallback& callback) const
 {
-    EnqueueWorkerTask([this, path_to_file, url, callback] {
+    // Usually a texture or file that something is waiting on
+    AsyncRequest::Get(url, [path_to_file, url, callback](AsyncRequest& request) {
         std::wstring error_message;
-        bool success = Download(path_to_file, url, error_message);
+        bool success = request.IsSuccessful();
+        if (success) {
+            success = WriteDownloadToFile(path_to_file, url, request.GetContent(), error_message);
+        }
+        else {
+            StrSwprintf(error_message, L"%S", DownloadError(url, request).c_str());
+        }
         // and call the callback in the main thread
         if (callback) {
             EnqueueMainTask([callback, success, error_message] {
@@ -557,7 +739,7 @@ void Resources::Download(const std::filesystem::path& path_to_file, const std::s
         else if (!success) {
             Log::LogW(L"Failed to download %s from %S\n%S", path_to_file.wstring().c_str(), url.c_str(), error_message.c_str());
         }
-    });
+    }, TaskPriority::High);
 }
 
 bool Resources::ReadFile(const std::filesystem::path& path, std::string& response)
@@ -594,115 +776,78 @@ bool Resources::Download(const std::string& url, std::string& response)
 
 bool Resources::Download(const std::string& url, std::string& response, int& statusCode)
 {
-    RestClient r;
+    // Still blocking for the caller, but run on the curl multi thread to share its open connections
+    AsyncRestClient r;
     InitRestClient(&r);
     r.SetUrl(url.c_str());
-    r.Execute();
+    r.ExecuteAsync();
+    r.Wait();
     statusCode = r.GetStatusCode();
     if (!r.IsSuccessful()) {
-        response = std::format("Failed to download {}, curl status {} {}", url, r.GetStatusCode(), r.GetStatusStr());
+        response = DownloadError(url, r);
         return false;
     }
     response = std::move(r.GetContent());
     return true;
 }
 
-void Resources::Download(const std::string& url, AsyncLoadMbCallback callback, void* context)
+void Resources::Download(const std::string& url, AsyncLoadMbCallback callback, void* context, TaskPriority priority)
 {
-    EnqueueWorkerTask([url, callback, context] {
-        std::string response;
-        int statusCode = 0;
-        bool ok = Download(url, response, statusCode);
-        EnqueueMainTask([callback, ok, response, context] {
+    AsyncRequest::Get(url, [url, callback, context](AsyncRequest& request) {
+        const bool ok = request.IsSuccessful();
+        std::string response = ok ? std::move(request.GetContent()) : DownloadError(url, request);
+        EnqueueMainTask([callback, ok, response = std::move(response), context] {
             callback(ok, response, context);
         });
-    });
+    }, priority);
 }
 
 void Resources::Download(const std::string& url, AsyncLoadMbCallback callback, void* context, std::chrono::seconds cache_duration)
 {
-    EnqueueWorkerTask([url, callback, context, &cache_duration] {
-        const auto get_cache_modified_time = [](const std::filesystem::path& file_name) -> std::optional<std::filesystem::file_time_type> {
-            if (!std::filesystem::exists(file_name)) {
-                return std::optional<std::filesystem::file_time_type>();
-            }
-
-            const auto file_time = std::filesystem::last_write_time(file_name);
-            return file_time;
-        };
-
-        const auto load_from_cache = [](const std::filesystem::path& file_name) -> std::optional<std::string> {
-            std::ifstream cache_file(file_name);
-            if (!cache_file.is_open()) {
-                return {};
-            }
-
-            std::string contents((std::istreambuf_iterator<char>(cache_file)), std::istreambuf_iterator<char>());
-            return contents;
-        };
-
-        const auto save_to_cache = [](const std::filesystem::path& file_name, const std::string& content) -> bool {
-            std::filesystem::create_directories(file_name.parent_path());
-            std::ofstream cache_file(file_name);
-            if (!cache_file.is_open()) {
-                return false;
+    EnqueueWorkerTask([url, callback, context, cache_duration] {
+        std::string cached;
+        if (HttpCache::GetFresh(url, cached)) {
+            EnqueueMainTask([callback, cached = std::move(cached), context] {
+                callback(true, cached, context);
+            });
+            return;
+        }
+        // Expired or missing; if we have validators the server only sends the body again if it changed
+        AsyncRequest::Get(url, [url, callback, context, cache_duration](AsyncRequest& request) {
+            std::string response;
+            bool ok = false;
+            if (request.GetStatusCode() == 304) {
+                ok = HttpCache::Revalidate(url, cache_duration, response);
             }
-
-            cache_file << content;
-            return true;
-        };
-
-        const auto remove_protocol = [](const std::string& url) -> std::string {
-            const std::string http = "http://";
-            const std::string https = "https://";
-
-            // Check if the URL starts with http:// or https:// and remove it
-            if (url.substr(0, http.size()) == http) {
-                return url.substr(http.size());
+            else if (request.IsSuccessful()) {
+                HttpCache::Store(url, request.GetContent(), request.GetHeader(), cache_duration);
+                response = std::move(request.GetContent());
+                ok = true;
             }
-            if (url.substr(0, https.size()) == https) {
-                return url.substr(https.size());
+            // Better an outdated copy than nothing if the server can't be reached
+            if (!ok) {
+                ok = HttpCache::GetStale(url, response);
             }
-            return url; // Return the original if no match is found
-        };
-        const auto cache_path = Resources::GetPath("cache") / HashStr(remove_protocol(url));
-        const auto expiration = get_cache_modified_time(cache_path);
-        if (expiration.has_value() &&
-            expiration.value() - std::chrono::file_clock::now() < cache_duration) {
-            const auto response = load_from_cache(cache_path);
-            if (response.has_value()) {
-                EnqueueMainTask([callback, context, response] {
-                    callback(true, response.value(), context);
-                });
-                return;
+            if (!ok) {
+                response = DownloadError(url, request);
             }
-        }
-        std::string response;
-        int statusCode = 0;
-        bool ok = Download(url, response, statusCode);
-        if (ok ||
-            (statusCode >= 300 && statusCode < 500)) {
-            save_to_cache(cache_path, response);
-        }
-        EnqueueMainTask([callback, ok, response, context] {
-            callback(ok, response, context);
-        });
+            EnqueueMainTask([callback, ok, response = std::move(response), context] {
+                callback(ok, response, context);
+            });
+        }, TaskPriority::Normal, HttpCache::GetValidators(url));
     });
 }
 
 bool Resources::Post(const std::string& url, const std::string& payload, std::string& response)
 {
-    RestClient r;
+    AsyncRestClient r;
     InitRestClient(&r);
-    r.SetMethod(HttpMethod::Post);
-    r.SetPostContent(payload.c_str(), payload.size(), ContentFlag::ByRef);
-
-    std::string content_type = nlohmann::json::accept(payload) ? "application/json" : "application/x-www-form-urlencoded";
-    r.SetHeader("Content-Type", content_type.c_str());
+    InitPostRestClient(&r, payload, ContentFlag::ByRef);
     r.SetUrl(url.c_str());
-    r.Execute();
-    if (!(r.IsSuccessful() || r.GetStatusCode() == 415)) {
-        StrSprintf(response, "Failed to POST %s, curl status %d %s", url.c_str(), r.GetStatusCode(), r.GetStatusStr());
+    r.ExecuteAsync();
+    r.Wait();
+    if (!IsPostSuccessful(r)) {
+        response = PostError(url, r);
         return false;
     }
     response = std::move(r.GetContent());
@@ -711,13 +856,13 @@ bool Resources::Post(const std::string& url, const std::string& payload, std::st
 
 void Resources::Post(const std::string& url, const std::string& payload, AsyncLoadMbCallback callback, void* wparam)
 {
-    EnqueueWorkerTask([url, payload, callback, wparam] {
-        std::string response;
-        bool ok = Post(url, payload, response);
-        EnqueueMainTask([callback, ok, response, wparam] {
+    AsyncRequest::Post(url, payload, [url, callback, wparam](AsyncRequest& request) {
+        const bool ok = IsPostSuccessful(request);
+        std::string response = ok ? std::move(request.GetContent()) : PostError(url, request);
+        EnqueueMainTask([callback, ok, response = std::move(response), wparam] {
             callback(ok, response, wparam);
         });
-    });
+    }, TaskPriority::Normal);
 }
 
 void Resources::EnsureFileExists(const std::filesystem::path& path_to_file, const std::string& url, const AsyncLoadCallback& callback)
@@ -904,30 +1049,16 @@ int Resources::SaveIniToFile(const std::filesystem::path& absolute_path, const T
 
 void Resources::DxUpdate(IDirect3DDevice9* device)
 {
-    while (true) {
-        dx_mutex.lock();
-        if (dx_jobs.empty()) {
-            dx_mutex.unlock();
-            return;
-        }
-        const std::function<void(IDirect3DDevice9*)> func = std::move(dx_jobs.front());
-        dx_jobs.pop();
-        dx_mutex.unlock();
-        func(device);
-    }
+    RunJobs(dx_mutex, dx_jobs, dx_jobs_cost, dx_jobs_budget_ms, device);
 }
 
 void Resources::Update(float)
 {
-    main_mutex.lock();
-    if (main_jobs.empty()) {
-        main_mutex.unlock();
-        return;
+    RunJobs(main_mutex, main_jobs, main_jobs_cost, main_jobs_budget_ms);
+    if (const auto now = std::chrono::steady_clock::now(); now - http_cache_flushed_at > http_cache_flush_interval) {
+        http_cache_flushed_at = now;
+        HttpCache::QueueFlush();
     }
-    const auto func = std::move(main_jobs.front());
-    main_jobs.pop();
-    main_mutex.unlock();
-    func();
 }
 
 IDirect3DTexture9** Resources::GetProfessionIcon(GW::Constants::Profession p)
@@ -1048,7 +1179,7 @@ IDirect3DTexture9** Resources::GetGuildWarsWikiImage(const char* filename, size_
             image_url = std::format("https://wiki.guildwars.com{}", image_url);
         }
         LoadTexture(texture, path_to_file2, image_url, callback);
-    });
+    }, nullptr, TaskPriority::High);
     return texture;
 }
 
@@ -1147,7 +1278,7 @@ IDirect3DTexture9** Resources::GetSkillImageFromGWW(GW::Constants::SkillID skill
             snprintf(url, _countof(url), "https://wiki.guildwars.com%s%s", image_path.c_str(), image_extension.c_str());
         }
         LoadTexture(texture, path_to_file, url, callback);
-    });
+    }, nullptr, TaskPriority::High);
     return texture;
 }
 
@@ -1341,6 +1472,6 @@ IDirect3DTexture9** Resources::GetItemImage(const std::wstring& item_name)
             snprintf(url, _countof(url), "https://wiki.guildwars.com%s%s", image_path.c_str(), image_extension.c_str());
         }
         LoadTexture(texture, path_to_file, url, callback);
-    });
+    }, nullptr, TaskPriority::High);
     return texture;
 }
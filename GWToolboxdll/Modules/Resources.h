@@ -3,6 +3,8 @@
 #include <ToolboxModule.h>
 #include <Utf8.h>
 
+#include <atomic>
+
 namespace GuiUtils {
     class EncString;
 }
@@ -41,8 +43,28 @@ public:
     void Update(float delta) override;
     static void DxUpdate(IDirect3DDevice9* device);
 
+    // Order in which queued worker tasks are picked up; tasks of the same priority run first in, first out
+    enum class TaskPriority : uint8_t {
+        High,   // Something the user is waiting on e.g. textures, price checks
+        Normal,
+        Low     // Background refreshes that can wait e.g. update checks
+    };
+    // Set to true to drop a worker task that hasn't started yet. A task that is already running can poll it to bail out early.
+    using CancellationToken = std::shared_ptr<std::atomic<bool>>;
+    static CancellationToken CreateCancellationToken() { return std::make_shared<std::atomic<bool>>(false); }
+
+    struct WorkerQueueStats {
+        std::array<size_t, 3> queued{}; // Indexed by TaskPriority
+        size_t running = 0;
+        size_t completed = 0;
+        size_t cancelled = 0;
+        float average_wait_ms = 0.f; // Time between being enqueued and starting to run
+        float max_wait_ms = 0.f;
+    };
+    static WorkerQueueStats GetWorkerQueueStats();
+
     // Enqueue instruction to be called on worker thread, away from the render loop e.g. curl requests
-    static void EnqueueWorkerTask(const std::function<void()>& f);
+    static void EnqueueWorkerTask(const std::function<void()>& f, TaskPriority priority = TaskPriority::Normal, CancellationToken cancellation_token = nullptr);
     // Enqueue instruction to be called on the main update loop of GW
     static void EnqueueMainTask(const std::function<void()>& f);
     // Enqueue instruction to be called on the draw loop of GW e.g. messing with DirectX9 device
@@ -131,7 +153,7 @@ public:
     // download to memory, blocking. If an error occurs, details are held in response string
     static bool Download(const std::string& url, std::string& response, int& statusCode);
     // download to memory, async, calls callback on completion. If an error occurs, details are held in response string
-    static void Download(const std::string& url, AsyncLoadMbCallback callback, void* context = nullptr);
+    static void Download(const std::string& url, AsyncLoadMbCallback callback, void* context = nullptr, TaskPriority priority = TaskPriority::Normal);
     // download to memory, async, calls callback on completion and caches the response locally for the duration specified. If an error occurs, details are held in response string
     static void Download(const std::string& url, AsyncLoadMbCallback callback, void* context, std::chrono::seconds cache_duration);
 
@@ -21,6 +21,7 @@
 
 #include <wintoast/wintoastlib.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 #include <Utils/ToolboxUtils.h>
 #include <Defines.h>
 #include <Utils/TextUtils.h>
@@ -424,7 +425,7 @@ void ToastNotifications::Initialize()
     is_platform_compatible = WinToastLib::WinToast::isCompatible();
     GW::UI::RegisterUIMessageCallback(&OnWhisper_Entry, GW::UI::UIMessage::kRecvWhisper, OnRecvWhisper);
     for (auto& callback : stoc_callbacks) {
-        GW::StoC::RegisterPacketCallback(&callback.hook_entry, callback.header, callback.cb, 0x8000);
+        FrameProfiler::RegisterPacketCallback(&callback.hook_entry, callback.header, callback.cb, 0x8000);
     }
 }
 
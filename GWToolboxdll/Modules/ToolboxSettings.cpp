@@ -67,6 +67,7 @@
 #include <Windows/SkillListingWindow.h>
 #endif
 #include <Windows/TargetInfoWindow.h>
+#include <Windows/FrameProfilerWindow.h>
 
 #include <Widgets/TimerWidget.h>
 #include <Widgets/HealthWidget.h>
@@ -202,7 +203,8 @@ namespace {
         DupingWindow::Instance(),
         ArmoryWindow::Instance(),
         EnemyWindow::Instance(),
-        TargetInfoWindow::Instance()
+        TargetInfoWindow::Instance(),
+        {FrameProfilerWindow::Instance(), false}
     };
 
     bool modules_sorted = false;
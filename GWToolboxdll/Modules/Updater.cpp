@@ -301,7 +301,7 @@ void Updater::CheckForUpdate(const bool forced)
                 step = CheckAndWarn;
                 break;
         }
-    });
+    }, Resources::TaskPriority::Low);
 }
 
 void Updater::Draw(IDirect3DDevice9*)
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 
 #include <ToolboxModule.h>
+#include <Utils/FrameProfiler.h>
 
 namespace {
     // static function to register content
@@ -9,6 +10,10 @@ namespace {
     std::unordered_map<std::string, ToolboxModule*> modules_loaded{};
 
     std::unordered_map<ToolboxModule*, std::vector<SectionDrawCallback>> module_setting_draw_callbacks;
+
+    // Interval modules start at one of this many evenly spaced offsets into their interval, in turn
+    constexpr uint32_t stagger_slots = 16;
+    uint32_t next_stagger_slot = 0;
 } // namespace
 
 const std::unordered_map<std::string, SectionDrawCallbackList>& ToolboxModule::GetSettingsCallbacks() { return settings_draw_callbacks; }
@@ -18,6 +23,9 @@ const std::unordered_map<std::string, ToolboxModule*>& ToolboxModule::GetModules
 void ToolboxModule::Initialize()
 {
     RegisterSettingsContent();
+    // Start afresh if this module was enabled before
+    last_update = 0;
+    next_update = 0;
 }
 
 void ToolboxModule::Terminate()
@@ -43,6 +51,39 @@ void ToolboxModule::Terminate()
     }
 }
 
+void ToolboxModule::ScheduledUpdate(const int64_t now, const int64_t ticks_per_second)
+{
+    const auto cadence = GetUpdateCadence();
+    const bool requested = update_requested.exchange(false);
+    // Every module gets a first update, whatever its cadence
+    if (!requested && last_update) {
+        if (cadence == UpdateCadence::OnEvent) {
+            return;
+        }
+        if (cadence == UpdateCadence::Interval && now < next_update) {
+            return;
+        }
+    }
+
+    if (cadence == UpdateCadence::Interval) {
+        const int64_t interval = static_cast<int64_t>(UpdateIntervalMs()) * ticks_per_second / 1000;
+        if (!next_update) {
+            next_update = now + interval + interval * (next_stagger_slot++ % stagger_slots) / stagger_slots;
+        }
+        else if (now >= next_update) {
+            next_update += interval;
+            if (next_update <= now) {
+                next_update = now + interval; // Fell behind, e.g. while loading; don't catch up
+            }
+        }
+    }
+
+    const float delta = last_update ? static_cast<float>(static_cast<double>(now - last_update) / static_cast<double>(ticks_per_second)) : 0.f;
+    last_update = now;
+    FrameProfiler::Scope scope(Name(), FrameProfiler::Phase::Update);
+    Update(delta);
+}
+
 void ToolboxModule::RegisterSettingsContent()
 {
     if (!HasSettings()) {
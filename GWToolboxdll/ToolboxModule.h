@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+
 using SectionDrawCallback = std::function<void(const std::string& section, bool is_showing)>;
 class ToolboxModule;
 
@@ -11,6 +13,12 @@ struct SectionDrawCallbackInfo {
 
 using SectionDrawCallbackList = std::vector<SectionDrawCallbackInfo>;
 
+enum class UpdateCadence : uint8_t {
+    EveryFrame,
+    Interval, // Every UpdateIntervalMs(), spread over frames so modules with the same interval don't all run on the same one
+    OnEvent   // Only on the frame after RequestUpdate()
+};
+
 class ToolboxModule {
 protected:
     ToolboxModule() = default;
@@ -64,9 +72,18 @@ public:
     // Terminate module
     virtual void Terminate();
 
-    // Update. Will always be called once every frame. Delta in seconds
+    // Update. Called once every frame unless GetUpdateCadence() says otherwise. Delta in seconds since this module's last update
     virtual void Update(float) { }
 
+    // How often Update is called. Modules that only poll for something slow should use an interval or events to stay off the frame.
+    [[nodiscard]] virtual UpdateCadence GetUpdateCadence() const { return UpdateCadence::EveryFrame; }
+    [[nodiscard]] virtual uint32_t UpdateIntervalMs() const { return 1000; }
+    // Update on the next frame regardless of cadence. Thread safe.
+    void RequestUpdate() { update_requested = true; }
+
+    // Called by GWToolbox every frame with the current QueryPerformanceCounter time; calls Update if it's due
+    void ScheduledUpdate(int64_t now, int64_t ticks_per_second);
+
     // This is provided (and called), but use ImGui::GetIO() during update/render if possible.
     virtual bool WndProc(UINT, WPARAM, LPARAM) { return false; }
 
@@ -87,4 +104,10 @@ public:
 protected:
     // Weighting used to decide where to position the DrawSettingInternal() for this module. Useful when more than 1 module has the same SettingsName().
     virtual float SettingsWeighting() { return 1.0f; }
+
+private:
+    std::atomic<bool> update_requested = false;
+    // QueryPerformanceCounter ticks; 0 until the first scheduled update
+    int64_t last_update = 0;
+    int64_t next_update = 0;
 };
@@ -0,0 +1,46 @@
+#include "stdafx.h"
+
+#include <Utils/TextUtils.h>
+#include "AlertRules.h"
+
+void AlertRules::Clear()
+{
+    literals.Clear();
+    regexes.clear();
+}
+
+void AlertRules::Build(const std::vector<std::string>& words)
+{
+    Clear();
+    std::vector<std::wstring> plain_words;
+    for (const auto& word : words) {
+        if (word.empty()) {
+            continue;
+        }
+        // "/pattern/" with an optional trailing flag letter, which is ignored
+        std::string_view pattern = word;
+        if (pattern.size() >= 3 && std::isalpha(static_cast<unsigned char>(pattern.back())) && pattern[pattern.size() - 2] == '/') {
+            pattern.remove_suffix(1);
+        }
+        if (pattern.size() >= 2 && pattern.front() == '/' && pattern.back() == '/') {
+            try {
+                regexes.emplace_back(pattern.begin() + 1, pattern.end() - 1, std::regex::ECMAScript | std::regex::icase | std::regex::optimize);
+            } catch (const std::exception&) {
+                // Silent fail; invalid regex
+            }
+            continue;
+        }
+        plain_words.push_back(TextUtils::StringToWString(word));
+    }
+    literals.Build(plain_words);
+}
+
+bool AlertRules::Matches(const std::string_view message) const
+{
+    if (!literals.Empty() && literals.Contains(TextUtils::StringToWString(message))) {
+        return true;
+    }
+    return std::ranges::any_of(regexes, [message](const std::regex& regex) {
+        return std::regex_search(message.begin(), message.end(), regex);
+    });
+}
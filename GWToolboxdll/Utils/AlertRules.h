@@ -0,0 +1,21 @@
+#pragma once
+
+#include <Utils/TextMatcher.h>
+
+// Keyword list used by the trade and party search alerts: one rule per line, "/pattern/" for a regex, otherwise a plain word.
+// Both kinds are case insensitive. Rules are compiled once in Build; Matches only scans the message.
+class AlertRules {
+public:
+    // Invalid regexes and empty lines are skipped
+    void Build(const std::vector<std::string>& words);
+    void Clear();
+
+    [[nodiscard]] bool Empty() const { return literals.Empty() && regexes.empty(); }
+
+    // True if any rule matches the utf8 message
+    [[nodiscard]] bool Matches(std::string_view message) const;
+
+private:
+    TextMatcher literals;
+    std::vector<std::regex> regexes;
+};
@@ -0,0 +1,337 @@
+#include "stdafx.h"
+
+#include <atomic>
+#include <numeric>
+
+#include <Modules/Resources.h>
+
+#include "FrameProfiler.h"
+
+namespace {
+    using FrameProfiler::Phase;
+    using FrameProfiler::frame_history;
+
+    // Cost of one name and phase
+    struct Timings {
+        const char* name;
+        Phase phase;
+        int64_t frame_ticks = 0;
+        uint32_t frame_calls = 0;
+        // Ring buffers of the last frame_history frames
+        std::array<float, frame_history> frame_ms{};
+        std::array<uint32_t, frame_history> calls{};
+    };
+
+    struct TraceEvent {
+        const char* name;
+        Phase phase;
+        int64_t started;
+        int64_t ticks;
+    };
+
+    std::atomic<bool> enabled = false;
+    std::mutex profiler_mutex;
+    int64_t ticks_per_second = 0;
+
+    std::vector<Timings> timings;
+    std::unordered_map<uint64_t, size_t> timings_by_key;
+    std::array<float, frame_history> total_frame_ms{};
+    // Next slot in the ring buffers, and how many of them are filled
+    size_t history_cursor = 0;
+    size_t history_count = 0;
+
+    size_t trace_frames_left = 0;
+    std::filesystem::path trace_path;
+    std::vector<TraceEvent> trace_events;
+    std::vector<int64_t> trace_frame_ends;
+
+    thread_local const char* current_owner = nullptr;
+
+    int64_t Now()
+    {
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        return now.QuadPart;
+    }
+
+    float TicksToMs(const int64_t ticks)
+    {
+        return static_cast<float>(static_cast<double>(ticks) * 1000.0 / static_cast<double>(ticks_per_second));
+    }
+
+    double TicksToUs(const int64_t ticks)
+    {
+        return static_cast<double>(ticks) * 1000000.0 / static_cast<double>(ticks_per_second);
+    }
+
+    Timings& GetTimings(const char* name, const Phase phase)
+    {
+        const uint64_t key = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(name)) << 8 | static_cast<uint8_t>(phase);
+        const auto found = timings_by_key.find(key);
+        if (found != timings_by_key.end()) {
+            return timings[found->second];
+        }
+        timings_by_key.emplace(key, timings.size());
+        return timings.emplace_back(Timings{name, phase});
+    }
+
+    FrameProfiler::Stats MakeStats(const char* name, const Phase phase, const float* frame_ms, const uint32_t* calls)
+    {
+        FrameProfiler::Stats stats{name, phase, 0.f, 0.f, 0.f, 0.f};
+        if (!history_count) {
+            return stats;
+        }
+        std::array<float, frame_history> sorted{};
+        std::copy_n(frame_ms, history_count, sorted.begin());
+        const auto end = sorted.begin() + static_cast<ptrdiff_t>(history_count);
+        std::sort(sorted.begin(), end);
+        stats.p50_ms = sorted[history_count / 2];
+        stats.p95_ms = sorted[std::min(history_count - 1, history_count * 95 / 100)];
+        stats.max_ms = sorted[history_count - 1];
+        if (calls) {
+            stats.calls_per_frame = static_cast<float>(std::accumulate(calls, calls + history_count, 0u)) / static_cast<float>(history_count);
+        }
+        return stats;
+    }
+
+    void AppendJsonString(std::string& out, const char* str)
+    {
+        out += '"';
+        for (; *str; str++) {
+            const char c = *str;
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20) {
+                out += std::format("\\u{:04x}", static_cast<unsigned>(c));
+            }
+            else {
+                out += c;
+            }
+        }
+        out += '"';
+    }
+
+    // Chrome's trace event format: one complete ("X") event per scope on a row per phase, and an instant event at the end of each frame
+    void WriteTrace(const std::filesystem::path& path, const std::vector<TraceEvent>& events, const std::vector<int64_t>& frame_ends)
+    {
+        const int64_t origin = events.empty() ? 0 : events.front().started;
+        std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        for (uint8_t phase = 0; phase < static_cast<uint8_t>(Phase::Count); phase++) {
+            json += std::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"{}"}}}},)", phase + 1, FrameProfiler::GetPhaseName(static_cast<Phase>(phase)));
+            json += '\n';
+        }
+        for (const auto& event : events) {
+            json += "{\"name\":";
+            AppendJsonString(json, event.name);
+            json += std::format(R"(,"cat":"{}","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}},)",
+                                FrameProfiler::GetPhaseName(event.phase), static_cast<uint8_t>(event.phase) + 1, TicksToUs(event.started - origin), TicksToUs(event.ticks));
+            json += '\n';
+        }
+        for (size_t i = 0; i < frame_ends.size(); i++) {
+            json += std::format(R"({{"name":"Frame {}","ph":"i","s":"g","pid":1,"tid":0,"ts":{:.3f}}})", i, TicksToUs(frame_ends[i] - origin));
+            json += i + 1 < frame_ends.size() ? ",\n" : "\n";
+        }
+        if (frame_ends.empty() && json.ends_with(",\n")) {
+            json.resize(json.size() - 2);
+        }
+        json += "]}\n";
+
+        const bool written = [&] {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            return file.is_open() && file.write(json.data(), static_cast<std::streamsize>(json.size())).good();
+        }();
+        Resources::EnqueueMainTask([written, path] {
+            if (written) {
+                Log::Info("Frame trace saved to %s", path.string().c_str());
+            }
+            else {
+                Log::Error("Failed to save frame trace to %s", path.string().c_str());
+            }
+        });
+    }
+
+    // Writes what has been recorded so far on a worker thread; call with profiler_mutex held
+    void FinishTrace()
+    {
+        trace_frames_left = 0;
+        Resources::EnqueueWorkerTask([path = trace_path, events = std::move(trace_events), frame_ends = std::move(trace_frame_ends)] {
+            WriteTrace(path, events, frame_ends);
+        });
+        trace_events.clear();
+        trace_frame_ends.clear();
+    }
+}
+
+namespace FrameProfiler {
+    const char* GetPhaseName(const Phase phase)
+    {
+        switch (phase) {
+            case Phase::Update:
+                return "Update";
+            case Phase::Draw:
+                return "Draw";
+            case Phase::WndProc:
+                return "WndProc";
+            case Phase::Packet:
+                return "Packet";
+            default:
+                return "Total";
+        }
+    }
+
+    void SetEnabled(const bool enable)
+    {
+        if (enable && !ticks_per_second) {
+            LARGE_INTEGER frequency;
+            QueryPerformanceFrequency(&frequency);
+            ticks_per_second = frequency.QuadPart;
+        }
+        enabled = enable;
+        if (!enable) {
+            // EndFrame won't run anymore, so a capture in progress is cut short rather than left hanging
+            std::lock_guard lock(profiler_mutex);
+            if (trace_frames_left) {
+                FinishTrace();
+            }
+        }
+    }
+
+    bool IsEnabled()
+    {
+        return enabled;
+    }
+
+    OwnerScope::OwnerScope(const char* name)
+        : previous(current_owner)
+    {
+        current_owner = name;
+    }
+
+    OwnerScope::~OwnerScope()
+    {
+        current_owner = previous;
+    }
+
+    Scope::Scope(const char* scope_name, const Phase scope_phase)
+        : owner(scope_name)
+        , name(scope_name)
+        , phase(scope_phase)
+        , started(enabled ? Now() : 0) { }
+
+    Scope::~Scope()
+    {
+        if (!started) {
+            return;
+        }
+        const auto ticks = Now() - started;
+        std::lock_guard lock(profiler_mutex);
+        auto& t = GetTimings(name, phase);
+        t.frame_ticks += ticks;
+        t.frame_calls++;
+        if (trace_frames_left) {
+            trace_events.push_back({name, phase, started, ticks});
+        }
+    }
+
+    void EndFrame()
+    {
+        if (!enabled) {
+            return;
+        }
+        std::lock_guard lock(profiler_mutex);
+        float total_ms = 0.f;
+        for (auto& t : timings) {
+            const float ms = TicksToMs(t.frame_ticks);
+            t.frame_ms[history_cursor] = ms;
+            t.calls[history_cursor] = t.frame_calls;
+            t.frame_ticks = 0;
+            t.frame_calls = 0;
+            total_ms += ms;
+        }
+        total_frame_ms[history_cursor] = total_ms;
+        history_cursor = (history_cursor + 1) % frame_history;
+        history_count = std::min(history_count + 1, frame_history);
+
+        if (trace_frames_left) {
+            trace_frame_ends.push_back(Now());
+            if (--trace_frames_left == 0) {
+                FinishTrace();
+            }
+        }
+    }
+
+    std::vector<Stats> GetStats()
+    {
+        std::lock_guard lock(profiler_mutex);
+        std::vector<Stats> stats;
+        stats.reserve(timings.size());
+        for (const auto& t : timings) {
+            stats.push_back(MakeStats(t.name, t.phase, t.frame_ms.data(), t.calls.data()));
+        }
+        return stats;
+    }
+
+    Stats GetTotalStats()
+    {
+        std::lock_guard lock(profiler_mutex);
+        return MakeStats("All modules", Phase::Count, total_frame_ms.data(), nullptr);
+    }
+
+    void Reset()
+    {
+        std::lock_guard lock(profiler_mutex);
+        timings.clear();
+        timings_by_key.clear();
+        history_cursor = 0;
+        history_count = 0;
+    }
+
+    void CaptureTrace(const size_t frame_count, const std::filesystem::path& path)
+    {
+        std::lock_guard lock(profiler_mutex);
+        trace_path = path;
+        trace_events.clear();
+        trace_frame_ends.clear();
+        trace_frames_left = frame_count;
+    }
+
+    bool IsCapturingTrace()
+    {
+        std::lock_guard lock(profiler_mutex);
+        return trace_frames_left != 0;
+    }
+
+    GW::StoC::PacketCallback Profiled(const uint32_t header, const GW::StoC::PacketCallback& callback)
+    {
+        const auto name = current_owner ? current_owner : GetPacketName(header);
+        return [callback, name](GW::HookStatus* status, GW::Packet::StoC::PacketBase* packet) {
+            Scope scope(name, Phase::Packet);
+            callback(status, packet);
+        };
+    }
+
+    bool RegisterPacketCallback(GW::HookEntry* entry, const uint32_t header, const GW::StoC::PacketCallback& callback, const int altitude)
+    {
+        return GW::StoC::RegisterPacketCallback(entry, header, Profiled(header, callback), altitude);
+    }
+
+    bool RegisterPostPacketCallback(GW::HookEntry* entry, const uint32_t header, const GW::StoC::PacketCallback& callback)
+    {
+        return GW::StoC::RegisterPostPacketCallback(entry, header, Profiled(header, callback));
+    }
+
+    const char* GetPacketName(const uint32_t header)
+    {
+        // Nodes of an unordered_map don't move, so the strings stay put
+        static std::unordered_map<uint32_t, std::string> names;
+        static std::mutex names_mutex;
+        std::lock_guard lock(names_mutex);
+        auto& name = names[header];
+        if (name.empty()) {
+            name = std::format("StoC 0x{:03X}", header);
+        }
+        return name.c_str();
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <GWCA/Utilities/Hook.h>
+#include <GWCA/Managers/StoCMgr.h>
+
+// Per module frame timings: each module's Update, Draw and WndProc, and the StoC callbacks it registered through FrameProfiler::RegisterPacketCallback.
+// Time is summed per frame, so percentiles are of a module's cost per frame rather than per call.
+// Nothing is measured unless enabled; FrameProfilerWindow enables it while it's open.
+namespace FrameProfiler {
+    enum class Phase : uint8_t {
+        Update,
+        Draw,
+        WndProc,
+        Packet,
+        Count
+    };
+    [[nodiscard]] const char* GetPhaseName(Phase phase);
+
+    void SetEnabled(bool enable);
+    [[nodiscard]] bool IsEnabled();
+
+    // Marks name as the module running on this thread until it goes out of scope; StoC callbacks registered meanwhile are timed under its name.
+    // name is kept by pointer and must outlive the profiler, e.g. a module's Name() or a string literal.
+    class OwnerScope {
+    public:
+        explicit OwnerScope(const char* name);
+        ~OwnerScope();
+        OwnerScope(const OwnerScope&) = delete;
+        OwnerScope& operator=(const OwnerScope&) = delete;
+
+    private:
+        const char* previous;
+    };
+
+    // Adds the time until it goes out of scope to name's cost for this frame; name is also the OwnerScope meanwhile
+    class Scope {
+    public:
+        Scope(const char* name, Phase phase);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        OwnerScope owner;
+        const char* name;
+        Phase phase;
+        int64_t started = 0;
+    };
+
+    // Registers with GW::StoC, timing the callback as a Packet of the module that's registering it (see OwnerScope).
+    // Outside of a module it's labelled by packet header instead.
+    [[nodiscard]] GW::StoC::PacketCallback Profiled(uint32_t header, const GW::StoC::PacketCallback& callback);
+    bool RegisterPacketCallback(GW::HookEntry* entry, uint32_t header, const GW::StoC::PacketCallback& callback, int altitude = -0x8000);
+    bool RegisterPostPacketCallback(GW::HookEntry* entry, uint32_t header, const GW::StoC::PacketCallback& callback);
+
+    template <typename T>
+    bool RegisterPacketCallback(GW::HookEntry* entry, const GW::HookCallback<T*>& handler, int altitude = -0x8000)
+    {
+        return RegisterPacketCallback(entry, GW::Packet::StoC::Packet<T>::STATIC_HEADER,
+                                      [handler](GW::HookStatus* status, GW::Packet::StoC::PacketBase* packet) -> void {
+                                          handler(status, static_cast<T*>(packet));
+                                      }, altitude);
+    }
+
+    template <typename T>
+    bool RegisterPostPacketCallback(GW::HookEntry* entry, const GW::HookCallback<T*>& handler)
+    {
+        return RegisterPostPacketCallback(entry, GW::Packet::StoC::Packet<T>::STATIC_HEADER,
+                                          [handler](GW::HookStatus* status, GW::Packet::StoC::PacketBase* packet) -> void {
+                                              handler(status, static_cast<T*>(packet));
+                                          });
+    }
+
+    // Closes the current frame; call once per frame after everything has been drawn
+    void EndFrame();
+
+    constexpr size_t frame_history = 240;
+
+    struct Stats {
+        const char* name;
+        Phase phase;
+        // Over the last frame_history frames
+        float p50_ms;
+        float p95_ms;
+        float max_ms;
+        float calls_per_frame;
+    };
+    [[nodiscard]] std::vector<Stats> GetStats();
+    // Everything measured in a frame, summed; phase is Phase::Count
+    [[nodiscard]] Stats GetTotalStats();
+    void Reset();
+
+    // Records every scope of the next frame_count frames, or until profiling is disabled, then writes them to path as Chrome trace JSON (chrome://tracing, ui.perfetto.dev) on a worker thread
+    void CaptureTrace(size_t frame_count, const std::filesystem::path& path);
+    [[nodiscard]] bool IsCapturingTrace();
+
+    // Stable name for a StoC packet header, for use as a scope name
+    [[nodiscard]] const char* GetPacketName(uint32_t header);
+}
@@ -0,0 +1,338 @@
+#include "stdafx.h"
+
+#include <Modules/Resources.h>
+#include "HttpCache.h"
+
+namespace {
+    constexpr size_t disk_cache_max_bytes = 64 * 1024 * 1024;
+    constexpr size_t memory_cache_max_bytes = 4 * 1024 * 1024;
+    // Anything bigger than this is only kept on disk
+    constexpr size_t memory_cache_max_entry_bytes = 512 * 1024;
+
+    struct Entry {
+        std::string file;
+        std::string etag;
+        std::string last_modified;
+        int64_t expires = 0;
+        int64_t last_used = 0;
+        size_t size = 0;
+    };
+
+    std::mutex cache_mutex;
+    bool index_loaded = false;
+    // Set whenever entries change; the index is written by Flush rather than on every change
+    std::atomic<bool> index_dirty = false;
+    std::atomic<bool> flush_queued = false;
+    // Held while writing the index so flushes land in the order their snapshots were taken
+    std::mutex index_write_mutex;
+    std::unordered_map<std::string, Entry> entries; // by url
+    size_t disk_bytes = 0;
+
+    // Most recently used at the front
+    std::list<std::pair<std::string, std::string>> memory_lru; // url, body
+    std::unordered_map<std::string, decltype(memory_lru)::iterator> memory_by_url;
+    size_t memory_bytes = 0;
+
+    int64_t Now()
+    {
+        return std::time(nullptr);
+    }
+
+    std::filesystem::path CacheFolder()
+    {
+        return Resources::GetPath("cache") / "http";
+    }
+
+    std::filesystem::path IndexPath()
+    {
+        return CacheFolder() / "index.json";
+    }
+
+    // Stable across runs, unlike std::hash
+    std::string FileNameForUrl(const std::string& url)
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (const auto c : url) {
+            hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ull;
+        }
+        return std::format("{:016x}", hash);
+    }
+
+    // Last value of the given header; headers may hold several responses if there were redirects
+    std::string FindHeader(const std::string& headers, const std::string_view name)
+    {
+        std::string found;
+        size_t pos = 0;
+        while (pos < headers.size()) {
+            auto end = headers.find('\n', pos);
+            if (end == std::string::npos)
+                end = headers.size();
+            const std::string_view line(headers.data() + pos, end - pos);
+            pos = end + 1;
+            if (line.size() <= name.size() || line[name.size()] != ':')
+                continue;
+            if (!std::ranges::equal(line.substr(0, name.size()), name, [](const char a, const char b) { return tolower(a) == tolower(b); }))
+                continue;
+            auto value = line.substr(name.size() + 1);
+            while (!value.empty() && (value.front() == ' ' || value.front() == '\t'))
+                value.remove_prefix(1);
+            while (!value.empty() && (value.back() == '\r' || value.back() == ' '))
+                value.remove_suffix(1);
+            found = value;
+        }
+        return found;
+    }
+
+    bool ReadBody(const Entry& entry, std::string& body)
+    {
+        std::ifstream file(CacheFolder() / entry.file, std::ios::binary);
+        if (!file.is_open())
+            return false;
+        body.resize(entry.size);
+        return file.read(body.data(), static_cast<std::streamsize>(body.size())) && file.gcount() == static_cast<std::streamsize>(entry.size);
+    }
+
+    bool WriteBody(const Entry& entry, const std::string& body)
+    {
+        std::ofstream file(CacheFolder() / entry.file, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+        return static_cast<bool>(file.write(body.data(), static_cast<std::streamsize>(body.size())));
+    }
+
+    void RememberInMemory(const std::string& url, const std::string& body)
+    {
+        if (const auto found = memory_by_url.find(url); found != memory_by_url.end()) {
+            memory_bytes -= found->second->second.size();
+            memory_lru.erase(found->second);
+            memory_by_url.erase(found);
+        }
+        if (body.size() > memory_cache_max_entry_bytes)
+            return;
+        memory_lru.emplace_front(url, body);
+        memory_by_url[url] = memory_lru.begin();
+        memory_bytes += body.size();
+        while (memory_bytes > memory_cache_max_bytes) {
+            const auto& [lru_url, lru_body] = memory_lru.back();
+            memory_bytes -= lru_body.size();
+            memory_by_url.erase(lru_url);
+            memory_lru.pop_back();
+        }
+    }
+
+    bool RecallFromMemory(const std::string& url, std::string& body)
+    {
+        const auto found = memory_by_url.find(url);
+        if (found == memory_by_url.end())
+            return false;
+        memory_lru.splice(memory_lru.begin(), memory_lru, found->second);
+        body = found->second->second;
+        return true;
+    }
+
+    void ForgetInMemory(const std::string& url)
+    {
+        if (const auto found = memory_by_url.find(url); found != memory_by_url.end()) {
+            memory_bytes -= found->second->second.size();
+            memory_lru.erase(found->second);
+            memory_by_url.erase(found);
+        }
+    }
+
+    // Call with cache_mutex held; the json is written by WriteIndex once the lock is released
+    nlohmann::json SerializeIndex()
+    {
+        nlohmann::json json = nlohmann::json::array();
+        for (const auto& [url, entry] : entries) {
+            json.push_back({
+                {"url", url},
+                {"file", entry.file},
+                {"etag", entry.etag},
+                {"last_modified", entry.last_modified},
+                {"expires", entry.expires},
+                {"last_used", entry.last_used},
+                {"size", entry.size}
+            });
+        }
+        return json;
+    }
+
+    bool WriteIndex(const nlohmann::json& json)
+    {
+        auto tmp_file = IndexPath();
+        tmp_file += ".tmp";
+        {
+            std::ofstream file(tmp_file, std::ios::trunc);
+            if (!file.is_open())
+                return false;
+            file << json.dump();
+            if (!file)
+                return false;
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmp_file, IndexPath(), ec);
+        return !ec;
+    }
+
+    void LoadIndex()
+    {
+        if (index_loaded)
+            return;
+        index_loaded = true;
+        std::error_code ec;
+        std::filesystem::create_directories(CacheFolder(), ec);
+
+        std::ifstream file(IndexPath());
+        if (!file.is_open())
+            return;
+        const auto json = nlohmann::json::parse(file, nullptr, false);
+        if (!json.is_array())
+            return;
+        for (const auto& item : json) {
+            if (!item.is_object())
+                continue;
+            Entry entry;
+            entry.file = item.value("file", "");
+            entry.etag = item.value("etag", "");
+            entry.last_modified = item.value("last_modified", "");
+            entry.expires = item.value("expires", static_cast<int64_t>(0));
+            entry.last_used = item.value("last_used", static_cast<int64_t>(0));
+            entry.size = item.value("size", static_cast<size_t>(0));
+            const auto url = item.value("url", "");
+            // Drop entries whose file went missing or was changed outside of toolbox
+            if (url.empty() || entry.file.empty() || std::filesystem::file_size(CacheFolder() / entry.file, ec) != entry.size || ec)
+                continue;
+            disk_bytes += entry.size;
+            entries.emplace(url, std::move(entry));
+        }
+    }
+
+    void RemoveEntry(const std::unordered_map<std::string, Entry>::iterator it)
+    {
+        std::error_code ec;
+        std::filesystem::remove(CacheFolder() / it->second.file, ec);
+        disk_bytes -= it->second.size;
+        ForgetInMemory(it->first);
+        entries.erase(it);
+    }
+
+    // Evicts least recently used entries until the cache fits its cap again
+    void EvictOverCap()
+    {
+        while (disk_bytes > disk_cache_max_bytes && !entries.empty()) {
+            const auto lru = std::ranges::min_element(entries, {}, [](const auto& pair) { return pair.second.last_used; });
+            RemoveEntry(lru);
+        }
+    }
+
+    // Body of a cached entry, from memory if possible. Drops the entry if its file can't be read.
+    bool GetBody(const std::string& url, std::unordered_map<std::string, Entry>::iterator it, std::string& body)
+    {
+        it->second.last_used = Now();
+        index_dirty = true;
+        if (RecallFromMemory(url, body))
+            return true;
+        if (!ReadBody(it->second, body)) {
+            RemoveEntry(it);
+            return false;
+        }
+        RememberInMemory(url, body);
+        return true;
+    }
+}
+
+namespace HttpCache {
+    bool GetFresh(const std::string& url, std::string& body)
+    {
+        std::lock_guard lock(cache_mutex);
+        LoadIndex();
+        const auto it = entries.find(url);
+        if (it == entries.end() || it->second.expires <= Now())
+            return false;
+        return GetBody(url, it, body);
+    }
+
+    bool GetStale(const std::string& url, std::string& body)
+    {
+        std::lock_guard lock(cache_mutex);
+        LoadIndex();
+        const auto it = entries.find(url);
+        if (it == entries.end())
+            return false;
+        return GetBody(url, it, body);
+    }
+
+    std::vector<std::string> GetValidators(const std::string& url)
+    {
+        std::lock_guard lock(cache_mutex);
+        LoadIndex();
+        std::vector<std::string> headers;
+        const auto it = entries.find(url);
+        if (it == entries.end())
+            return headers;
+        if (!it->second.etag.empty())
+            headers.push_back("If-None-Match: " + it->second.etag);
+        if (!it->second.last_modified.empty())
+            headers.push_back("If-Modified-Since: " + it->second.last_modified);
+        return headers;
+    }
+
+    bool Revalidate(const std::string& url, const std::chrono::seconds max_age, std::string& body)
+    {
+        std::lock_guard lock(cache_mutex);
+        LoadIndex();
+        const auto it = entries.find(url);
+        if (it == entries.end())
+            return false;
+        it->second.expires = Now() + max_age.count();
+        return GetBody(url, it, body);
+    }
+
+    void Store(const std::string& url, const std::string& body, const std::string& response_headers, const std::chrono::seconds max_age)
+    {
+        std::lock_guard lock(cache_mutex);
+        LoadIndex();
+        if (const auto it = entries.find(url); it != entries.end()) {
+            RemoveEntry(it);
+        }
+        Entry entry;
+        entry.file = FileNameForUrl(url);
+        entry.etag = FindHeader(response_headers, "ETag");
+        entry.last_modified = FindHeader(response_headers, "Last-Modified");
+        entry.expires = Now() + max_age.count();
+        entry.last_used = Now();
+        entry.size = body.size();
+        if (WriteBody(entry, body)) {
+            disk_bytes += entry.size;
+            entries.emplace(url, std::move(entry));
+            RememberInMemory(url, body);
+            EvictOverCap();
+        }
+        index_dirty = true;
+    }
+
+    void QueueFlush()
+    {
+        if (!index_dirty || flush_queued.exchange(true))
+            return;
+        Resources::EnqueueWorkerTask([] {
+            flush_queued = false;
+            Flush();
+        }, Resources::TaskPriority::Low);
+    }
+
+    void Flush()
+    {
+        std::lock_guard write_lock(index_write_mutex);
+        nlohmann::json json;
+        {
+            std::lock_guard lock(cache_mutex);
+            if (!index_loaded || !index_dirty.exchange(false))
+                return;
+            json = SerializeIndex();
+        }
+        if (!WriteIndex(json)) {
+            index_dirty = true; // Try again on the next flush
+        }
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+// On-disk cache for http responses, with a small in-memory tier for hot entries.
+// Entries are tracked in an index file (url, validators, expiry, size) under the toolbox cache folder,
+// and least recently used entries are evicted once the cache grows past its size cap. Thread safe.
+// Changes to the index are kept in memory until the next Flush, so a burst of responses doesn't rewrite it once per response.
+namespace HttpCache {
+    // Cached body for url if it hasn't expired yet
+    bool GetFresh(const std::string& url, std::string& body);
+    // Cached body for url regardless of expiry e.g. when the server can't be reached
+    bool GetStale(const std::string& url, std::string& body);
+    // Request headers to revalidate an expired entry (If-None-Match/If-Modified-Since); empty if there's nothing to revalidate
+    std::vector<std::string> GetValidators(const std::string& url);
+    // Call when the server answered a revalidation with 304 Not Modified; extends the entry by max_age and returns its body
+    bool Revalidate(const std::string& url, std::chrono::seconds max_age, std::string& body);
+    // Store a response body. response_headers are the raw headers received, used to pick up ETag and Last-Modified.
+    void Store(const std::string& url, const std::string& body, const std::string& response_headers, std::chrono::seconds max_age);
+    // Flushes the index on a low priority worker task if anything changed since the last flush
+    void QueueFlush();
+    // Writes the index now if anything changed since the last flush, e.g. on shutdown
+    void Flush();
+}
@@ -0,0 +1,161 @@
+#include "stdafx.h"
+
+#include <GWCA/Packets/StoC.h>
+
+#include <Utils/FrameProfiler.h>
+
+#include "PacketReplay.h"
+
+namespace {
+    struct ReplayCallback {
+        GW::HookEntry* entry;
+        int altitude;
+        GW::StoC::PacketCallback callback;
+    };
+
+    // Indexed by packet header, each sorted by altitude like GWCA does
+    std::vector<std::vector<ReplayCallback>> callbacks_by_header;
+
+    bool ReadUInt32(std::ifstream& file, uint32_t* value)
+    {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(value), sizeof(*value)));
+    }
+
+    // Reads every packet in the capture into one buffer, each as header + content and 4 byte aligned. Returns offsets of each packet.
+    bool LoadCapture(const std::filesystem::path& path, std::vector<uint8_t>& packets, std::vector<size_t>& offsets)
+    {
+        std::ifstream file(path, std::ios::binary);
+        uint32_t magic = 0, version = 0, handler_count = 0;
+        if (!(ReadUInt32(file, &magic) && ReadUInt32(file, &version) && ReadUInt32(file, &handler_count))
+            || magic != PacketReplay::capture_magic || version != PacketReplay::capture_version) {
+            return false;
+        }
+        for (uint32_t i = 0; i < handler_count; i++) {
+            uint32_t field_count = 0;
+            if (!ReadUInt32(file, &field_count)) {
+                return false;
+            }
+            file.seekg(field_count * sizeof(uint32_t), std::ios::cur);
+        }
+        PacketReplay::CaptureRecord record;
+        while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            if (record.size > PacketReplay::capture_max_packet_size) {
+                break;
+            }
+            const size_t offset = packets.size();
+            // Zero padded; handlers may read a little past what the field table says the content is
+            packets.resize(offset + ((sizeof(uint32_t) + record.size + 0x40 + 3) & ~static_cast<size_t>(3)), 0);
+            memcpy(packets.data() + offset, &record.header, sizeof(record.header));
+            if (!file.read(reinterpret_cast<char*>(packets.data() + offset + sizeof(record.header)), record.size)) {
+                packets.resize(offset);
+                break;
+            }
+            offsets.push_back(offset);
+        }
+        return true;
+    }
+
+    // Same order GWCA runs them in: by altitude, post callbacks after everything else
+    void AddReplayCallback(GW::HookEntry* entry, const uint32_t header, const GW::StoC::PacketCallback& callback, const int altitude)
+    {
+        if (header >= callbacks_by_header.size()) {
+            callbacks_by_header.resize(header + 1);
+        }
+        auto& callbacks = callbacks_by_header[header];
+        const auto it = std::ranges::upper_bound(callbacks, altitude, {}, &ReplayCallback::altitude);
+        callbacks.insert(it, {entry, altitude, callback});
+    }
+
+#ifdef _DEBUG
+    std::atomic<size_t> allocation_count = 0;
+    _CRT_ALLOC_HOOK previous_alloc_hook = nullptr;
+    // The hook sees allocations from every thread; only the replaying thread's are counted
+    DWORD replay_thread_id = 0;
+
+    int __cdecl CountAllocations(const int alloc_type, void* user_data, const size_t size, const int block_type,
+                                 const long request_number, const unsigned char* file_name, const int line_number)
+    {
+        if ((alloc_type == _HOOK_ALLOC || alloc_type == _HOOK_REALLOC) && GetCurrentThreadId() == replay_thread_id) {
+            allocation_count++;
+        }
+        return previous_alloc_hook ? previous_alloc_hook(alloc_type, user_data, size, block_type, request_number, file_name, line_number) : TRUE;
+    }
+#endif
+}
+
+namespace PacketReplay {
+    bool RegisterPacketCallback(GW::HookEntry* entry, const uint32_t header, const GW::StoC::PacketCallback& callback, const int altitude)
+    {
+        if (!FrameProfiler::RegisterPacketCallback(entry, header, callback, altitude)) {
+            return false;
+        }
+        AddReplayCallback(entry, header, callback, altitude);
+        return true;
+    }
+
+    bool RegisterPostPacketCallback(GW::HookEntry* entry, const uint32_t header, const GW::StoC::PacketCallback& callback)
+    {
+        if (!FrameProfiler::RegisterPostPacketCallback(entry, header, callback)) {
+            return false;
+        }
+        AddReplayCallback(entry, header, callback, std::numeric_limits<int>::max());
+        return true;
+    }
+
+    size_t RemoveCallback(const uint32_t header, GW::HookEntry* entry)
+    {
+        if (header < callbacks_by_header.size()) {
+            std::erase_if(callbacks_by_header[header], [entry](const ReplayCallback& callback) {
+                return callback.entry == entry;
+            });
+        }
+        return GW::StoC::RemoveCallback(header, entry);
+    }
+
+    size_t RemoveCallbacks(GW::HookEntry* entry)
+    {
+        for (auto& callbacks : callbacks_by_header) {
+            std::erase_if(callbacks, [entry](const ReplayCallback& callback) {
+                return callback.entry == entry;
+            });
+        }
+        return GW::StoC::RemoveCallbacks(entry);
+    }
+
+    Result Replay(const std::filesystem::path& capture)
+    {
+        Result result;
+        std::vector<uint8_t> packets;
+        std::vector<size_t> offsets;
+        if (!LoadCapture(capture, packets, offsets)) {
+            return result;
+        }
+        result.loaded = true;
+        result.packets = offsets.size();
+
+#ifdef _DEBUG
+        allocation_count = 0;
+        replay_thread_id = GetCurrentThreadId();
+        previous_alloc_hook = _CrtSetAllocHook(CountAllocations);
+#endif
+        const auto started = std::chrono::steady_clock::now();
+        for (const auto offset : offsets) {
+            const auto packet = reinterpret_cast<GW::Packet::StoC::PacketBase*>(packets.data() + offset);
+            if (packet->header >= callbacks_by_header.size()) {
+                continue;
+            }
+            GW::HookStatus status;
+            for (const auto& callback : callbacks_by_header[packet->header]) {
+                status.altitude = static_cast<unsigned int>(callback.altitude);
+                callback.callback(&status, packet);
+                result.dispatched++;
+            }
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+#ifdef _DEBUG
+        _CrtSetAllocHook(previous_alloc_hook);
+        result.allocations = allocation_count;
+#endif
+        return result;
+    }
+}
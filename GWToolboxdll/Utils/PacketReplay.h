@@ -0,0 +1,55 @@
+#pragma once
+
+#include <GWCA/Utilities/Hook.h>
+#include <GWCA/Managers/StoCMgr.h>
+
+// Feeds packets recorded by the packet logger back through toolbox's own StoC callbacks, without passing them to the game.
+// Modules that want to be replayable register their StoC callbacks through here instead of GW::StoC;
+// they're registered with GWCA through FrameProfiler as before, and a copy is kept for replays.
+namespace PacketReplay {
+    // .gwpcap layout (little endian):
+    //   uint32 capture_magic, uint32 capture_version, uint32 handler count,
+    //   then for each handler: uint32 field count followed by that many uint32 field descriptors (same encoding as the game's StoC handler fields),
+    //   then until end of file: CaptureRecord followed by CaptureRecord::size bytes of packet content, i.e. the packet without its header.
+    constexpr uint32_t capture_magic = 0x43505747; // "GWPC"
+    constexpr uint32_t capture_version = 1;
+    constexpr size_t capture_max_packet_size = 0x4000;
+
+#pragma pack(push, 1)
+    struct CaptureRecord {
+        uint32_t header;
+        uint32_t size;
+        uint64_t time_us; // Since the capture started
+    };
+#pragma pack(pop)
+    static_assert(sizeof(CaptureRecord) == 16);
+
+    bool RegisterPacketCallback(GW::HookEntry* entry, uint32_t header, const GW::StoC::PacketCallback& callback, int altitude = -0x8000);
+
+    template <typename T>
+    bool RegisterPacketCallback(GW::HookEntry* entry, const GW::HookCallback<T*>& handler, int altitude = -0x8000)
+    {
+        return RegisterPacketCallback(entry, GW::Packet::StoC::Packet<T>::STATIC_HEADER,
+                                      [handler](GW::HookStatus* status, GW::Packet::StoC::PacketBase* packet) -> void {
+                                          handler(status, static_cast<T*>(packet));
+                                      }, altitude);
+    }
+
+    // Runs after the game has processed the packet, like GW::StoC::RegisterPostPacketCallback
+    bool RegisterPostPacketCallback(GW::HookEntry* entry, uint32_t header, const GW::StoC::PacketCallback& callback);
+
+    size_t RemoveCallback(uint32_t header, GW::HookEntry* entry);
+    size_t RemoveCallbacks(GW::HookEntry* entry);
+
+    struct Result {
+        bool loaded = false;
+        size_t packets = 0;     // Packets read from the capture
+        size_t dispatched = 0;  // Callbacks invoked
+        double seconds = 0.0;   // Time spent dispatching, excluding reading the file
+        size_t allocations = 0; // Heap allocations made by the replaying thread while dispatching; debug builds only
+    };
+
+    // Replays every packet in the capture as fast as possible, in recorded order. Call from the game thread.
+    // Callbacks still read live game state (agents, map), so replay in an explorable area for meaningful stats.
+    Result Replay(const std::filesystem::path& capture);
+}
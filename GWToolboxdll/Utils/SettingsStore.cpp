@@ -0,0 +1,210 @@
+#include "stdafx.h"
+
+#include <Modules/Resources.h>
+#include "SettingsStore.h"
+
+namespace {
+    // FNV-1a; null and empty strings hash differently, and each string is terminated so "ab","c" != "a","bc"
+    uint64_t Hash(uint64_t hash, const char* str)
+    {
+        constexpr uint64_t prime = 0x100000001b3ull;
+        if (!str) {
+            return (hash ^ 0xff) * prime;
+        }
+        for (; *str; str++) {
+            hash = (hash ^ static_cast<uint8_t>(*str)) * prime;
+        }
+        return hash * prime;
+    }
+
+    constexpr uint64_t hash_seed = 0xcbf29ce484222325ull;
+
+    // Comments are kept with their leading ';' and may span several lines
+    void AppendComment(std::string& out, const std::string& comment)
+    {
+        size_t start = 0;
+        while (start < comment.size()) {
+            auto end = comment.find('\n', start);
+            if (end == std::string::npos) {
+                end = comment.size();
+            }
+            auto line = std::string_view(comment).substr(start, end - start);
+            if (line.ends_with('\r')) {
+                line.remove_suffix(1);
+            }
+            out += line;
+            out += SI_NEWLINE_A;
+            start = end + 1;
+        }
+    }
+}
+
+SettingsStore::Result SettingsStore::Save(const ToolboxIni* ini, const std::filesystem::path& path, const bool async)
+{
+    ToolboxIni::TNamesDepend sections;
+    ini->GetAllSections(sections);
+    sections.sort(ToolboxIni::Entry::LoadOrder());
+    // Keys outside of any section are written first regardless of load order, same as CSimpleIni::Save
+    const auto global = std::ranges::find_if(sections, [](const ToolboxIni::Entry& section) {
+        return !*section.pItem;
+    });
+    if (global != sections.end()) {
+        sections.splice(sections.begin(), sections, global);
+    }
+
+    Snapshot snapshot;
+    uint64_t new_layout_hash = hash_seed;
+    for (const auto& section : sections) {
+        const auto keys = ini->GetSection(section.pItem);
+        uint64_t hash = Hash(hash_seed, section.pComment);
+        if (keys) {
+            for (const auto& [key, value] : *keys) {
+                hash = Hash(Hash(Hash(hash, key.pItem), value), key.pComment);
+            }
+        }
+        new_layout_hash = Hash(new_layout_hash, section.pItem);
+
+        const auto found = section_hashes.find(section.pItem);
+        if (found != section_hashes.end() && found->second == hash) {
+            continue;
+        }
+        section_hashes.insert_or_assign(section.pItem, hash);
+
+        // Copied here so the ini can keep changing while the worker formats it
+        SectionSnapshot copy;
+        if (section.pComment) {
+            copy.comment = section.pComment;
+        }
+        if (keys) {
+            copy.entries.reserve(keys->size());
+            std::vector<std::pair<int, const ToolboxIni::TKeyVal::value_type*>> ordered;
+            ordered.reserve(keys->size());
+            for (const auto& key_value : *keys) {
+                ordered.emplace_back(key_value.first.nOrder, &key_value);
+            }
+            std::ranges::stable_sort(ordered, {}, &decltype(ordered)::value_type::first);
+            for (const auto& order_key_value : ordered) {
+                const auto& [key, value] = *order_key_value.second;
+                copy.entries.emplace_back(key.pItem, value ? value : "", key.pComment ? key.pComment : "");
+            }
+        }
+        snapshot.changed_sections.emplace(section.pItem, std::move(copy));
+    }
+
+    const bool layout_changed = new_layout_hash != layout_hash;
+    const bool retry = write_failed.exchange(false);
+    if (snapshot.changed_sections.empty() && !layout_changed && !retry && path == last_path) {
+        return Result::Unchanged;
+    }
+    layout_hash = new_layout_hash;
+    last_path = path;
+
+    snapshot.path = path;
+    snapshot.spaces = ini->UsingSpaces();
+    snapshot.section_order.reserve(sections.size());
+    for (const auto& section : sections) {
+        snapshot.section_order.emplace_back(section.pItem);
+    }
+    if (layout_changed) {
+        const std::unordered_set<std::string_view> present(snapshot.section_order.begin(), snapshot.section_order.end());
+        std::erase_if(section_hashes, [&present](const auto& section_hash) {
+            return !present.contains(section_hash.first);
+        });
+    }
+
+    bool worker_queued = false;
+    {
+        std::lock_guard lock(pending_mutex);
+        if (pending) {
+            // Not picked up yet; keep the sections that only changed in the older snapshot
+            snapshot.changed_sections.merge(pending->changed_sections);
+            worker_queued = async;
+        }
+        pending = std::move(snapshot);
+    }
+    if (!async) {
+        return WritePending() ? Result::Written : Result::Failed;
+    }
+    if (!worker_queued) {
+        Resources::EnqueueWorkerTask([this] {
+            WritePending();
+        });
+    }
+    return Result::Queued;
+}
+
+bool SettingsStore::WritePending()
+{
+    std::lock_guard write_lock(write_mutex);
+    std::optional<Snapshot> snapshot;
+    {
+        std::lock_guard lock(pending_mutex);
+        snapshot.swap(pending);
+    }
+    if (!snapshot) {
+        return true; // Already written along with a later save
+    }
+
+    const char* separator = snapshot->spaces ? " = " : "=";
+    for (const auto& [name, section] : snapshot->changed_sections) {
+        std::string text;
+        if (!section.comment.empty()) {
+            AppendComment(text, section.comment);
+        }
+        if (!name.empty()) {
+            text += '[';
+            text += name;
+            text += ']';
+            text += SI_NEWLINE_A;
+        }
+        for (const auto& entry : section.entries) {
+            if (!entry.comment.empty()) {
+                text += SI_NEWLINE_A;
+                AppendComment(text, entry.comment);
+            }
+            text += entry.key;
+            text += separator;
+            text += entry.value;
+            text += SI_NEWLINE_A;
+        }
+        section_text.insert_or_assign(name, std::move(text));
+    }
+    // Every section in the order was formatted by this or an earlier snapshot, so any extra entries are sections that were removed
+    if (section_text.size() != snapshot->section_order.size()) {
+        const std::unordered_set<std::string_view> present(snapshot->section_order.begin(), snapshot->section_order.end());
+        std::erase_if(section_text, [&present](const auto& text) {
+            return !present.contains(text.first);
+        });
+    }
+
+    std::string file_text;
+    size_t file_size = 0;
+    for (const auto& name : snapshot->section_order) {
+        file_size += section_text[name].size() + 4;
+    }
+    file_text.reserve(file_size);
+    for (size_t i = 0; i < snapshot->section_order.size(); i++) {
+        if (i) {
+            file_text += SI_NEWLINE_A;
+            file_text += SI_NEWLINE_A;
+        }
+        file_text += section_text[snapshot->section_order[i]];
+    }
+    file_text += SI_NEWLINE_A;
+
+    auto tmp_file = snapshot->path;
+    tmp_file += ".tmp";
+    std::ofstream file(tmp_file, std::ios::binary | std::ios::trunc);
+    file.write(file_text.data(), static_cast<std::streamsize>(file_text.size()));
+    file.close();
+    std::error_code ec;
+    if (file) {
+        std::filesystem::rename(tmp_file, snapshot->path, ec);
+    }
+    if (!file || ec) {
+        Log::LogW(L"[SettingsStore] Failed to write %s", snapshot->path.wstring().c_str());
+        write_failed = true;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+
+// Writes a ToolboxIni to disk without blocking the caller.
+// Save copies the sections that changed since the last save; formatting the file and writing it (to a .tmp file, then renamed over the original) happen on a worker thread.
+// Sections are compared by a hash of their keys, values and comments, so a save where nothing changed doesn't touch the disk at all.
+class SettingsStore {
+public:
+    enum class Result {
+        Unchanged, // Nothing to write
+        Queued,    // Changes are being written on a worker thread
+        Written,   // Changes were written before returning
+        Failed
+    };
+
+    // Call from the thread that owns the ini. Pass async = false when the file has to be on disk before returning e.g. when unloading.
+    Result Save(const ToolboxIni* ini, const std::filesystem::path& path, bool async = true);
+
+private:
+    struct Entry {
+        std::string key;
+        std::string value;
+        std::string comment;
+    };
+
+    struct SectionSnapshot {
+        std::string comment;
+        std::vector<Entry> entries;
+    };
+
+    struct Snapshot {
+        std::filesystem::path path;
+        bool spaces = true;
+        std::vector<std::string> section_order;
+        std::unordered_map<std::string, SectionSnapshot> changed_sections;
+    };
+
+    // Formats and writes whatever is pending; runs on a worker, or the caller when saving synchronously
+    bool WritePending();
+
+    // Owned by the saving thread
+    std::unordered_map<std::string, uint64_t> section_hashes;
+    uint64_t layout_hash = 0;
+    std::filesystem::path last_path;
+
+    // Snapshots that haven't been written yet are merged into one, so a worker picking it up always writes the latest state
+    std::mutex pending_mutex;
+    std::optional<Snapshot> pending;
+
+    // Owned by whoever holds write_mutex; formatted text of every section in the last snapshot
+    std::mutex write_mutex;
+    std::unordered_map<std::string, std::string> section_text;
+
+    // Set by a failed write so the next save rewrites the file even if nothing changed
+    std::atomic<bool> write_failed = false;
+};
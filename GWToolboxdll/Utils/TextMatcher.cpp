@@ -0,0 +1,145 @@
+#include "stdafx.h"
+
+#include <Utils/TextUtils.h>
+#include "TextMatcher.h"
+
+void TextMatcher::Clear()
+{
+    m_edge_offsets.assign(2, 0);
+    m_edge_chars.clear();
+    m_edge_targets.clear();
+    m_root_ascii.fill(0);
+    m_fail.assign(1, 0);
+    m_accepting.assign(1, false);
+    m_word_offsets.assign(2, 0);
+    m_words.clear();
+    m_dict_link.assign(1, 0);
+    m_word_count = 0;
+}
+
+void TextMatcher::Build(const std::vector<std::wstring>& words)
+{
+    Clear();
+
+    // Trie of the folded words
+    std::vector<std::map<wchar_t, State>> trie(1);
+    std::vector<std::vector<uint32_t>> words_at(1);
+    for (size_t i = 0; i < words.size(); i++) {
+        if (words[i].empty()) {
+            continue;
+        }
+        State state = 0;
+        for (const auto c : words[i]) {
+            const auto folded = TextUtils::FoldChar(c);
+            const auto found = trie[state].find(folded);
+            if (found != trie[state].end()) {
+                state = found->second;
+                continue;
+            }
+            const auto next = static_cast<State>(trie.size());
+            trie[state].emplace(folded, next);
+            trie.emplace_back();
+            words_at.emplace_back();
+            state = next;
+        }
+        words_at[state].push_back(static_cast<uint32_t>(i));
+        m_word_count++;
+    }
+
+    const size_t state_count = trie.size();
+    m_edge_offsets.assign(state_count + 1, 0);
+    for (size_t state = 0; state < state_count; state++) {
+        m_edge_offsets[state + 1] = m_edge_offsets[state] + static_cast<uint32_t>(trie[state].size());
+        for (const auto& [c, next] : trie[state]) {
+            m_edge_chars.push_back(c);
+            m_edge_targets.push_back(next);
+        }
+    }
+    for (const auto& [c, next] : trie[0]) {
+        if (static_cast<size_t>(c) < m_root_ascii.size()) {
+            m_root_ascii[c] = next;
+        }
+    }
+
+    m_word_offsets.assign(state_count + 1, 0);
+    for (size_t state = 0; state < state_count; state++) {
+        m_word_offsets[state + 1] = m_word_offsets[state] + static_cast<uint32_t>(words_at[state].size());
+        m_words.insert(m_words.end(), words_at[state].begin(), words_at[state].end());
+    }
+
+    // Failure links, breadth first so a state's suffixes are done before it
+    m_fail.assign(state_count, 0);
+    m_accepting.assign(state_count, false);
+    m_dict_link.assign(state_count, 0);
+    std::queue<State> open;
+    for (const auto& next : trie[0] | std::views::values) {
+        m_accepting[next] = !words_at[next].empty();
+        open.push(next);
+    }
+    while (!open.empty()) {
+        const auto state = open.front();
+        open.pop();
+        for (const auto& [c, next] : trie[state]) {
+            const auto fail = Next(m_fail[state], c);
+            m_fail[next] = fail;
+            m_dict_link[next] = words_at[fail].empty() ? m_dict_link[fail] : fail;
+            m_accepting[next] = !words_at[next].empty() || m_accepting[fail];
+            open.push(next);
+        }
+    }
+}
+
+TextMatcher::State TextMatcher::Next(State state, const wchar_t c) const
+{
+    while (true) {
+        if (state == 0 && static_cast<size_t>(c) < m_root_ascii.size()) {
+            return m_root_ascii[c];
+        }
+        const auto begin = m_edge_chars.begin() + m_edge_offsets[state];
+        const auto end = m_edge_chars.begin() + m_edge_offsets[state + 1];
+        const auto found = std::lower_bound(begin, end, c);
+        if (found != end && *found == c) {
+            return m_edge_targets[found - m_edge_chars.begin()];
+        }
+        if (state == 0) {
+            return 0;
+        }
+        state = m_fail[state];
+    }
+}
+
+bool TextMatcher::Contains(const std::wstring_view text) const
+{
+    if (Empty()) {
+        return false;
+    }
+    State state = 0;
+    for (const auto c : text) {
+        state = Next(state, TextUtils::FoldChar(c));
+        if (m_accepting[state]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void TextMatcher::ForEachMatch(const std::wstring_view text, const std::function<bool(size_t word_index)>& fn) const
+{
+    if (Empty()) {
+        return;
+    }
+    State state = 0;
+    for (const auto c : text) {
+        state = Next(state, TextUtils::FoldChar(c));
+        if (!m_accepting[state]) {
+            continue;
+        }
+        for (auto match = state; match; match = m_dict_link[match]) {
+            for (auto i = m_word_offsets[match]; i < m_word_offsets[match + 1]; i++) {
+                if (!fn(m_words[i])) {
+                    return;
+                }
+            }
+        }
+    }
+}
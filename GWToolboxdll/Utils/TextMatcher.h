@@ -0,0 +1,41 @@
+#pragma once
+
+// Finds any of a set of words in a piece of text in a single pass (Aho-Corasick).
+// Words and text are compared after TextUtils::FoldChar, so matching ignores case and diacritics.
+// Build once when the word list changes; searching doesn't allocate.
+class TextMatcher {
+public:
+    void Build(const std::vector<std::wstring>& words);
+    void Clear();
+
+    [[nodiscard]] bool Empty() const { return m_word_count == 0; }
+    [[nodiscard]] size_t WordCount() const { return m_word_count; }
+
+    // True if any of the words occurs in text
+    [[nodiscard]] bool Contains(std::wstring_view text) const;
+    // Calls fn(word_index) for each occurrence of a word in text; return false from fn to stop searching
+    void ForEachMatch(std::wstring_view text, const std::function<bool(size_t word_index)>& fn) const;
+
+private:
+    using State = uint32_t;
+
+    [[nodiscard]] State Next(State state, wchar_t c) const;
+
+    // Transitions of each state, sorted by character: [m_edge_offsets[state], m_edge_offsets[state + 1])
+    std::vector<uint32_t> m_edge_offsets;
+    std::vector<wchar_t> m_edge_chars;
+    std::vector<State> m_edge_targets;
+    // Root transitions for ascii, the common case
+    std::array<State, 0x80> m_root_ascii{};
+
+    std::vector<State> m_fail;
+    // Whether a word ends at this state or any of its suffixes
+    std::vector<bool> m_accepting;
+    // Words ending exactly at each state: [m_word_offsets[state], m_word_offsets[state + 1])
+    std::vector<uint32_t> m_word_offsets;
+    std::vector<uint32_t> m_words;
+    // Nearest suffix state that has words of its own, or 0
+    std::vector<State> m_dict_link;
+
+    size_t m_word_count = 0;
+};
@@ -325,6 +325,30 @@ namespace TextUtils {
         return out;
     }
 
+    wchar_t FoldChar(const wchar_t c)
+    {
+        if (c < 0x80) {
+            return c >= 'A' && c <= 'Z' ? static_cast<wchar_t>(c + ('a' - 'A')) : c;
+        }
+        static const auto fold_table = [] {
+            std::vector<wchar_t> table(0x10000);
+            for (size_t i = 0; i < table.size(); i++) {
+                table[i] = static_cast<wchar_t>(i);
+            }
+            for (const auto group : diacritics) {
+                for (size_t j = 1; group[j]; j++) {
+                    table[static_cast<size_t>(group[j])] = group[0];
+                }
+            }
+            const auto locale = std::locale();
+            for (auto& wc : table) {
+                wc = std::tolower(wc, locale);
+            }
+            return table;
+        }();
+        return static_cast<size_t>(c) < fold_table.size() ? fold_table[static_cast<size_t>(c)] : c;
+    }
+
     std::string SanitizePlayerName(const std::string_view str) {
         return WStringToString(SanitizePlayerName(StringToWString(str)));
     }
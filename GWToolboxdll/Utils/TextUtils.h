@@ -19,6 +19,8 @@ namespace TextUtils {
     std::string ToLower(std::string s);
     std::wstring ToLower(std::wstring s);
     std::wstring RemoveDiacritics(std::wstring_view s);
+    // Lowercase without diacritics; per character version of ToLower(RemoveDiacritics(s)) for matching text without allocating
+    wchar_t FoldChar(wchar_t c);
 
     std::wstring SanitizePlayerName(const std::wstring_view str);
     std::string SanitizePlayerName(const std::string_view str);
@@ -1,6 +1,7 @@
 #pragma once
 #include <GWCA/Managers/UIMgr.h>
 #include <GWCA/Managers/StoCMgr.h>
+#include <Utils/FrameProfiler.h>
 
 class StoCCallback {
     GW::HookEntry* hook_entry = nullptr;
@@ -19,7 +20,7 @@ public:
     }
     void attach() {
         hook_entry = new GW::HookEntry;
-        GW::StoC::RegisterPacketCallback(hook_entry, header, callback, altitude);
+        FrameProfiler::RegisterPacketCallback(hook_entry, header, callback, altitude);
     }
     ~StoCCallback() {
         detach();
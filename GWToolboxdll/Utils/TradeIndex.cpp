@@ -0,0 +1,249 @@
+#include "stdafx.h"
+
+#include <charconv>
+
+#include "TradeIndex.h"
+
+namespace {
+    bool IsWordChar(const char c)
+    {
+        // Bytes of multibyte utf8 characters are kept as part of the word
+        return std::isalnum(static_cast<unsigned char>(c)) || static_cast<unsigned char>(c) >= 0x80;
+    }
+
+    // Calls fn(word) for each lowercase word in text
+    template <typename Fn>
+    void ForEachWord(const std::string_view text, std::string& word, Fn&& fn)
+    {
+        for (size_t i = 0; i < text.size();) {
+            while (i < text.size() && !IsWordChar(text[i])) {
+                i++;
+            }
+            word.clear();
+            while (i < text.size() && IsWordChar(text[i])) {
+                word.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(text[i]))));
+                i++;
+            }
+            if (!word.empty()) {
+                fn(word);
+            }
+        }
+    }
+
+    std::vector<std::string> MessageWords(const TradeIndex::Message& message)
+    {
+        std::vector<std::string> words;
+        std::string word;
+        const auto add = [&words](const std::string& w) { words.push_back(w); };
+        ForEachWord(message.name, word, add);
+        ForEachWord(message.message, word, add);
+        std::ranges::sort(words);
+        const auto [first, last] = std::ranges::unique(words);
+        words.erase(first, last);
+        return words;
+    }
+
+    // 64 bit FNV-1a; size_t is only 32 bits wide in this build, too narrow to tell 20k messages apart reliably
+    uint64_t HashMessage(const TradeIndex::Message& message)
+    {
+        uint64_t hash = 0xcbf29ce484222325;
+        const auto mix = [&hash](const void* data, const size_t len) {
+            const auto bytes = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < len; i++) {
+                hash = (hash ^ bytes[i]) * 0x100000001b3;
+            }
+        };
+        mix(&message.timestamp, sizeof(message.timestamp));
+        mix(message.name.data(), message.name.size());
+        mix("\t", 1);
+        mix(message.message.data(), message.message.size());
+        return hash;
+    }
+
+    std::string Sanitize(std::string text)
+    {
+        std::ranges::replace_if(text, [](const char c) { return c == '\t' || c == '\r' || c == '\n'; }, ' ');
+        return text;
+    }
+
+    bool WriteHistory(std::ofstream& file, const std::vector<TradeIndex::Message>& messages)
+    {
+        for (const auto& message : messages) {
+            file << message.timestamp << '\t' << Sanitize(message.name) << '\t' << Sanitize(message.message) << '\n';
+        }
+        return file.good();
+    }
+}
+
+TradeIndex::TradeIndex(const size_t max_messages)
+    : max_messages(max_messages) { }
+
+TradeIndex::Query TradeIndex::ParseQuery(const std::string_view text)
+{
+    Query query;
+    std::string word;
+    ForEachWord(text, word, [&query](const std::string& w) {
+        if (std::ranges::find(query, w) == query.end()) {
+            query.push_back(w);
+        }
+    });
+    return query;
+}
+
+bool TradeIndex::Matches(const Query& query, const Message& message)
+{
+    if (query.empty()) {
+        return true;
+    }
+    const auto words = MessageWords(message);
+    return std::ranges::all_of(query, [&words](const std::string& prefix) {
+        const auto found = std::ranges::lower_bound(words, prefix);
+        return found != words.end() && found->starts_with(prefix);
+    });
+}
+
+bool TradeIndex::IsOlder(const MessageId a, const MessageId b) const
+{
+    const auto ta = messages[a].timestamp;
+    const auto tb = messages[b].timestamp;
+    return ta != tb ? ta < tb : a < b;
+}
+
+void TradeIndex::Insert(Postings& postings, const MessageId id) const
+{
+    // Live messages arrive in order, so this is nearly always an append
+    if (postings.empty() || IsOlder(postings.back(), id)) {
+        postings.push_back(id);
+        return;
+    }
+    const auto it = std::upper_bound(postings.begin(), postings.end(), id, [this](const MessageId a, const MessageId b) {
+        return IsOlder(a, b);
+    });
+    postings.insert(it, id);
+}
+
+bool TradeIndex::Add(const Message& message)
+{
+    if (!message_hashes.insert(HashMessage(message)).second) {
+        return false;
+    }
+    const auto id = static_cast<MessageId>(messages.size());
+    messages.push_back(message);
+    Insert(by_time, id);
+    for (const auto& word : MessageWords(message)) {
+        Insert(postings_by_word[word], id);
+    }
+    if (messages.size() > max_messages) {
+        Compact();
+    }
+    return true;
+}
+
+void TradeIndex::Clear()
+{
+    messages.clear();
+    by_time.clear();
+    postings_by_word.clear();
+    message_hashes.clear();
+}
+
+void TradeIndex::Compact()
+{
+    std::vector<Message> kept;
+    kept.reserve(max_messages);
+    for (size_t i = by_time.size() / 4; i < by_time.size(); i++) {
+        kept.push_back(std::move(messages[by_time[i]]));
+    }
+    Clear();
+    for (const auto& message : kept) {
+        Add(message);
+    }
+}
+
+std::vector<const TradeIndex::Message*> TradeIndex::Search(const Query& query, const size_t max_results) const
+{
+    std::vector<const Message*> results;
+    const auto newest_first = [&](const Postings& postings) {
+        for (auto it = postings.rbegin(); it != postings.rend() && results.size() < max_results; ++it) {
+            results.push_back(&messages[*it]);
+        }
+    };
+    if (query.empty()) {
+        newest_first(by_time);
+        return results;
+    }
+
+    const auto older = [this](const MessageId a, const MessageId b) {
+        return IsOlder(a, b);
+    };
+    // Union of the posting lists of every word starting with prefix
+    const auto prefix_postings = [&](const std::string& prefix, Postings& out) {
+        out.clear();
+        size_t words = 0;
+        for (auto it = postings_by_word.lower_bound(prefix); it != postings_by_word.end() && it->first.starts_with(prefix); ++it, words++) {
+            out.insert(out.end(), it->second.begin(), it->second.end());
+        }
+        if (words < 2) {
+            return; // Already in order
+        }
+        std::ranges::sort(out, older);
+        // A message can contain several words with the same prefix
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    };
+
+    Postings matched;
+    Postings candidates;
+    Postings intersection;
+    prefix_postings(query[0], matched);
+    for (size_t i = 1; i < query.size() && !matched.empty(); i++) {
+        prefix_postings(query[i], candidates);
+        intersection.clear();
+        std::set_intersection(matched.begin(), matched.end(), candidates.begin(), candidates.end(), std::back_inserter(intersection), older);
+        matched.swap(intersection);
+    }
+    newest_first(matched);
+    return results;
+}
+
+std::vector<TradeIndex::Message> TradeIndex::LoadHistory(const std::filesystem::path& path, const size_t max_messages, size_t* line_count)
+{
+    std::deque<Message> loaded;
+    std::ifstream file(path);
+    std::string line;
+    size_t lines = 0;
+    while (std::getline(file, line)) {
+        lines++;
+        const auto name_start = line.find('\t');
+        const auto message_start = name_start == std::string::npos ? std::string::npos : line.find('\t', name_start + 1);
+        if (message_start == std::string::npos) {
+            continue;
+        }
+        Message message;
+        const auto parsed = std::from_chars(line.data(), line.data() + name_start, message.timestamp);
+        if (parsed.ec != std::errc() || !message.timestamp) {
+            continue;
+        }
+        message.name = line.substr(name_start + 1, message_start - name_start - 1);
+        message.message = line.substr(message_start + 1);
+        loaded.push_back(std::move(message));
+        if (loaded.size() > max_messages) {
+            loaded.pop_front();
+        }
+    }
+    if (line_count) {
+        *line_count = lines;
+    }
+    return {std::make_move_iterator(loaded.begin()), std::make_move_iterator(loaded.end())};
+}
+
+bool TradeIndex::AppendHistory(const std::filesystem::path& path, const std::vector<Message>& messages)
+{
+    std::ofstream file(path, std::ios::app);
+    return file.is_open() && WriteHistory(file, messages);
+}
+
+bool TradeIndex::SaveHistory(const std::filesystem::path& path, const std::vector<Message>& messages)
+{
+    std::ofstream file(path, std::ios::trunc);
+    return file.is_open() && WriteHistory(file, messages);
+}
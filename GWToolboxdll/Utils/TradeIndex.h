@@ -0,0 +1,50 @@
+#pragma once
+
+// Inverted index over trade chat messages, so trade searches can be answered locally while typing.
+// Messages are split into lowercase words (sender name included); a query matches a message when every query word is a prefix of one of its words.
+// Posting lists are kept oldest first, so the newest matches are at the back.
+class TradeIndex {
+public:
+    struct Message {
+        uint32_t timestamp = 0;
+        std::string name;
+        std::string message;
+    };
+
+    // Lowercase query words
+    using Query = std::vector<std::string>;
+
+    explicit TradeIndex(size_t max_messages = 20000);
+
+    [[nodiscard]] static Query ParseQuery(std::string_view text);
+    // Same test Search uses, for a single message that isn't (yet) indexed
+    [[nodiscard]] static bool Matches(const Query& query, const Message& message);
+
+    // Returns false if this message was already indexed
+    bool Add(const Message& message);
+    void Clear();
+    [[nodiscard]] size_t Size() const { return messages.size(); }
+
+    // Newest first; an empty query returns the latest messages. Pointers are valid until the next Add or Clear.
+    [[nodiscard]] std::vector<const Message*> Search(const Query& query, size_t max_results) const;
+
+    // One message per line: "<timestamp>\t<name>\t<message>". Returns the newest max_messages, oldest first; line_count gets the number of lines in the file.
+    [[nodiscard]] static std::vector<Message> LoadHistory(const std::filesystem::path& path, size_t max_messages, size_t* line_count = nullptr);
+    static bool AppendHistory(const std::filesystem::path& path, const std::vector<Message>& messages);
+    static bool SaveHistory(const std::filesystem::path& path, const std::vector<Message>& messages);
+
+private:
+    using MessageId = uint32_t;
+    using Postings = std::vector<MessageId>;
+
+    [[nodiscard]] bool IsOlder(MessageId a, MessageId b) const;
+    void Insert(Postings& postings, MessageId id) const;
+    // Drops the oldest quarter of the messages and reindexes the rest
+    void Compact();
+
+    size_t max_messages;
+    std::vector<Message> messages;
+    Postings by_time;
+    std::map<std::string, Postings, std::less<>> postings_by_word;
+    std::unordered_set<uint64_t> message_hashes;
+};
@@ -13,6 +13,7 @@
 #include <GWCA/Managers/StoCMgr.h>
 
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 #include <Widgets/AlcoholWidget.h>
 #include <Defines.h>
 
@@ -26,7 +27,7 @@ void AlcoholWidget::Initialize()
     // last time the player used a drink
     last_alcohol = 0;
     alcohol_level = 0;
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::PostProcess>(&PostProcess_Entry, &AlcoholWidget::AlcUpdate,-0x8000);
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::PostProcess>(&PostProcess_Entry, &AlcoholWidget::AlcUpdate,-0x8000);
 }
 
 uint32_t AlcoholWidget::GetAlcoholTitlePoints()
@@ -7,6 +7,7 @@
 #include <GWCA/Managers/StoCMgr.h>
 
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 #include <Defines.h>
 
 #include <Widgets/LatencyWidget.h>
@@ -57,7 +58,7 @@ void LatencyWidget::SendPing() {
 void LatencyWidget::Initialize()
 {
     ToolboxWidget::Initialize();
-    GW::StoC::RegisterPacketCallback(&Ping_Entry, GAME_SMSG_PING_REPLY, OnServerPing, 0x800);
+    FrameProfiler::RegisterPacketCallback(&Ping_Entry, GAME_SMSG_PING_REPLY, OnServerPing, 0x800);
     GW::Chat::CreateCommand(&ChatCmd_HookEntry, L"ping", CmdPing);
 }
 void LatencyWidget::Terminate() {
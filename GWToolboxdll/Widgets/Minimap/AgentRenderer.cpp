@@ -19,6 +19,7 @@
 
 #include <Defines.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 
 #include <Modules/Resources.h>
 #include <Widgets/Minimap/AgentRenderer.h>
@@ -485,6 +486,19 @@ void AgentRenderer::DrawSettings()
         }
         ImGui::TreePop();
     }
+
+    if (ImGui::TreeNodeEx("Render Stats", ImGuiTreeNodeFlags_FramePadding | ImGuiTreeNodeFlags_SpanAvailWidth)) {
+        const auto to_us = [](const std::chrono::steady_clock::duration duration) {
+            return std::chrono::duration<double, std::micro>(duration).count();
+        };
+        ImGui::Text("Agents: %zu", render_stats.agents);
+        ImGui::Text("Drawn: %zu spirit ranges, %zu dead, %zu other, %zu custom, %zu marked, %zu players",
+                    render_stats.spirit_ranges, render_stats.dead, render_stats.other, render_stats.custom, render_stats.marked, render_stats.players);
+        ImGui::Text("Custom agent lookups: %zu", render_stats.custom_agents_cache_misses);
+        ImGui::Text("Vertices: %zu", render_stats.vertices);
+        ImGui::Text("Classify: %.1f us, draw: %.1f us", to_us(render_stats.classify_time), to_us(render_stats.draw_time));
+        ImGui::TreePop();
+    }
 }
 
 void AgentRenderer::Terminate()
@@ -495,6 +509,8 @@ void AgentRenderer::Terminate()
     }
     custom_agents.clear();
     custom_agents_map.clear();
+    custom_agents_cache.clear();
+    draw_lists.Clear();
     RemoveMarkedTarget();
     GW::Chat::DeleteCommand(&ChatCmd_HookEntry);
 }
@@ -578,7 +594,11 @@ AgentRenderer::AgentRenderer()
         if (max_shape_verts < shapes[shape].vertices.size()) {
             max_shape_verts = shapes[shape].vertices.size();
         }
+        for (const Shape_Vertex& vert : shapes[shape].vertices) {
+            batch.AddShapeVertex(static_cast<uint8_t>(shape), vert.x, vert.y, static_cast<uint8_t>(vert.modifier));
+        }
     }
+    batch.Reserve(0x200);
 }
 
 void AgentRenderer::OnUIMessage(GW::HookStatus*, const GW::UI::UIMessage msgid, void* wParam, void*)
@@ -633,7 +653,6 @@ void AgentRenderer::Initialize(IDirect3DDevice9* device)
     initialized = true;
     type = D3DPT_TRIANGLELIST;
     vertices_max = max_shape_verts * 0x200; // support for up to 512 agents, should be enough
-    vertices = nullptr;
     const HRESULT hr = device->CreateVertexBuffer(sizeof(D3DVertex) * vertices_max, 0,
                                                   D3DFVF_CUSTOMVERTEX, D3DPOOL_MANAGED, &buffer, nullptr);
     if (FAILED(hr)) {
@@ -648,44 +667,60 @@ void AgentRenderer::Initialize(IDirect3DDevice9* device)
     for (const auto message_id : hook_messages) {
         RegisterUIMessageCallback(&UIMsg_Entry, message_id, OnUIMessage);
     }
-    GW::StoC::RegisterPostPacketCallback<GW::Packet::StoC::AgentAdd>(&OnAgentAdded_HookEntry, OnAgentAdded);
+    FrameProfiler::RegisterPostPacketCallback<GW::Packet::StoC::AgentAdd>(&OnAgentAdded_HookEntry, OnAgentAdded);
 
     GW::Chat::CreateCommand(&ChatCmd_HookEntry, L"marktarget", CmdMarkTarget);
     GW::Chat::CreateCommand(&ChatCmd_HookEntry, L"clearmarktarget", CmdClearMarkTarget);
 }
 
-std::vector<const AgentRenderer::CustomAgent*>* AgentRenderer::GetCustomAgentsToDraw(const GW::Agent* agent)
+const std::vector<const AgentRenderer::CustomAgent*>* AgentRenderer::GetCustomAgentsToDraw(const GW::Agent* agent)
 {
     if (!agent) {
         return nullptr;
     }
     const auto agent_identifier = agent->GetIsLivingType() ? agent->GetAsAgentLiving()->player_number : (agent->GetIsGadgetType() ? agent->GetAsAgentGadget()->gadget_id : 0);
-    const auto it = custom_agents_map.find(agent_identifier);
-    if (it == custom_agents_map.end()) {
-        return nullptr;
-    }
-    static std::vector<const CustomAgent*> out;
-    out.clear();
-    for (const CustomAgent* ca : it->second) {
-        if (!ca->active) {
-            continue;
-        }
-        if (ca->mapId > 0 && ca->mapId != static_cast<DWORD>(GW::Map::GetMapID())) {
-            continue;
+    if (agent->agent_id >= custom_agents_cache.size()) {
+        custom_agents_cache.resize(agent->agent_id + 1);
+    }
+    auto& cached = custom_agents_cache[agent->agent_id];
+    if (cached.generation != custom_agents_generation || cached.type != agent->type || cached.identifier != agent_identifier) {
+        // Agent id was recycled, or custom agents or the map changed
+        render_stats.custom_agents_cache_misses++;
+        cached.generation = custom_agents_generation;
+        cached.type = agent->type;
+        cached.identifier = agent_identifier;
+        cached.custom_agents.clear();
+        const auto it = custom_agents_map.find(agent_identifier);
+        if (it != custom_agents_map.end()) {
+            for (const CustomAgent* ca : it->second) {
+                if (!ca->active) {
+                    continue;
+                }
+                if (ca->mapId > 0 && ca->mapId != static_cast<DWORD>(custom_agents_map_id)) {
+                    continue;
+                }
+                cached.custom_agents.push_back(ca);
+            }
+            std::ranges::sort(
+                cached.custom_agents,
+                [&](const CustomAgent* pA,
+                    const CustomAgent* pB) -> bool {
+                    return pA->index > pB->index;
+                });
         }
-        out.push_back(ca);
     }
-    if (out.empty()) {
-        return nullptr;
-    }
-    std::ranges::sort(
-        out,
-        [&](const CustomAgent* pA,
-            const CustomAgent* pB) -> bool {
-            return pA->index > pB->index;
-        });
-    return &out;
-};
+    return cached.custom_agents.empty() ? nullptr : &cached.custom_agents;
+}
+
+void AgentRenderer::DrawLists::Clear()
+{
+    spirit_ranges.clear();
+    dead.clear();
+    other.clear();
+    custom.clear();
+    marked.clear();
+    players.clear();
+}
 
 void AgentRenderer::Render(IDirect3DDevice9* device)
 {
@@ -694,11 +729,9 @@ void AgentRenderer::Render(IDirect3DDevice9* device)
         initialized = true;
     }
 
-    const HRESULT res = buffer->Lock(0, sizeof(D3DVertex) * vertices_max, (VOID**)&vertices, D3DLOCK_DISCARD);
-    if (FAILED(res)) {
-        printf("AgentRenderer Lock() HRESULT: 0x%lX\n", res);
-    }
-
+    const auto frame_started = std::chrono::steady_clock::now();
+    render_stats = {};
+    batch.Clear();
     vertices_count = 0;
 
     if (show_props_on_minimap) {
@@ -715,6 +748,7 @@ void AgentRenderer::Render(IDirect3DDevice9* device)
     }
 
     const GW::AgentLiving* player = GW::Agents::GetControlledCharacter();
+    const GW::Agent* observing = GW::Agents::GetObservingAgent();
     const GW::Agent* target = GW::Agents::GetTarget();
     if (target) {
         auto_target_id = 0;
@@ -724,98 +758,40 @@ void AgentRenderer::Render(IDirect3DDevice9* device)
         target = target_ ? target_->GetAsAgentLiving() : nullptr;
     }
 
-    // 1. eoes
-    for (GW::Agent* agent_ptr : *agents) {
-        if (!agent_ptr) {
-            continue;
-        }
-        const GW::AgentLiving* agent = agent_ptr->GetAsAgentLiving();
-        if (!agent) {
-            continue;
-        }
-        if (agent->GetIsDead()) {
-            continue;
-        }
-        switch (agent->player_number) {
-            case GW::Constants::ModelID::EoE:
-                Enqueue(BigCircle, agent, GW::Constants::Range::Spirit, color_eoe);
-                break;
-            case GW::Constants::ModelID::QZ:
-                Enqueue(BigCircle, agent, GW::Constants::Range::Spirit, color_qz);
-                break;
-            case GW::Constants::ModelID::Winnowing:
-                Enqueue(BigCircle, agent, GW::Constants::Range::Spirit, color_winnowing);
-                break;
-            default:
-                break;
-        }
+    const auto map_id = GW::Map::GetMapID();
+    if (map_id != custom_agents_map_id) {
+        custom_agents_map_id = map_id;
+        custom_agents_generation++;
     }
-    // 2. non-player agents
-    static std::vector<std::pair<const GW::Agent*, const CustomAgent*>> custom_agents_to_draw;
-    custom_agents_to_draw.clear();
-
-    static std::vector<const GW::AgentLiving*> marked_targets_to_draw;
-    marked_targets_to_draw.clear();
-    static std::vector<const GW::AgentLiving*> players_to_draw;
-    players_to_draw.clear();
-    static std::vector<const GW::AgentLiving*> dead_agents_to_draw;
-    dead_agents_to_draw.clear();
-    static std::vector<const GW::Agent*> other_agents_to_draw;
-    other_agents_to_draw.clear();
 
+    draw_lists.Clear();
     target_drawn = false;
 
-    // some helper lambads
-
-    const auto add_custom_agents_to_draw = [this](const GW::Agent* agent) -> bool {
-        const auto custom_agents_for_this_agent = GetCustomAgentsToDraw(agent);
-        if (!custom_agents_for_this_agent) {
-            return false;
-        }
-        for (auto ca : *custom_agents_for_this_agent) {
-            custom_agents_to_draw.push_back({agent, ca});
-        }
-        return true;
-    };
-
-    const auto add_marked_target = [](const GW::AgentLiving* agent) -> bool {
-        if (!GetMarkedTarget(agent ? agent->agent_id : 0)) {
-            return false;
-        }
-        marked_targets_to_draw.push_back(agent);
-        return true;
-    };
-
-    const auto add_other_players_to_draw = [](const GW::AgentLiving* agent) -> bool {
-        if (!agent || !agent->IsPlayer() || agent == GW::Agents::GetObservingAgent()) {
-            return false;
-        }
-        players_to_draw.push_back(agent);
-        return true;
-    };
-
-    const auto add_dead_agent_to_draw = [](const GW::AgentLiving* agent) -> bool {
-        if (!agent || !agent->GetIsDead()) {
-            return false;
-        }
-        dead_agents_to_draw.push_back(agent);
-        return true;
-    };
-
-    auto sort_custom_agents_to_draw = [] {
-        std::ranges::sort(
-            custom_agents_to_draw,
-            [&](const std::pair<const GW::Agent*, const CustomAgent*>& pA,
-                const std::pair<const GW::Agent*, const CustomAgent*>& pB) {
-                return pA.second->index > pB.second->index;
-            });
-    };
-
-    // Sort through all agents, fill out arrays
+    // Sort through all agents once, fill out draw lists
     for (const auto agent : *agents) {
         if (!agent) {
             continue;
         }
+        render_stats.agents++;
+        const auto living = agent->GetAsAgentLiving();
+
+        // 1. eoes, including the player and target
+        if (living && !living->GetIsDead()) {
+            switch (living->player_number) {
+                case GW::Constants::ModelID::EoE:
+                    draw_lists.spirit_ranges.emplace_back(living, color_eoe);
+                    break;
+                case GW::Constants::ModelID::QZ:
+                    draw_lists.spirit_ranges.emplace_back(living, color_qz);
+                    break;
+                case GW::Constants::ModelID::Winnowing:
+                    draw_lists.spirit_ranges.emplace_back(living, color_winnowing);
+                    break;
+                default:
+                    break;
+            }
+        }
+
         if (agent == player) {
             continue; //  7. player
         }
@@ -824,50 +800,79 @@ void AgentRenderer::Render(IDirect3DDevice9* device)
         }
         if (agent->GetIsGadgetType()) {
             const auto gadget = agent->GetAsAgentGadget();
-            if (GW::Map::GetMapID() == GW::Constants::MapID::Domain_of_Anguish && gadget->extra_type == 7602) {
+            if (map_id == GW::Constants::MapID::Domain_of_Anguish && gadget->extra_type == 7602) {
                 continue;
             }
-            add_custom_agents_to_draw(gadget);
+            // Gadgets are drawn as custom agents and as generic agents
+            if (const auto custom_agents_for_this_agent = GetCustomAgentsToDraw(gadget)) {
+                for (const auto ca : *custom_agents_for_this_agent) {
+                    draw_lists.custom.emplace_back(gadget, ca);
+                }
+            }
         }
-        else if (agent->GetIsLivingType()) {
-            const auto living = agent->GetAsAgentLiving();
+        else if (living) {
             if (!show_hidden_npcs && !GW::Agents::GetIsAgentTargettable(living)) {
                 continue;
             }
-            if (add_marked_target(living)) {
+            if (GetMarkedTarget(living->agent_id)) {
+                draw_lists.marked.push_back(living);
                 continue; // 8. marked targets
             }
-            if (add_other_players_to_draw(living)) {
+            if (living->IsPlayer() && living != observing) {
+                draw_lists.players.push_back(living);
                 continue; // 5. players
             }
-            if (add_dead_agent_to_draw(living)) {
+            if (living->GetIsDead()) {
+                draw_lists.dead.push_back(living);
                 continue;
             }
-            if (add_custom_agents_to_draw(living)) {
+            if (const auto custom_agents_for_this_agent = GetCustomAgentsToDraw(living)) {
+                for (const auto ca : *custom_agents_for_this_agent) {
+                    draw_lists.custom.emplace_back(living, ca);
+                }
                 continue; // 3. custom colored models
             }
         }
-        other_agents_to_draw.push_back(agent);
+        draw_lists.other.push_back(agent);
+    }
+    std::ranges::sort(
+        draw_lists.custom,
+        [&](const std::pair<const GW::Agent*, const CustomAgent*>& pA,
+            const std::pair<const GW::Agent*, const CustomAgent*>& pB) {
+            return pA.second->index > pB.second->index;
+        });
+
+    const auto classified = std::chrono::steady_clock::now();
+    render_stats.classify_time = classified - frame_started;
+    render_stats.spirit_ranges = draw_lists.spirit_ranges.size();
+    render_stats.dead = draw_lists.dead.size();
+    render_stats.other = draw_lists.other.size();
+    render_stats.custom = draw_lists.custom.size();
+    render_stats.marked = draw_lists.marked.size();
+    render_stats.players = draw_lists.players.size();
+
+    // 1. eoes
+    for (const auto& [agent, color] : draw_lists.spirit_ranges) {
+        Enqueue(BigCircle, agent, GW::Constants::Range::Spirit, color);
     }
 
     // Dead agents
-    for (const auto agent : dead_agents_to_draw) {
+    for (const auto agent : draw_lists.dead) {
         Enqueue(agent);
     }
 
     // 2. Generic agents
-    for (const auto agent : other_agents_to_draw) {
+    for (const auto agent : draw_lists.other) {
         Enqueue(agent);
     }
 
     // 3. custom colored models
-    sort_custom_agents_to_draw();
-    for (const auto& [fst, snd] : custom_agents_to_draw) {
+    for (const auto& [fst, snd] : draw_lists.custom) {
         Enqueue(fst, snd);
     }
 
     // 8. marked
-    for (const auto agent : marked_targets_to_draw) {
+    for (const auto agent : draw_lists.marked) {
         if (!agent->GetIsAlive()) {
             continue;
         }
@@ -895,7 +900,7 @@ void AgentRenderer::Render(IDirect3DDevice9* device)
     // note: we don't support custom agents for players
 
     // 5. players
-    for (const auto agent : players_to_draw) {
+    for (const auto agent : draw_lists.players) {
         Enqueue(agent);
     }
 
@@ -909,7 +914,20 @@ void AgentRenderer::Render(IDirect3DDevice9* device)
         Enqueue(player);
     }
 
+    if (batch.Size() == 0) {
+        render_stats.draw_time = std::chrono::steady_clock::now() - classified;
+        return;
+    }
+    D3DVertex* vertices = nullptr;
+    const HRESULT res = buffer->Lock(0, sizeof(D3DVertex) * vertices_max, (VOID**)&vertices, D3DLOCK_DISCARD);
+    if (FAILED(res)) {
+        printf("AgentRenderer Lock() HRESULT: 0x%lX\n", res);
+        return;
+    }
+    vertices_count = batch.Expand(vertices, vertices_max);
     buffer->Unlock();
+    render_stats.vertices = vertices_count;
+    render_stats.draw_time = std::chrono::steady_clock::now() - classified;
 
     if (vertices_count != 0) {
         device->SetStreamSource(0, buffer, 0, sizeof(D3DVertex));
@@ -1266,36 +1284,17 @@ void AgentRenderer::Enqueue(const Shape_e shape, const RenderPosition& pos, cons
     if ((color & IM_COL32_A_MASK) == 0) {
         return;
     }
-    const size_t num_v = shapes[shape].vertices.size();
-    ASSERT(vertices_count < vertices_max - num_v);
-
-    for (size_t i = 0; i < num_v; ++i) {
-        const Shape_Vertex& vert = shapes[shape].vertices[i];
-        const GW::Vec2f calc_pos = Rotate(vert, pos.rotation_cos, pos.rotation_sin) * size + pos.position;
-        switch (vert.modifier) {
-            case Dark:
-                vertices[i].color = Colors::Sub(color, modifier);
-                break;
-            case Light:
-                vertices[i].color = Colors::Add(color, modifier);
-                break;
-            case CircleCenter:
-                vertices[i].color = Colors::Sub(color, IM_COL32(0, 0, 0, 50));
-                break;
-            default:
-                vertices[i].color = color;
-                break;
-        }
-        vertices[i].z = 0.0f;
-        vertices[i].x = calc_pos.x;
-        vertices[i].y = calc_pos.y;
-    }
-    vertices += num_v;
-    vertices_count += num_v;
+    ShapeBatch::Palette palette;
+    palette[None] = color;
+    palette[Dark] = Colors::Sub(color, modifier);
+    palette[Light] = Colors::Add(color, modifier);
+    palette[CircleCenter] = Colors::Sub(color, IM_COL32(0, 0, 0, 50));
+    batch.Add(static_cast<uint8_t>(shape), pos.position.x, pos.position.y, pos.rotation_cos, pos.rotation_sin, size, palette);
 }
 
 void AgentRenderer::BuildCustomAgentsMap()
 {
+    custom_agents_generation++;
     custom_agents_map.clear();
     for (const CustomAgent* ca : custom_agents) {
         if (!custom_agents_map.contains(ca->modelId)) {
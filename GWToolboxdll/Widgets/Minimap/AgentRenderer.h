@@ -2,8 +2,10 @@
 
 #include <GWCA/Utilities/Hook.h>
 
+#include <GWCA/Constants/Maps.h>
 #include <GWCA/GameContainers/GamePos.h>
 
+#include <Widgets/Minimap/ShapeBatch.h>
 #include <Widgets/Minimap/VBuffer.h>
 
 namespace GW {
@@ -53,6 +55,7 @@ private:
 
     enum Shape_e { Tear, Circle, Quad, BigCircle, Star };
 
+    // Doubles as the index into the ShapeBatch palette of each agent
     enum Color_Modifier {
         None,
         // rgb 0,0,0
@@ -135,9 +138,51 @@ private:
     void Enqueue(Shape_e shape, const GW::MapProp* agent, float size, Color color);
     void Enqueue(Shape_e shape, const RenderPosition& pos, float size, Color color, Color modifier = 0);
 
-    std::vector<const CustomAgent*>* GetCustomAgentsToDraw(const GW::Agent* agent);
+    // Active custom agents for this agent on this map, highest index first; nullptr if none. Cached per agent id.
+    const std::vector<const CustomAgent*>* GetCustomAgentsToDraw(const GW::Agent* agent);
 
-    D3DVertex* vertices = nullptr;    // vertices array
+    struct CustomAgentsCache {
+        uint32_t type = 0;
+        uint32_t identifier = 0;
+        uint32_t generation = 0;
+        std::vector<const CustomAgent*> custom_agents;
+    };
+
+    std::vector<CustomAgentsCache> custom_agents_cache{}; // by agent id
+    uint32_t custom_agents_generation = 1;                // bumped to invalidate custom_agents_cache
+    GW::Constants::MapID custom_agents_map_id = GW::Constants::MapID::None;
+
+    // Agents to draw this frame, filled in one pass over the agent array and drawn in this order
+    struct DrawLists {
+        std::vector<std::pair<const GW::AgentLiving*, Color>> spirit_ranges;
+        std::vector<const GW::AgentLiving*> dead;
+        std::vector<const GW::Agent*> other;
+        std::vector<std::pair<const GW::Agent*, const CustomAgent*>> custom;
+        std::vector<const GW::AgentLiving*> marked;
+        std::vector<const GW::AgentLiving*> players;
+
+        void Clear();
+    };
+
+    DrawLists draw_lists;
+
+    struct RenderStats {
+        size_t agents = 0;
+        size_t spirit_ranges = 0;
+        size_t dead = 0;
+        size_t other = 0;
+        size_t custom = 0;
+        size_t marked = 0;
+        size_t players = 0;
+        size_t custom_agents_cache_misses = 0;
+        size_t vertices = 0;
+        std::chrono::steady_clock::duration classify_time{};
+        std::chrono::steady_clock::duration draw_time{};
+    };
+
+    RenderStats render_stats; // of the last frame
+
+    ShapeBatch batch;                 // shapes queued this frame, expanded into the vertex buffer at the end of Render
     unsigned int vertices_count = 0;  // count of vertices
     unsigned int vertices_max = 0;    // max number of vertices to draw in one call
     unsigned int max_shape_verts = 0; // max number of triangles in a single shape
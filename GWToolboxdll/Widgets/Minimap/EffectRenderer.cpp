@@ -13,6 +13,7 @@
 #include <Color.h>
 #include <Timer.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 #include <Widgets/Minimap/EffectRenderer.h>
 
 namespace {
@@ -314,7 +315,7 @@ void EffectRenderer::Initialize(IDirect3DDevice9* device)
     if (FAILED(hr)) {
         printf("Error setting up PingsLinesRenderer vertex buffer: HRESULT: 0x%lX\n", hr);
     }
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GameSrvTransfer>(&StoC_Hook, [&](GW::HookStatus*, GW::Packet::StoC::GameSrvTransfer*) {
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::GameSrvTransfer>(&StoC_Hook, [&](GW::HookStatus*, GW::Packet::StoC::GameSrvTransfer*) {
         need_to_clear_effects = true;
     });
 }
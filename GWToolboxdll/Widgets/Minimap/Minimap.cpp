@@ -36,6 +36,7 @@
 #include <ImGuiAddons.h>
 #include <Logger.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 
 #include "Minimap.h"
 #include <Defines.h>
@@ -681,10 +682,10 @@ void Minimap::Initialize()
     GW::UI::RegisterKeydownCallback(&Generic_HookEntry, OnKeydown);
     GW::UI::RegisterKeyupCallback(&Generic_HookEntry, OnKeyup);
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::AgentPinged>(&Generic_HookEntry, OnAgentPinged);
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::PlayEffect>(&Generic_HookEntry, OnPlayEffect);
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericValue>(&Generic_HookEntry, OnGenericValue);
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericValueTarget>(&Generic_HookEntry, OnGenericValueTarget);
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::AgentPinged>(&Generic_HookEntry, OnAgentPinged);
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::PlayEffect>(&Generic_HookEntry, OnPlayEffect);
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::GenericValue>(&Generic_HookEntry, OnGenericValue);
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::GenericValueTarget>(&Generic_HookEntry, OnGenericValueTarget);
     constexpr std::array hook_messages = {
         GW::UI::UIMessage::kMapChange,
         GW::UI::UIMessage::kMapLoaded,
@@ -1433,6 +1434,7 @@ void Minimap::Render(IDirect3DDevice9* device)
         instance.range_renderer.Invalidate();
         gwinch_scale = current_gwinch_scale;
     }
+    instance.pmap_renderer.SetPixelsPerUnit(gwinch_scale);
 
     const auto view = translate_char * rotate_char * scaleM * translationM;
     device->SetTransform(D3DTS_VIEW, reinterpret_cast<const D3DMATRIX*>(&view));
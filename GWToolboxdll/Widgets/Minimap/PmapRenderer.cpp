@@ -5,16 +5,256 @@
 
 #include <GWCA/Managers/MapMgr.h>
 
+#include <Modules/Resources.h>
 #include <Widgets/Minimap/D3DVertex.h>
 #include <Widgets/Minimap/PmapRenderer.h>
 
 #include <ImGuiAddons.h>
 
+namespace {
+    using Trapezoid = PmapRenderer::Trapezoid;
+    using Mesh = PmapRenderer::Mesh;
+
+    constexpr uint32_t mesh_cache_magic = 0x50414D50; // "PMAP"
+    constexpr uint32_t mesh_cache_version = 2;
+
+    // How far the middle of three points on a trapezoid side is from the line through the outer two, along x
+    float SideDeviation(const float x_top, const float y_top, const float x_mid, const float y_mid, const float x_bottom, const float y_bottom)
+    {
+        const float height = y_top - y_bottom;
+        if (height == 0.f) {
+            return std::abs(x_mid - x_top);
+        }
+        const float x_line = x_top + (x_bottom - x_top) * (y_top - y_mid) / height;
+        return std::abs(x_line - x_mid);
+    }
+
+    // A trapezoid being simplified, with the side vertices earlier vertical merges dropped.
+    // Every merge is checked against all of them, so the outline never strays more than the tolerance from the source pathing map.
+    struct Shape {
+        Trapezoid t;
+        std::vector<std::pair<float, float>> dropped_left; // x, y
+        std::vector<std::pair<float, float>> dropped_right;
+    };
+
+    bool SideFits(const float x_top, const float y_top, const float x_bottom, const float y_bottom,
+                  const std::vector<std::pair<float, float>>& dropped, const float tolerance)
+    {
+        return std::ranges::all_of(dropped, [&](const auto& vertex) {
+            return SideDeviation(x_top, y_top, vertex.first, vertex.second, x_bottom, y_bottom) <= tolerance;
+        });
+    }
+
+    void RemoveMerged(std::vector<Shape>& shapes, const std::vector<bool>& merged)
+    {
+        size_t kept = 0;
+        for (size_t i = 0; i < shapes.size(); i++) {
+            if (!merged[i]) {
+                if (kept != i) {
+                    shapes[kept] = std::move(shapes[i]);
+                }
+                kept++;
+            }
+        }
+        shapes.resize(kept);
+    }
+
+    using Edge = std::tuple<float, float, float>; // y, x left, x right
+
+    // Merges trapezoids stacked on top of each other, where the shared edge spans both and the merged sides stay within tolerance of every vertex they replace
+    bool MergeVertically(std::vector<Shape>& shapes, const float tolerance)
+    {
+        std::map<Edge, size_t> by_top_edge;
+        for (size_t i = 0; i < shapes.size(); i++) {
+            by_top_edge.emplace(Edge{shapes[i].t.yt, shapes[i].t.xtl, shapes[i].t.xtr}, i);
+        }
+        std::vector<bool> merged(shapes.size(), false);
+        std::vector<std::pair<float, float>> left, right;
+        bool any = false;
+        for (size_t i = 0; i < shapes.size(); i++) {
+            if (merged[i]) {
+                continue;
+            }
+            Shape& upper = shapes[i];
+            while (true) {
+                const auto found = by_top_edge.find(Edge{upper.t.yb, upper.t.xbl, upper.t.xbr});
+                if (found == by_top_edge.end() || found->second == i || merged[found->second]) {
+                    break;
+                }
+                Shape& lower = shapes[found->second];
+                left = upper.dropped_left;
+                left.emplace_back(upper.t.xbl, upper.t.yb);
+                left.insert(left.end(), lower.dropped_left.begin(), lower.dropped_left.end());
+                right = upper.dropped_right;
+                right.emplace_back(upper.t.xbr, upper.t.yb);
+                right.insert(right.end(), lower.dropped_right.begin(), lower.dropped_right.end());
+                if (!SideFits(upper.t.xtl, upper.t.yt, lower.t.xbl, lower.t.yb, left, tolerance)
+                    || !SideFits(upper.t.xtr, upper.t.yt, lower.t.xbr, lower.t.yb, right, tolerance)) {
+                    break;
+                }
+                merged[found->second] = true;
+                by_top_edge.erase(found);
+                upper.t.yb = lower.t.yb;
+                upper.t.xbl = lower.t.xbl;
+                upper.t.xbr = lower.t.xbr;
+                upper.dropped_left.swap(left);
+                upper.dropped_right.swap(right);
+                any = true;
+            }
+        }
+        RemoveMerged(shapes, merged);
+        return any;
+    }
+
+    // Merges trapezoids side by side with the same top and bottom, where one's right side is the other's left side
+    bool MergeHorizontally(std::vector<Shape>& shapes)
+    {
+        std::map<std::tuple<float, float, float, float>, size_t> by_left_side;
+        for (size_t i = 0; i < shapes.size(); i++) {
+            const Trapezoid& t = shapes[i].t;
+            by_left_side.emplace(std::tuple{t.yt, t.yb, t.xtl, t.xbl}, i);
+        }
+        std::vector<bool> merged(shapes.size(), false);
+        bool any = false;
+        for (size_t i = 0; i < shapes.size(); i++) {
+            if (merged[i]) {
+                continue;
+            }
+            Shape& left = shapes[i];
+            while (true) {
+                const auto found = by_left_side.find(std::tuple{left.t.yt, left.t.yb, left.t.xtr, left.t.xbr});
+                if (found == by_left_side.end() || found->second == i || merged[found->second]) {
+                    break;
+                }
+                Shape& right = shapes[found->second];
+                merged[found->second] = true;
+                by_left_side.erase(found);
+                left.t.xtr = right.t.xtr;
+                left.t.xbr = right.t.xbr;
+                left.dropped_right = std::move(right.dropped_right);
+                any = true;
+            }
+        }
+        RemoveMerged(shapes, merged);
+        return any;
+    }
+
+    // Planes are merged separately; trapezoids on different planes may overlap on the minimap
+    void SimplifyPlanes(const std::vector<std::vector<Trapezoid>>& planes, const float tolerance, std::vector<Trapezoid>& out)
+    {
+        std::vector<Shape> shapes;
+        for (const auto& plane : planes) {
+            shapes.clear();
+            for (const auto& t : plane) {
+                shapes.push_back({t, {}, {}});
+            }
+            for (auto pass = 0; pass < 4; pass++) {
+                const bool horizontal = MergeHorizontally(shapes);
+                const bool vertical = MergeVertically(shapes, tolerance);
+                if (!horizontal && !vertical) {
+                    break;
+                }
+            }
+            for (const auto& shape : shapes) {
+                out.push_back(shape.t);
+            }
+        }
+    }
+
+    std::shared_ptr<Mesh> BuildMesh(const std::vector<std::vector<Trapezoid>>& planes, const GW::Constants::MapID map_id, const uint32_t trapezoid_count)
+    {
+        auto mesh = std::make_shared<Mesh>();
+        mesh->map_id = map_id;
+        mesh->source_trapezoid_count = trapezoid_count;
+        for (size_t lod = 0; lod < PmapRenderer::lod_count; lod++) {
+            // Each level starts from the source trapezoids, so its error is measured against the real outline rather than the previous level
+            SimplifyPlanes(planes, std::max(PmapRenderer::lod_tolerance[lod], 0.01f), mesh->lods[lod]);
+        }
+        return mesh;
+    }
+
+    std::filesystem::path MeshCachePath(const GW::Constants::MapID map_id)
+    {
+        return Resources::GetPath(L"data", L"pmap") / std::format(L"{}.pmap", std::to_underlying(map_id));
+    }
+
+    bool ReadUInt32(std::ifstream& file, uint32_t* value)
+    {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(value), sizeof(*value)));
+    }
+
+    void WriteUInt32(std::ofstream& file, const uint32_t value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    std::shared_ptr<Mesh> LoadCachedMesh(const GW::Constants::MapID map_id, const uint32_t trapezoid_count)
+    {
+        std::ifstream file(MeshCachePath(map_id), std::ios::binary);
+        uint32_t magic = 0, version = 0, cached_map_id = 0, cached_trapezoid_count = 0;
+        if (!(ReadUInt32(file, &magic) && ReadUInt32(file, &version) && ReadUInt32(file, &cached_map_id) && ReadUInt32(file, &cached_trapezoid_count))
+            || magic != mesh_cache_magic || version != mesh_cache_version
+            || cached_map_id != std::to_underlying(map_id) || cached_trapezoid_count != trapezoid_count) {
+            return nullptr;
+        }
+        auto mesh = std::make_shared<Mesh>();
+        mesh->map_id = map_id;
+        mesh->source_trapezoid_count = trapezoid_count;
+        for (auto& trapezoids : mesh->lods) {
+            uint32_t count = 0;
+            if (!ReadUInt32(file, &count) || count > trapezoid_count) {
+                return nullptr;
+            }
+            trapezoids.resize(count);
+            if (!file.read(reinterpret_cast<char*>(trapezoids.data()), static_cast<std::streamsize>(count * sizeof(Trapezoid)))) {
+                return nullptr;
+            }
+        }
+        return mesh;
+    }
+
+    void SaveCachedMesh(const Mesh& mesh)
+    {
+        if (!(Resources::EnsureFolderExists(Resources::GetPath(L"data")) && Resources::EnsureFolderExists(Resources::GetPath(L"data", L"pmap")))) {
+            return;
+        }
+        std::ofstream file(MeshCachePath(mesh.map_id), std::ios::binary | std::ios::trunc);
+        WriteUInt32(file, mesh_cache_magic);
+        WriteUInt32(file, mesh_cache_version);
+        WriteUInt32(file, std::to_underlying(mesh.map_id));
+        WriteUInt32(file, mesh.source_trapezoid_count);
+        for (const auto& trapezoids : mesh.lods) {
+            WriteUInt32(file, static_cast<uint32_t>(trapezoids.size()));
+            file.write(reinterpret_cast<const char*>(trapezoids.data()), static_cast<std::streamsize>(trapezoids.size() * sizeof(Trapezoid)));
+        }
+    }
+
+    // Call from the render thread, the pathing map may be freed on map change
+    std::vector<std::vector<Trapezoid>> CopyPathingMap()
+    {
+        std::vector<std::vector<Trapezoid>> planes;
+        const GW::PathingMapArray* path_map = GW::Map::GetIsMapLoaded() ? GW::Map::GetPathingMap() : nullptr;
+        if (!path_map) {
+            return planes;
+        }
+        for (const GW::PathingMap& pmap : *path_map) {
+            auto& plane = planes.emplace_back();
+            plane.reserve(pmap.trapezoid_count);
+            for (size_t j = 0; j < pmap.trapezoid_count; ++j) {
+                const GW::PathingTrapezoid& trap = pmap.trapezoids[j];
+                plane.push_back({trap.YT, trap.YB, trap.XTL, trap.XTR, trap.XBL, trap.XBR});
+            }
+        }
+        return planes;
+    }
+}
+
 void PmapRenderer::LoadSettings(const ToolboxIni* ini, const char* section)
 {
     color_map = Colors::Load(ini, section, "color_map", 0xFF999999);
     color_mapshadow = Colors::Load(ini, section, "color_mapshadow", 0xFF120808);
     color_mapbackground = Colors::Load(ini, section, "color_mapbackground", 0x00000000);
+    level_of_detail = ini->GetBoolValue(section, "pmap_level_of_detail", level_of_detail);
     Invalidate();
 }
 
@@ -23,6 +263,7 @@ void PmapRenderer::SaveSettings(ToolboxIni* ini, const char* section) const
     Colors::Save(ini, section, "color_map", color_map);
     Colors::Save(ini, section, "color_mapshadow", color_mapshadow);
     Colors::Save(ini, section, "color_mapbackground", color_mapbackground);
+    ini->SetBoolValue(section, "pmap_level_of_detail", level_of_detail);
 }
 
 void PmapRenderer::DrawSettings()
@@ -44,12 +285,56 @@ void PmapRenderer::DrawSettings()
     if (Colors::DrawSettingHueWheel("Background", &color_mapbackground)) {
         Invalidate();
     }
+    ImGui::Checkbox("Simplify map when zoomed out", &level_of_detail);
+    ImGui::ShowHelp("Draw the map with fewer triangles when zoomed out far enough that the difference is less than a pixel");
 }
 
-void PmapRenderer::Initialize(IDirect3DDevice9* device)
+void PmapRenderer::SetPixelsPerUnit(const float pixels_per_unit)
 {
-    //#define WIREFRAME_MODE
+    lod = 0;
+    if (!level_of_detail) {
+        return;
+    }
+    // Coarsest level whose error is under a pixel
+    while (lod + 1 < lod_count && lod_tolerance[lod + 1] * pixels_per_unit < 1.f) {
+        lod++;
+    }
+}
 
+void PmapRenderer::RequestMesh(const GW::Constants::MapID map_id, const uint32_t trapezoid_count)
+{
+    if (requested_map_id == map_id) {
+        return;
+    }
+    requested_map_id = map_id;
+    Resources::EnqueueWorkerTask([this, map_id, trapezoid_count] {
+        if (auto cached = LoadCachedMesh(map_id, trapezoid_count)) {
+            Resources::EnqueueDxTask([this, cached = std::move(cached)](IDirect3DDevice9*) {
+                mesh = cached;
+                Invalidate();
+            });
+            return;
+        }
+        // Not cached; copy the pathing map on the render thread, then build from the copy
+        Resources::EnqueueDxTask([this, map_id, trapezoid_count](IDirect3DDevice9*) {
+            if (GW::Map::GetMapID() != map_id) {
+                requested_map_id = GW::Constants::MapID::None;
+                return;
+            }
+            Resources::EnqueueWorkerTask([this, map_id, trapezoid_count, planes = CopyPathingMap()] {
+                std::shared_ptr<const Mesh> built = BuildMesh(planes, map_id, trapezoid_count);
+                SaveCachedMesh(*built);
+                Resources::EnqueueDxTask([this, built = std::move(built)](IDirect3DDevice9*) {
+                    mesh = built;
+                    Invalidate();
+                });
+            });
+        });
+    });
+}
+
+void PmapRenderer::Initialize(IDirect3DDevice9* device)
+{
     GW::PathingMapArray* path_map;
     if (GW::Map::GetIsMapLoaded()) {
         path_map = GW::Map::GetPathingMap();
@@ -58,36 +343,31 @@ void PmapRenderer::Initialize(IDirect3DDevice9* device)
         initialized = false;
         return; // no map loaded yet, so don't render anything
     }
-    const bool shadow_show = (color_mapshadow & IM_COL32_A_MASK) > 0;
 
-    // get the number of trapezoids, need it to allocate the vertex buffer
-    trapez_count_ = 0;
+    // get the number of trapezoids, to check the mesh is for this map
+    uint32_t trapez_count = 0;
     for (const GW::PathingMap& map : *path_map) {
-        trapez_count_ += map.trapezoid_count;
+        trapez_count += map.trapezoid_count;
     }
-    if (trapez_count_ == 0) {
+    if (trapez_count == 0) {
         return;
     }
-
-#ifdef WIREFRAME_MODE
-
-    total_tri_count_ = tri_count_ = trapez_count_ * 4;
-    if (shadow_show) total_tri_count_ = tri_count_ * 2;
-
-    vert_count_ = tri_count_ * 2;
-    total_vert_count_ = total_tri_count_ * 2;
-
-#else
-
-    total_tri_count_ = tri_count_ = trapez_count_ * 2;
-    if (shadow_show) {
-        total_tri_count_ = tri_count_ * 2;
+    const auto map_id = GW::Map::GetMapID();
+    if (!mesh || mesh->map_id != map_id || mesh->source_trapezoid_count != trapez_count) {
+        RequestMesh(map_id, trapez_count);
+        initialized = false;
+        return; // not built yet, so don't render anything
+    }
+    requested_map_id = GW::Constants::MapID::None;
+
+    shadow_show_ = (color_mapshadow & IM_COL32_A_MASK) > 0;
+    const size_t copies = shadow_show_ ? 2 : 1;
+    total_vert_count_ = 0;
+    for (size_t i = 0; i < lod_count; i++) {
+        lod_tri_count_[i] = mesh->lods[i].size() * 2;
+        lod_first_vert_[i] = total_vert_count_;
+        total_vert_count_ += lod_tri_count_[i] * 3 * copies;
     }
-
-    vert_count_ = tri_count_ * 3;
-    total_vert_count_ = total_tri_count_ * 3;
-
-#endif
 
     D3DVertex* vertices = nullptr;
 
@@ -100,83 +380,52 @@ void PmapRenderer::Initialize(IDirect3DDevice9* device)
     buffer->Lock(0, sizeof(D3DVertex) * total_vert_count_,
                  reinterpret_cast<void**>(&vertices), D3DLOCK_DISCARD);
 
-    D3DVertex* vertices_begin = vertices;
-
-#ifdef WIREFRAME_MODE
-    type = D3DPT_LINELIST;
-
-    // populate vertex buffer
-    for (autok = 0; k < (shadow_show ? 2 : 1); ++k) {
-        for (size_t i = 0; i < path_map.size(); i++) {
-            GW::PathingMap pmap = path_map[i];
-            for (size_t j = 0; j < pmap.trapezoid_count; ++j) {
-                GW::PathingTrapezoid& trap = pmap.trapezoids[j];
-                vertices[0].x = trap.XTL; vertices[0].y = trap.YT;
-                vertices[1].x = trap.XTR; vertices[1].y = trap.YT;
-
-                vertices[2].x = trap.XTR; vertices[2].y = trap.YT;
-                vertices[3].x = trap.XBR; vertices[3].y = trap.YB;
-
-                vertices[4].x = trap.XBR; vertices[4].y = trap.YB;
-                vertices[5].x = trap.XBL; vertices[5].y = trap.YB;
-
-                vertices[6].x = trap.XBL; vertices[6].y = trap.YB;
-                vertices[7].x = trap.XTL; vertices[7].y = trap.YT;
-
-                vertices += 8;
-            }
-        }
-    }
-#else
     type = D3DPT_TRIANGLELIST;
 
     // populate vertex buffer
-    for (auto k = 0; k < (shadow_show ? 2 : 1); ++k) {
-        for (const GW::PathingMap& pmap : *path_map) {
-            for (size_t j = 0; j < pmap.trapezoid_count; ++j) {
-                GW::PathingTrapezoid& trap = pmap.trapezoids[j];
-
-                vertices[0].x = trap.XTL;
-                vertices[0].y = trap.YT;
-                vertices[1].x = trap.XTR;
-                vertices[1].y = trap.YT;
-                vertices[2].x = trap.XBL;
-                vertices[2].y = trap.YB;
-
-                vertices[3].x = trap.XBL;
-                vertices[3].y = trap.YB;
-                vertices[4].x = trap.XTR;
-                vertices[4].y = trap.YT;
-                vertices[5].x = trap.XBR;
-                vertices[5].y = trap.YB;
+    for (const auto& trapezoids : mesh->lods) {
+        for (size_t k = 0; k < copies; ++k) {
+            const Color color = shadow_show_ && k == 0 ? color_mapshadow : color_map;
+            for (const Trapezoid& trap : trapezoids) {
+                vertices[0] = {trap.xtl, trap.yt, 0.0f, color};
+                vertices[1] = {trap.xtr, trap.yt, 0.0f, color};
+                vertices[2] = {trap.xbl, trap.yb, 0.0f, color};
+
+                vertices[3] = {trap.xbl, trap.yb, 0.0f, color};
+                vertices[4] = {trap.xtr, trap.yt, 0.0f, color};
+                vertices[5] = {trap.xbr, trap.yb, 0.0f, color};
                 vertices += 6;
             }
         }
     }
-#endif
-
-    vertices = vertices_begin;
-    for (auto i = 0u; i < total_vert_count_; i++) {
-        vertices[i].z = 0.0f;
-        if (shadow_show && i < vert_count_) {
-            vertices[i].color = color_mapshadow;
-        }
-        else {
-            vertices[i].color = color_map;
-        }
-    }
 
     buffer->Unlock();
 }
 
+void PmapRenderer::Terminate()
+{
+    VBuffer::Terminate();
+    mesh = nullptr;
+    requested_map_id = GW::Constants::MapID::None;
+}
+
 void PmapRenderer::Render(IDirect3DDevice9* device)
 {
     if (!initialized) {
         initialized = true;
         Initialize(device);
     }
+    if (!initialized || !buffer) {
+        return;
+    }
+
+    const size_t first_vert = lod_first_vert_[lod];
+    const size_t tri_count = lod_tri_count_[lod];
+    if (tri_count == 0) {
+        return;
+    }
 
-    if ((color_mapshadow & IM_COL32_A_MASK) > 0) {
+    if (shadow_show_) {
         D3DMATRIX oldview;
         device->GetTransform(D3DTS_VIEW, &oldview);
         const auto oldMatrix = XMLoadFloat4x4(reinterpret_cast<const DirectX::XMFLOAT4X4*>(&oldview));
@@ -186,15 +435,15 @@ void PmapRenderer::Render(IDirect3DDevice9* device)
 
         device->SetFVF(D3DFVF_CUSTOMVERTEX);
         device->SetStreamSource(0, buffer, 0, sizeof(D3DVertex));
-        device->DrawPrimitive(type, 0, tri_count_);
+        device->DrawPrimitive(type, first_vert, tri_count);
 
         device->SetTransform(D3DTS_VIEW, &oldview);
 
-        device->DrawPrimitive(type, vert_count_, tri_count_);
+        device->DrawPrimitive(type, first_vert + tri_count * 3, tri_count);
     }
     else {
         device->SetFVF(D3DFVF_CUSTOMVERTEX);
         device->SetStreamSource(0, buffer, 0, sizeof(D3DVertex));
-        device->DrawPrimitive(type, 0, tri_count_);
+        device->DrawPrimitive(type, first_vert, tri_count);
     }
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <GWCA/Constants/Maps.h>
+
 #include <Color.h>
 #include <Widgets/Minimap/VBuffer.h>
 
@@ -8,23 +10,55 @@ public:
     // Triangle 1: (XTL, YT) (XTR, YT), (XBL, YB)
     // Triangle 2: (XBL, YB), (XTR, YT), (XBR, YB)
     void Render(IDirect3DDevice9* device) override;
+    void Terminate() override;
 
     void DrawSettings();
     void LoadSettings(const ToolboxIni* ini, const char* section);
     void SaveSettings(ToolboxIni* ini, const char* section) const;
     Color GetBackgroundColor() const { return color_mapbackground; }
 
+    // On screen size of one game unit; picks a coarser mesh when zoomed out
+    void SetPixelsPerUnit(float pixels_per_unit);
+
+    // Level 0 is the pathing map with trapezoids that share an edge merged where that doesn't change the outline.
+    // Higher levels also merge trapezoids whose outline moves by up to lod_tolerance[level] game units.
+    static constexpr size_t lod_count = 3;
+    static constexpr float lod_tolerance[lod_count] = {0.f, 20.f, 80.f};
+
+    struct Trapezoid {
+        float yt;
+        float yb;
+        float xtl;
+        float xtr;
+        float xbl;
+        float xbr;
+    };
+
+    struct Mesh {
+        GW::Constants::MapID map_id = GW::Constants::MapID::None;
+        uint32_t source_trapezoid_count = 0; // Trapezoids in the pathing map it was built from
+        std::array<std::vector<Trapezoid>, lod_count> lods;
+    };
+
 protected:
     void Initialize(IDirect3DDevice9* device) override;
 
 private:
+    // Loads the mesh from disk or builds it on a worker thread; Initialize picks it up once it's done
+    void RequestMesh(GW::Constants::MapID map_id, uint32_t trapezoid_count);
+
     Color color_map = 0;
     Color color_mapshadow = 0;
     Color color_mapbackground = 0;
+    bool level_of_detail = true;
+
+    std::shared_ptr<const Mesh> mesh;
+    GW::Constants::MapID requested_map_id = GW::Constants::MapID::None;
+    size_t lod = 0;
 
-    size_t trapez_count_ = 0;
-    size_t tri_count_ = 0;       // of just 1 batch (map)
-    size_t total_tri_count_ = 0; // including shadow
-    size_t vert_count_ = 0;
-    size_t total_vert_count_ = 0; // including shadow
+    // Per level of detail; the vertex buffer holds each level's shadow (if any) followed by its map triangles
+    std::array<size_t, lod_count> lod_first_vert_{};
+    std::array<size_t, lod_count> lod_tri_count_{}; // of just 1 batch (map)
+    bool shadow_show_ = false;
+    size_t total_vert_count_ = 0; // all levels, including shadow
 };
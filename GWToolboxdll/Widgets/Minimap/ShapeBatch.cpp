@@ -0,0 +1,121 @@
+#include "stdafx.h"
+
+#include <emmintrin.h>
+
+#include <Widgets/Minimap/ShapeBatch.h>
+
+namespace {
+    static_assert(sizeof(D3DVertex) == 4 * sizeof(float), "ExpandInstance writes a vertex as one 16 byte vector");
+
+    // x' = x * cos - y * sin, y' = x * sin + y * cos, scaled and translated; 4 vertices per iteration
+    size_t ExpandInstance(const float* vx, const float* vy, const uint8_t* palette_index, const size_t count,
+                          const float x, const float y, const float cos, const float sin, const float size,
+                          const D3DCOLOR* palette, D3DVertex* out)
+    {
+        const float a = cos * size;
+        const float b = sin * size;
+        const __m128 va = _mm_set1_ps(a);
+        const __m128 vb = _mm_set1_ps(b);
+        const __m128 px = _mm_set1_ps(x);
+        const __m128 py = _mm_set1_ps(y);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const __m128 sx = _mm_loadu_ps(vx + i);
+            const __m128 sy = _mm_loadu_ps(vy + i);
+            __m128 rx = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(sx, va), _mm_mul_ps(sy, vb)), px);
+            __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, vb), _mm_mul_ps(sy, va)), py);
+            __m128 rz = _mm_setzero_ps();
+            __m128 rc = _mm_castsi128_ps(_mm_set_epi32(
+                static_cast<int>(palette[palette_index[i + 3]]),
+                static_cast<int>(palette[palette_index[i + 2]]),
+                static_cast<int>(palette[palette_index[i + 1]]),
+                static_cast<int>(palette[palette_index[i]])));
+            // Columns (x, y, z, color) to rows, one vertex each
+            _MM_TRANSPOSE4_PS(rx, ry, rz, rc);
+            float* dst = reinterpret_cast<float*>(out + i);
+            _mm_storeu_ps(dst, rx);
+            _mm_storeu_ps(dst + 4, ry);
+            _mm_storeu_ps(dst + 8, rz);
+            _mm_storeu_ps(dst + 12, rc);
+        }
+        for (; i < count; i++) {
+            out[i].x = vx[i] * a - vy[i] * b + x;
+            out[i].y = vx[i] * b + vy[i] * a + y;
+            out[i].z = 0.0f;
+            out[i].color = palette[palette_index[i]];
+        }
+        return count;
+    }
+}
+
+void ShapeBatch::AddShapeVertex(const uint8_t shape, const float x, const float y, const uint8_t palette_index)
+{
+    ASSERT(palette_index < palette_size);
+    if (shape >= shapes.size()) {
+        shapes.resize(shape + 1);
+    }
+    shapes[shape].x.push_back(x);
+    shapes[shape].y.push_back(y);
+    shapes[shape].palette_index.push_back(palette_index);
+}
+
+size_t ShapeBatch::ShapeVertexCount(const uint8_t shape) const
+{
+    return shape < shapes.size() ? shapes[shape].x.size() : 0;
+}
+
+void ShapeBatch::Reserve(const size_t instances)
+{
+    shape_ids.reserve(instances);
+    pos_x.reserve(instances);
+    pos_y.reserve(instances);
+    rotation_cos.reserve(instances);
+    rotation_sin.reserve(instances);
+    sizes.reserve(instances);
+    palettes.reserve(instances);
+}
+
+void ShapeBatch::Clear()
+{
+    shape_ids.clear();
+    pos_x.clear();
+    pos_y.clear();
+    rotation_cos.clear();
+    rotation_sin.clear();
+    sizes.clear();
+    palettes.clear();
+    vertex_count = 0;
+}
+
+void ShapeBatch::Add(const uint8_t shape, const float x, const float y, const float cos, const float sin, const float size, const Palette& palette)
+{
+    const size_t shape_vertices = ShapeVertexCount(shape);
+    if (!shape_vertices) {
+        return;
+    }
+    shape_ids.push_back(shape);
+    pos_x.push_back(x);
+    pos_y.push_back(y);
+    rotation_cos.push_back(cos);
+    rotation_sin.push_back(sin);
+    sizes.push_back(size);
+    palettes.push_back(palette);
+    vertex_count += shape_vertices;
+}
+
+size_t ShapeBatch::Expand(D3DVertex* out, const size_t max_vertices) const
+{
+    size_t written = 0;
+    for (size_t i = 0; i < shape_ids.size(); i++) {
+        const ShapeVertices& shape = shapes[shape_ids[i]];
+        const size_t count = shape.x.size();
+        if (written + count > max_vertices) {
+            break;
+        }
+        written += ExpandInstance(shape.x.data(), shape.y.data(), shape.palette_index.data(), count,
+                                  pos_x[i], pos_y[i], rotation_cos[i], rotation_sin[i], sizes[i],
+                                  palettes[i].data(), out + written);
+    }
+    return written;
+}
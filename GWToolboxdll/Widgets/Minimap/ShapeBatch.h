@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Widgets/Minimap/D3DVertex.h>
+
+// Expands many instances of a few fixed 2d shapes into a triangle list in one pass.
+// Instances are kept as structure-of-arrays and expanded in the order they were added, so overlapping shapes keep their draw order.
+// Each shape vertex picks its colour from one of palette_size colours given per instance.
+class ShapeBatch {
+public:
+    static constexpr size_t palette_size = 4;
+    using Palette = std::array<D3DCOLOR, palette_size>;
+
+    // Defines shape vertices in model space, 3 per triangle
+    void AddShapeVertex(uint8_t shape, float x, float y, uint8_t palette_index);
+    [[nodiscard]] size_t ShapeVertexCount(uint8_t shape) const;
+
+    void Reserve(size_t instances);
+    void Clear();
+    // Queue shape rotated by (cos, sin), scaled by size and moved to (x, y)
+    void Add(uint8_t shape, float x, float y, float cos, float sin, float size, const Palette& palette);
+
+    [[nodiscard]] size_t Size() const { return shape_ids.size(); }
+    [[nodiscard]] size_t VertexCount() const { return vertex_count; }
+
+    // Writes queued instances to out in order; stops at the first instance that doesn't fit. Returns the number of vertices written.
+    size_t Expand(D3DVertex* out, size_t max_vertices) const;
+
+private:
+    struct ShapeVertices {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<uint8_t> palette_index;
+    };
+
+    std::vector<ShapeVertices> shapes;
+
+    std::vector<uint8_t> shape_ids;
+    std::vector<float> pos_x;
+    std::vector<float> pos_y;
+    std::vector<float> rotation_cos;
+    std::vector<float> rotation_sin;
+    std::vector<float> sizes;
+    std::vector<Palette> palettes;
+    size_t vertex_count = 0;
+};
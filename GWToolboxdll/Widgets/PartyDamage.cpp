@@ -16,6 +16,7 @@
 #include <Modules/Resources.h>
 #include <Modules/ToolboxSettings.h>
 #include <Widgets/PartyDamage.h>
+#include <Utils/PacketReplay.h>
 #include <Utils/TextUtils.h>
 
 constexpr const wchar_t* INI_FILENAME = L"healthlog.ini";
@@ -285,8 +286,8 @@ void PartyDamage::Initialize()
     total = 0;
     send_timer = TIMER_INIT();
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericModifier>(&GenericModifier_Entry, DamagePacketCallback,0x8000);
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::MapLoaded>(&MapLoaded_Entry, MapLoadedCallback, 0x8000);
+    PacketReplay::RegisterPacketCallback<GW::Packet::StoC::GenericModifier>(&GenericModifier_Entry, DamagePacketCallback, 0x8000);
+    PacketReplay::RegisterPacketCallback<GW::Packet::StoC::MapLoaded>(&MapLoaded_Entry, MapLoadedCallback, 0x8000);
 
     GW::Chat::CreateCommand(&ChatCmd_HookEntry, L"dmg", CmdDamage);
     GW::Chat::CreateCommand(&ChatCmd_HookEntry, L"damage", CmdDamage);
@@ -296,8 +297,8 @@ void PartyDamage::Initialize()
 void PartyDamage::Terminate()
 {
     SnapsToPartyWindow::Terminate();
-    GW::StoC::RemoveCallbacks(&GenericModifier_Entry);
-    GW::StoC::RemoveCallbacks(&MapLoaded_Entry);
+    PacketReplay::RemoveCallbacks(&GenericModifier_Entry);
+    PacketReplay::RemoveCallbacks(&MapLoaded_Entry);
     GW::Chat::DeleteCommand(&ChatCmd_HookEntry);
 
     for (auto str : party_names_by_index) {
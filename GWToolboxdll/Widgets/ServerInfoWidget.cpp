@@ -10,6 +10,7 @@
 #include <GWCA/Managers/StoCMgr.h>
 
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 
 #include <Modules/Resources.h>
 #include <Widgets/ServerInfoWidget.h>
@@ -50,7 +51,7 @@ sockaddr_sprint(char* s, const size_t n, const sockaddr* host, const bool inc_po
 void ServerInfoWidget::Initialize()
 {
     ToolboxWidget::Initialize();
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::InstanceLoadInfo>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::InstanceLoadInfo>(
         &InstanceLoadInfo_HookEntry, [this](GW::HookStatus*, GW::Packet::StoC::InstanceLoadInfo*) {
             current_server_info = nullptr;
             server_ip[0] = 0;
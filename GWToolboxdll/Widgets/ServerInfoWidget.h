@@ -44,6 +44,8 @@ public:
 
     void Initialize() override;
     void Update(float delta) override;
+    // Only retries the location lookup once a minute
+    [[nodiscard]] UpdateCadence GetUpdateCadence() const override { return UpdateCadence::Interval; }
     void LoadSettings(ToolboxIni* ini) override;
     void SaveSettings(ToolboxIni* ini) override;
 
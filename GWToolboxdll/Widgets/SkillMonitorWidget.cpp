@@ -14,6 +14,7 @@
 #include <Defines.h>
 #include <Modules/Resources.h>
 #include <Widgets/SkillMonitorWidget.h>
+#include <Utils/PacketReplay.h>
 
 namespace {
 
@@ -202,7 +203,7 @@ void SkillMonitorWidget::Initialize()
     for (const auto header : packet_headers_to_hook) {
         const auto entry = new GW::HookEntry;
         packet_hooks[header] = entry;
-        GW::StoC::RegisterPostPacketCallback(entry, header, OnStoCPacket);
+        PacketReplay::RegisterPostPacketCallback(entry, header, OnStoCPacket);
     }
 }
 
@@ -210,7 +211,7 @@ void SkillMonitorWidget::Terminate()
 {
     SnapsToPartyWindow::Terminate();
     for (const auto& it : packet_hooks) {
-        GW::StoC::RemoveCallback(it.first, it.second);
+        PacketReplay::RemoveCallback(it.first, it.second);
         delete it.second;
     }
     packet_hooks.clear();
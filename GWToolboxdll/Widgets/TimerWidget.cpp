@@ -14,6 +14,7 @@
 #include <GWCA/Managers/StoCMgr.h>
 
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 #include <Logger.h>
 #include <Timer.h>
 #include <Defines.h>
@@ -418,7 +419,7 @@ void TimerWidget::Initialize()
         }
     }
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::DisplayDialogue>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::DisplayDialogue>(
         &DisplayDialogue_Entry,
         [this](GW::HookStatus*, const GW::Packet::StoC::DisplayDialogue* packet) -> void {
             if (GW::Map::GetMapID() != GW::Constants::MapID::Domain_of_Anguish) {
@@ -430,18 +431,18 @@ void TimerWidget::Initialize()
             cave_start = GW::Map::GetInstanceTime();
         });
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GameSrvTransfer>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::GameSrvTransfer>(
         &PreGameSrvTransfer_Entry,
         [](GW::HookStatus* status, GW::Packet::StoC::GameSrvTransfer* pak) -> void {
             Instance().OnPreGameSrvTransfer(status, pak);
         }, -0x10);
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GameSrvTransfer>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::GameSrvTransfer>(
         &PostGameSrvTransfer_Entry,
         [](GW::HookStatus* status, GW::Packet::StoC::GameSrvTransfer* pak) -> void {
             Instance().OnPostGameSrvTransfer(status, pak);
         }, 0x5);
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::InstanceTimer>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::InstanceTimer>(
         &InstanceTimer_Entry,
         [this](GW::HookStatus*, GW::Packet::StoC::InstanceTimer*) -> void {
             instance_timer_valid = true;
@@ -573,6 +573,7 @@ namespace {
     void RefreshAccountCharacters()
     {
         pending_refresh_account_characters = true;
+        CompletionWindow::Instance().RequestUpdate();
     }
 
     // Check login screen; assign missing characters to email account
@@ -2529,6 +2530,9 @@ void CompletionWindow::Update(float)
     if (pending_refresh_account_characters) {
         pending_refresh_account_characters = !UpdateRefreshAccountCharacters();
     }
+    if (pending_refresh_account_characters) {
+        RequestUpdate(); // Not ready yet; try again next frame
+    }
 }
 
 void CompletionWindow::DrawHallOfMonuments(IDirect3DDevice9* device)
@@ -260,6 +260,8 @@ public:
     void Terminate() override;
     void Draw(IDirect3DDevice9* pDevice) override;
     void Update(float) override;
+    // Only busy while refreshing account characters
+    [[nodiscard]] UpdateCadence GetUpdateCadence() const override { return UpdateCadence::OnEvent; }
     static void DrawHallOfMonuments(IDirect3DDevice9* device);
 
     static bool IsAreaComplete(const GW::Constants::MapID map_id, CompletionCheck check = CompletionCheck::Both);
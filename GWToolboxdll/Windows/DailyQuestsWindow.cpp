@@ -819,6 +819,7 @@ namespace {
         const auto quest = get_quest_func(now);
         if (argc > 1 && (wcscmp(argv[1], L"take") == 0 || wcscmp(argv[1], L"travel") == 0) && quest->GetQuestGiverOutpost() != MapID::None) {
             pending_quest_take = quest;
+            DailyQuests::Instance().RequestUpdate();
             return;
         }
         PrintDaily(quest_type, quest->GetQuestNameEnc(), now);
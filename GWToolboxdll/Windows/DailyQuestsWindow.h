@@ -32,6 +32,9 @@ public:
 
     void DrawHelp() override;
     void Update(float delta) override;
+    // Checks subscriptions once after startup; taking a quest asks for an update straight away
+    [[nodiscard]] UpdateCadence GetUpdateCadence() const override { return UpdateCadence::Interval; }
+    [[nodiscard]] uint32_t UpdateIntervalMs() const override { return 500; }
     void Draw(IDirect3DDevice9* pDevice) override;
 
 public:
@@ -9,6 +9,7 @@
 
 #include <Windows/DoorMonitorWindow.h>
 #include <ImGuiAddons.h>
+#include <Utils/FrameProfiler.h>
 
 void DoorMonitorWindow::Draw(IDirect3DDevice9*)
 {
@@ -112,7 +113,7 @@ void DoorMonitorWindow::Initialize()
         in_zone = true;
     }
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::InstanceLoadInfo>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::InstanceLoadInfo>(
         &InstanceLoadInfo_Callback,
         [this](const GW::HookStatus*, const GW::Packet::StoC::InstanceLoadInfo* packet) -> bool {
             if (!packet->is_explorable) {
@@ -122,7 +123,7 @@ void DoorMonitorWindow::Initialize()
             return in_zone = true, false;
         });
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::ManipulateMapObject>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::ManipulateMapObject>(
         &ManipulateMapObject_Callback,
         [this](const GW::HookStatus*, const GW::Packet::StoC::ManipulateMapObject* packet) -> bool {
             if (!in_zone) {
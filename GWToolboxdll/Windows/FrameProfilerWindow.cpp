@@ -0,0 +1,156 @@
+#include "stdafx.h"
+
+#include <Modules/Resources.h>
+#include <Utils/FrameProfiler.h>
+#include <Windows/FrameProfilerWindow.h>
+#include <ImGuiAddons.h>
+
+namespace {
+    enum class Column {
+        Name,
+        Phase,
+        P50,
+        P95,
+        Max,
+        Calls
+    };
+
+    float SortValue(const FrameProfiler::Stats& stats, const Column column)
+    {
+        switch (column) {
+            case Column::P50:
+                return stats.p50_ms;
+            case Column::Max:
+                return stats.max_ms;
+            case Column::Calls:
+                return stats.calls_per_frame;
+            default:
+                return stats.p95_ms;
+        }
+    }
+
+    void SortStats(std::vector<FrameProfiler::Stats>& stats, const Column column, const bool descending)
+    {
+        std::ranges::sort(stats, [column, descending](const FrameProfiler::Stats& a, const FrameProfiler::Stats& b) {
+            int order;
+            switch (column) {
+                case Column::Name:
+                    order = strcmp(a.name, b.name);
+                    break;
+                case Column::Phase:
+                    order = static_cast<int>(a.phase) - static_cast<int>(b.phase);
+                    break;
+                default: {
+                    const float va = SortValue(a, column);
+                    const float vb = SortValue(b, column);
+                    order = va < vb ? -1 : va > vb ? 1 : 0;
+                }
+            }
+            return descending ? order > 0 : order < 0;
+        });
+    }
+
+    std::filesystem::path TracePath()
+    {
+        SYSTEMTIME time;
+        GetLocalTime(&time);
+        return Resources::GetPath(L"profiles", std::format(L"trace_{:04}-{:02}-{:02}T{:02}-{:02}-{:02}.json",
+                                                           time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond));
+    }
+}
+
+void FrameProfilerWindow::Terminate()
+{
+    ToolboxWindow::Terminate();
+    FrameProfiler::SetEnabled(false);
+}
+
+void FrameProfilerWindow::Draw(IDirect3DDevice9*)
+{
+    // Only measure while someone is looking
+    FrameProfiler::SetEnabled(visible);
+    if (!visible) {
+        return;
+    }
+    ImGui::SetNextWindowCenter(ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(560, 400), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin(Name(), GetVisiblePtr(), GetWinFlags())) {
+        return ImGui::End();
+    }
+
+    const auto total = FrameProfiler::GetTotalStats();
+    ImGui::Text("All modules: %.2f ms p50, %.2f ms p95, %.2f ms max per frame", total.p50_ms, total.p95_ms, total.max_ms);
+    if (ImGui::Button("Reset")) {
+        FrameProfiler::Reset();
+    }
+    ImGui::SameLine();
+    if (FrameProfiler::IsCapturingTrace()) {
+        ImGui::TextDisabled("Capturing trace...");
+    }
+    else if (ImGui::Button("Capture Trace")) {
+        Resources::EnsureFolderExists(Resources::GetPath(L"profiles"));
+        FrameProfiler::CaptureTrace(trace_frame_count, TracePath());
+    }
+    ImGui::ShowHelp("Records every timed call over the next frames into profiles\\trace_<time>.json.\nOpen it in chrome://tracing or ui.perfetto.dev.");
+
+    constexpr auto table_flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingFixedFit;
+    if (ImGui::BeginTable("frame_profiler_table", 6, table_flags)) {
+        constexpr auto number_column = ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_PreferSortDescending;
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Module", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("Phase");
+        ImGui::TableSetupColumn("p50 ms", number_column);
+        ImGui::TableSetupColumn("p95 ms", number_column | ImGuiTableColumnFlags_DefaultSort);
+        ImGui::TableSetupColumn("Max ms", number_column);
+        ImGui::TableSetupColumn("Calls", number_column);
+        ImGui::TableHeadersRow();
+
+        auto stats = FrameProfiler::GetStats();
+        auto column = Column::P95;
+        bool descending = true;
+        if (const auto specs = ImGui::TableGetSortSpecs(); specs && specs->SpecsCount) {
+            column = static_cast<Column>(specs->Specs[0].ColumnIndex);
+            descending = specs->Specs[0].SortDirection == ImGuiSortDirection_Descending;
+        }
+        SortStats(stats, column, descending);
+
+        for (const auto& row : stats) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(row.name);
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(FrameProfiler::GetPhaseName(row.phase));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", row.p50_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", row.p95_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", row.max_ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", row.calls_per_frame);
+        }
+        ImGui::EndTable();
+    }
+    ImGui::End();
+}
+
+void FrameProfilerWindow::DrawSettingsInternal()
+{
+    int frames = static_cast<int>(trace_frame_count);
+    if (ImGui::InputInt("Trace length (frames)", &frames)) {
+        trace_frame_count = static_cast<uint32_t>(std::clamp(frames, 1, 3600));
+    }
+    ImGui::ShowHelp("Number of frames recorded by Capture Trace");
+}
+
+void FrameProfilerWindow::LoadSettings(ToolboxIni* ini)
+{
+    ToolboxWindow::LoadSettings(ini);
+    LOAD_UINT(trace_frame_count);
+}
+
+void FrameProfilerWindow::SaveSettings(ToolboxIni* ini)
+{
+    ToolboxWindow::SaveSettings(ini);
+    SAVE_UINT(trace_frame_count);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <ToolboxWindow.h>
+
+// Ranks modules by how much frame time their Update, Draw, WndProc and packet callbacks take; see FrameProfiler
+class FrameProfilerWindow : public ToolboxWindow {
+    FrameProfilerWindow() = default;
+    ~FrameProfilerWindow() override = default;
+
+public:
+    static FrameProfilerWindow& Instance()
+    {
+        static FrameProfilerWindow instance;
+        return instance;
+    }
+
+    [[nodiscard]] const char* Name() const override { return "Frame Profiler"; }
+    [[nodiscard]] const char* Icon() const override { return ICON_FA_STOPWATCH; }
+
+    void Terminate() override;
+    void Draw(IDirect3DDevice9* pDevice) override;
+    void DrawSettingsInternal() override;
+    void LoadSettings(ToolboxIni* ini) override;
+    void SaveSettings(ToolboxIni* ini) override;
+
+private:
+    uint32_t trace_frame_count = 300;
+};
@@ -25,6 +25,7 @@
 #include <Modules/Resources.h>
 #include <Windows/FriendListWindow.h>
 
+#include <Utils/FrameProfiler.h>
 #include <Utils/ToolboxUtils.h>
 
 
@@ -874,7 +875,7 @@ void FriendListWindow::Initialize()
     }
 
     for (const auto header_id : OnStoCPacket_Headers) {
-        GW::StoC::RegisterPacketCallback(&OnPostStoCPacket_Entry, header_id, OnPostStoCPacket, 0x8001);
+        FrameProfiler::RegisterPacketCallback(&OnPostStoCPacket_Entry, header_id, OnPostStoCPacket, 0x8001);
     }
 
 chat_commands = {
@@ -54,6 +54,7 @@
 #include <Modules/GwDatTextureModule.h>
 #include <Modules/HallOfMonumentsModule.h>
 #include <Modules/Resources.h>
+#include <Utils/FrameProfiler.h>
 #include <Utils/ToolboxUtils.h>
 #include <Logger.h>
 #include <GWToolbox.h>
@@ -852,11 +853,11 @@ void InfoWindow::Initialize()
 {
     ToolboxWindow::Initialize();
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::QuotedItemPrice>(&InstanceLoadFile_Entry,
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::QuotedItemPrice>(&InstanceLoadFile_Entry,
                                                                         [this](GW::HookStatus*, const GW::Packet::StoC::QuotedItemPrice* packet) -> void {
                                                                             quoted_item_id = packet->itemid;
                                                                         });
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::InstanceLoadFile>(&InstanceLoadFile_Entry, OnInstanceLoad);
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::InstanceLoadFile>(&InstanceLoadFile_Entry, OnInstanceLoad);
 }
 
 void InfoWindow::Draw(IDirect3DDevice9*)
@@ -26,6 +26,7 @@
 
 #include <GWToolbox.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 #include <Logger.h>
 #include <GWCA/Context/CharContext.h>
 
@@ -213,13 +214,13 @@ void ObjectiveTimerWindow::Initialize()
     static GW::HookEntry CountdownStart_Enty;
 
     // packet hooks used to create or manipulate objective sets:
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::PartyDefeated>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::PartyDefeated>(
         &PartyDefeated_Entry, [this](GW::HookStatus*, GW::Packet::StoC::PartyDefeated*) { StopObjectives(); });
 
     // NB: Server may not send packets in the order we want them
     // e.g. InstanceLoadInfo comes in before ExamplePlugin which means the run start is whacked out
     // keep track of the packets and only trigger relevant events when the needed packets are in.
-    GW::StoC::RegisterPostPacketCallback<GW::Packet::StoC::InstanceLoadInfo>(
+    FrameProfiler::RegisterPostPacketCallback<GW::Packet::StoC::InstanceLoadInfo>(
         &InstanceLoadInfo_Entry,
         [this](GW::HookStatus*, const GW::Packet::StoC::InstanceLoadInfo* packet) {
             InstanceLoadInfo = new GW::Packet::StoC::InstanceLoadInfo;
@@ -228,19 +229,19 @@ void ObjectiveTimerWindow::Initialize()
             if (!GW::GetCharContext() || current_objective_set && current_objective_set->character_name != GW::GetCharContext()->player_name)
                 StopObjectives();
         });
-    GW::StoC::RegisterPostPacketCallback<GW::Packet::StoC::InstanceLoadFile>(
+    FrameProfiler::RegisterPostPacketCallback<GW::Packet::StoC::InstanceLoadFile>(
         &InstanceLoadFile_Entry, [this](GW::HookStatus*, const GW::Packet::StoC::InstanceLoadFile* packet) {
             InstanceLoadFile = new GW::Packet::StoC::InstanceLoadFile;
             memcpy(InstanceLoadFile, packet, sizeof(GW::Packet::StoC::InstanceLoadFile));
             CheckIsMapLoaded();
         });
-    GW::StoC::RegisterPostPacketCallback<GW::Packet::StoC::InstanceTimer>(
+    FrameProfiler::RegisterPostPacketCallback<GW::Packet::StoC::InstanceTimer>(
         &InstanceLoadFile_Entry, [this](GW::HookStatus*, const GW::Packet::StoC::InstanceTimer* packet) {
             InstanceTimer = new GW::Packet::StoC::InstanceTimer;
             memcpy(InstanceTimer, packet, sizeof(GW::Packet::StoC::InstanceTimer));
             CheckIsMapLoaded();
         });
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GameSrvTransfer>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::GameSrvTransfer>(
         &GameSrvTransfer_Entry, [this](GW::HookStatus*, GW::Packet::StoC::GameSrvTransfer* packet) {
             // Exited map
             const GW::AreaInfo* info = GW::Map::GetMapInfo(static_cast<GW::Constants::MapID>(packet->map_id));
@@ -279,7 +280,7 @@ void ObjectiveTimerWindow::Initialize()
             map_load_pending = true;
         }, -5);
     // packet hooks that trigger events:
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::MessageServer>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::MessageServer>(
         &MessageServer_Entry,
         [this](GW::HookStatus*, GW::Packet::StoC::MessageServer*) {
             const GW::Array<wchar_t>* buff = &GW::GetGameContext()->world->message_buff;
@@ -290,13 +291,13 @@ void ObjectiveTimerWindow::Initialize()
             // NB: buff->size() includes null terminating char. All GW strings are null terminated, use wcslen instead
             Event(EventType::ServerMessage, wcslen(msg), msg);
         });
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::DisplayDialogue>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::DisplayDialogue>(
         &DisplayDialogue_Entry,
         [this](GW::HookStatus*, const GW::Packet::StoC::DisplayDialogue* packet) {
             // NB: All GW strings are null terminated, use wcslen to avoid having to check all 122 chars
             Event(EventType::DisplayDialogue, wcslen(packet->message), packet->message);
         });
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::ManipulateMapObject>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::ManipulateMapObject>(
         &ManipulateMapObject_Entry, [this](GW::HookStatus*, const GW::Packet::StoC::ManipulateMapObject* packet) {
             if (GW::Map::GetInstanceType() == GW::Constants::InstanceType::Explorable) {
                 if (packet->animation_type == 16 && packet->animation_stage == 2) {
@@ -308,15 +309,15 @@ void ObjectiveTimerWindow::Initialize()
                 // TODO: maybe add a more generic ManipulateMapObject packet?
             }
         });
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::ObjectiveUpdateName>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::ObjectiveUpdateName>(
         &ObjectiveUpdateName_Entry, [this](GW::HookStatus*, const GW::Packet::StoC::ObjectiveUpdateName* packet) {
             Event(EventType::ObjectiveStarted, packet->objective_id);
         });
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::ObjectiveDone>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::ObjectiveDone>(
         &ObjectiveDone_Entry, [this](GW::HookStatus*, const GW::Packet::StoC::ObjectiveDone* packet) {
             Event(EventType::ObjectiveDone, packet->objective_id);
         });
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::AgentUpdateAllegiance>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::AgentUpdateAllegiance>(
         &AgentUpdateAllegiance_Entry, [this](GW::HookStatus*, const GW::Packet::StoC::AgentUpdateAllegiance* packet) {
             if (const GW::Agent* agent = GW::Agents::GetAgentByID(packet->agent_id)) {
                 if (const GW::AgentLiving* agentliving = agent->GetAsAgentLiving()) {
@@ -324,18 +325,18 @@ void ObjectiveTimerWindow::Initialize()
                 }
             }
         });
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::DoACompleteZone>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::DoACompleteZone>(
         &DoACompleteZone_Entry, [this](GW::HookStatus*, const GW::Packet::StoC::DoACompleteZone* packet) {
             if (packet->message[0] == 0x8101) {
                 Event(EventType::DoACompleteZone, packet->message[1]);
             }
         });
-    GW::StoC::RegisterPacketCallback(
+    FrameProfiler::RegisterPacketCallback(
         &CountdownStart_Enty, GAME_SMSG_INSTANCE_COUNTDOWN,
         [this](GW::HookStatus*, GW::Packet::StoC::PacketBase*) {
             Event(EventType::CountdownStart, std::to_underlying(GW::Map::GetMapID()));
         });
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::DungeonReward>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::DungeonReward>(
         &DungeonReward_Entry, [this](GW::HookStatus*, GW::Packet::StoC::DungeonReward*) {
             Event(EventType::DungeonReward);
             if (ObjectiveSet* os = GetCurrentObjectiveSet()) {
@@ -344,7 +345,7 @@ void ObjectiveTimerWindow::Initialize()
             }
         });
 
-    /*GW::StoC::RegisterPacketCallback<GW::Packet::StoC::ObjectiveAdd>(&ObjectiveAdd_Entry,
+    /*FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::ObjectiveAdd>(&ObjectiveAdd_Entry,
 [this](GW::HookStatus* status, GW::Packet::StoC::ObjectiveAdd *packet) -> bool {
             // type 12 is the "title" of the mission objective, should we ignore it or have a "title" objective ?
     /*
@@ -1,6 +1,10 @@
 #include "stdafx.h"
 
+#include <charconv>
+
 #include <GWCA/Managers/ChatMgr.h>
+#include <GWCA/Managers/GameThreadMgr.h>
+#include <GWCA/Managers/MapMgr.h>
 
 #include <Utils/GuiUtils.h>
 
@@ -9,392 +13,821 @@
 
 #include <Windows/ObserverExportWindow.h>
 #include <Utils/TextUtils.h>
+#include <Timer.h>
+
+namespace {
+    // Writes JSON straight to a stream instead of building a document first
+    class JsonWriter {
+    public:
+        explicit JsonWriter(std::ostream& out)
+            : out(out) { }
+
+        void BeginObject() { Begin('{'); }
+        void EndObject() { End('}'); }
+        void BeginArray() { Begin('['); }
+        void EndArray() { End(']'); }
+
+        JsonWriter& Key(const std::string_view key)
+        {
+            Separate();
+            String(key);
+            out.put(':');
+            after_key = true;
+            return *this;
+        }
 
-void ObserverExportWindow::Initialize()
-{
-    ToolboxWindow::Initialize();
-}
-
-// Convert to JSON (Version 0.1)
-nlohmann::json ObserverExportWindow::ToJSON_V_0_1()
-{
-    nlohmann::json json;
-    ObserverModule& observer_module = ObserverModule::Instance();
-    const std::vector<uint32_t>& party_ids = observer_module.GetObservablePartyIds();
-
-    auto shared_stats_to_json = [](const ObserverModule::SharedStats& stats) {
-        nlohmann::json shared_json;
-        shared_json["total_crits_received"] = stats.total_crits_received;
-        shared_json["total_crits_dealt"] = stats.total_crits_dealt;
-        shared_json["total_party_crits_received"] = stats.total_party_crits_received;
-        shared_json["total_party_crits_dealt"] = stats.total_party_crits_dealt;
-        shared_json["knocked_down_count"] = stats.knocked_down_count;
-        shared_json["interrupted_count"] = stats.interrupted_count;
-        shared_json["interrupted_skills_count"] = stats.interrupted_skills_count;
-        shared_json["cancelled_count"] = stats.cancelled_count;
-        shared_json["cancelled_skills_count"] = stats.cancelled_skills_count;
-        shared_json["knocked_down_duration"] = stats.knocked_down_duration;
-        shared_json["deaths"] = stats.deaths;
-        shared_json["kills"] = stats.kills;
-        shared_json["kdr_str"] = stats.kdr_str;
-        return shared_json;
-    };
+        void Null()
+        {
+            Separate();
+            out.write("null", 4);
+        }
 
-    for (const uint32_t party_id : party_ids) {
-        // parties
-        const ObserverModule::ObservableParty* party = observer_module.GetObservablePartyById(party_id);
-        if (!party) {
-            json["parties"].push_back(nlohmann::json::value_t::null);
-            continue;
+        void Value(const std::string_view value)
+        {
+            Separate();
+            String(value);
         }
-        json["parties"].push_back([&] {
-            // parties -> party
-            nlohmann::json json_party;
-            json_party["party_id"] = party->party_id;
-            json_party["stats"] = shared_stats_to_json(party->stats);
-            for (const uint32_t agent_id : party->agent_ids) {
-                // parties -> party -> agents
-                ObserverModule::ObservableAgent* agent = observer_module.GetObservableAgentById(agent_id);
-                if (!agent) {
-                    json_party["members"].push_back(nlohmann::json::value_t::null);
-                    continue;
+
+        void Value(const char* value) { Value(std::string_view(value)); }
+        void Value(const std::string& value) { Value(std::string_view(value)); }
+
+        template <typename T>
+        void Value(const T value)
+        {
+            if constexpr (std::is_enum_v<T>) {
+                Value(std::to_underlying(value));
+            }
+            else if constexpr (std::is_same_v<T, bool>) {
+                Separate();
+                value ? out.write("true", 4) : out.write("false", 5);
+            }
+            else if constexpr (std::is_floating_point_v<T>) {
+                if (!std::isfinite(value)) {
+                    return Null();
                 }
-                json_party["members"].push_back([&] {
-                    // parties -> party -> agents -> agent
-                    nlohmann::json json_agent;
-                    json_agent["display_name"] = agent->DisplayName();
-                    json_agent["raw_name"] = agent->RawName();
-                    json_agent["debug_name"] = agent->DebugName();
-                    json_agent["sanitized_name"] = agent->SanitizedName();
-                    json_agent["party_id"] = agent->party_id;
-                    json_agent["party_index"] = agent->party_index;
-                    json_agent["primary"] = agent->primary;
-                    json_agent["secondary"] = agent->secondary;
-                    json_agent["profession"] = agent->profession;
-                    json_agent["stats"] = shared_stats_to_json(agent->stats);
-                    for (const auto skill_id : agent->stats.skill_ids_used) {
-                        // parties -> party -> agents -> agent -> skills
-                        ObserverModule::ObservableSkill* skill = ObserverModule::Instance().GetObservableSkillById(skill_id);
-                        if (!skill) {
-                            json["skills"].push_back(nlohmann::json::value_t::null);
-                            continue;
+                Separate();
+                char buf[32];
+                const auto res = std::to_chars(buf, buf + sizeof(buf), value);
+                out.write(buf, res.ptr - buf);
+            }
+            else {
+                static_assert(std::is_integral_v<T>);
+                Separate();
+                char buf[24];
+                const auto res = std::to_chars(buf, buf + sizeof(buf), value);
+                out.write(buf, res.ptr - buf);
+            }
+        }
+
+        template <typename T>
+        void Array(const std::vector<T>& values)
+        {
+            BeginArray();
+            for (const auto& value : values) {
+                Value(value);
+            }
+            EndArray();
+        }
+
+        template <typename T>
+        void Field(const std::string_view key, const T& value) { Key(key).Value(value); }
+
+    private:
+        void Begin(const char c)
+        {
+            Separate();
+            out.put(c);
+            first_in_scope.push_back(true);
+        }
+
+        void End(const char c)
+        {
+            out.put(c);
+            first_in_scope.pop_back();
+        }
+
+        // Comma between values, unless this is the value of a key or the first value in the object/array
+        void Separate()
+        {
+            if (after_key) {
+                after_key = false;
+                return;
+            }
+            if (first_in_scope.empty()) {
+                return;
+            }
+            if (!first_in_scope.back()) {
+                out.put(',');
+            }
+            first_in_scope.back() = false;
+        }
+
+        void String(const std::string_view str)
+        {
+            out.put('"');
+            for (const char c : str) {
+                switch (c) {
+                    case '"':
+                        out.write("\\\"", 2);
+                        break;
+                    case '\\':
+                        out.write("\\\\", 2);
+                        break;
+                    case '\n':
+                        out.write("\\n", 2);
+                        break;
+                    case '\r':
+                        out.write("\\r", 2);
+                        break;
+                    case '\t':
+                        out.write("\\t", 2);
+                        break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20) {
+                            char buf[8];
+                            snprintf(buf, sizeof(buf), "\\u%04x", c);
+                            out.write(buf, 6);
                         }
-                        json["skills"].push_back([&] {
-                            // parties -> party -> agents -> agent -> skills -> skill
-                            nlohmann::json json_skill;
-                            json_skill["name"] = skill->Name();
-                            return json_skill;
-                        }());
-                    }
-                    return json_agent;
-                }());
-                return json;
+                        else {
+                            out.put(c);
+                        }
+                        break;
+                }
             }
-            return json_party;
-        }());
-    }
+            out.put('"');
+        }
 
-    return json;
-}
+        std::ostream& out;
+        std::vector<bool> first_in_scope;
+        bool after_key = false;
+    };
 
-// Convert to JSON (Version 1.0)
-nlohmann::json ObserverExportWindow::ToJSON_V_1_0()
-{
-    nlohmann::json json;
-    ObserverModule& om = ObserverModule::Instance();
-
-    // name is built by iterating over the parties
-    bool name_prepend_vs = false;
-    std::string name = "";
-
-    json["match_finished"] = om.match_finished;
-    json["winning_party_id"] = om.winning_party_id;
-    json["match_duration_ms_total"] = om.match_duration_ms_total.count();
-    json["match_duration_ms"] = om.match_duration_ms.count();
-    json["match_duration_secs"] = om.match_duration_secs.count();
-    json["match_duration_mins"] = om.match_duration_mins.count();
-
-    ObserverModule::ObservableMap* map = om.GetMap();
-    json["map"] = nlohmann::json::value_t::null;
-    if (map) {
-        json["map"] = {};
-        json["map"]["name"] = map->Name();
-        json["map"]["description"] = map->Description();
-        json["map"]["is_pvp"] = map->GetIsPvP();
-        json["map"]["is_guild_hall"] = map->GetIsGuildHall();
-        json["map"]["campaign"] = map->campaign;
-        json["map"]["continent"] = map->continent;
-        json["map"]["region"] = map->region;
-        json["map"]["type"] = map->type;
-        json["map"]["flags"] = map->flags;
-        json["map"]["name_id"] = map->name_id;
-        json["map"]["description_id"] = map->description_id;
-    }
+    // Copy of everything the export needs, taken on the game thread so the export can be written on a worker thread
+    struct SkillUsage {
+        GW::Constants::SkillID skill_id;
+        ObserverModule::ObservedAction action;
+    };
 
-    auto action_to_json = [](const ObserverModule::ObservedAction& action) {
-        nlohmann::json action_json;
-        action_json["started"] = action.started;
-        action_json["stopped"] = action.stopped;
-        action_json["interrupted"] = action.interrupted;
-        action_json["finished"] = action.finished;
-        action_json["integrity"] = action.integrity;
-        return action_json;
+    struct AgentSnapshot {
+        uint32_t agent_id = NO_AGENT;
+        std::string display_name;
+        std::string raw_name;
+        std::string debug_name;
+        std::string sanitized_name;
+        uint32_t party_id = NO_PARTY;
+        uint32_t party_index = 0;
+        GW::Constants::Profession primary = GW::Constants::Profession::None;
+        GW::Constants::Profession secondary = GW::Constants::Profession::None;
+        std::string profession;
+        uint32_t guild_id = NO_GUILD;
+        ObserverModule::SharedStats stats;
+        std::vector<std::string> skill_names_used; // In order of skill_ids_used; empty for skills that aren't loaded
+        std::vector<std::pair<uint32_t, ObserverModule::ObservedAction>> attacks_dealt_to_agents;
+        std::vector<std::pair<uint32_t, ObserverModule::ObservedAction>> attacks_received_from_agents;
+        std::vector<GW::Constants::SkillID> skill_ids_used;
+        std::vector<SkillUsage> skills_used;
+        std::vector<GW::Constants::SkillID> skill_ids_received;
+        std::vector<SkillUsage> skills_received;
+        std::vector<std::pair<uint32_t, std::vector<SkillUsage>>> skills_used_on_agents;
+        std::vector<std::pair<uint32_t, std::vector<SkillUsage>>> skills_received_from_agents;
     };
 
-    auto shared_stats_to_json = [&action_to_json](const ObserverModule::SharedStats& stats) {
-        nlohmann::json stats_json;
-        stats_json["total_crits_received"] = stats.total_crits_received;
-        stats_json["total_crits_dealt"] = stats.total_crits_dealt;
-        stats_json["total_party_crits_received"] = stats.total_party_crits_received;
-        stats_json["total_party_crits_dealt"] = stats.total_party_crits_dealt;
-        stats_json["knocked_down_count"] = stats.knocked_down_count;
-        stats_json["interrupted_count"] = stats.interrupted_count;
-        stats_json["interrupted_skills_count"] = stats.interrupted_skills_count;
-        stats_json["cancelled_count"] = stats.cancelled_count;
-        stats_json["cancelled_skills_count"] = stats.cancelled_skills_count;
-        stats_json["knocked_down_duration"] = stats.knocked_down_duration;
-        stats_json["deaths"] = stats.deaths;
-        stats_json["kills"] = stats.kills;
-        stats_json["kdr_str"] = stats.kdr_str;
-        stats_json["total_attacks_dealt"] = action_to_json(stats.total_attacks_dealt);
-        stats_json["total_attacks_received"] = action_to_json(stats.total_attacks_received);
-        stats_json["total_attacks_dealt_to_other_parties"] = action_to_json(stats.total_attacks_dealt_to_other_parties);
-        stats_json["total_attacks_received_from_other_parties"] = action_to_json(stats.total_attacks_received_from_other_parties);
-        stats_json["total_skills_used"] = action_to_json(stats.total_skills_used);
-        stats_json["total_skills_received"] = action_to_json(stats.total_skills_received);
-        stats_json["total_skills_used_on_own_party"] = action_to_json(stats.total_skills_used_on_own_party);
-        stats_json["total_skills_used_on_other_parties"] = action_to_json(stats.total_skills_used_on_other_parties);
-        stats_json["total_skills_received_from_own_party"] = action_to_json(stats.total_skills_received_from_own_party);
-        stats_json["total_skills_received_from_other_parties"] = action_to_json(stats.total_skills_received_from_other_parties);
-        stats_json["total_skills_used_on_own_team"] = action_to_json(stats.total_skills_used_on_own_team);
-        stats_json["total_skills_used_on_other_teams"] = action_to_json(stats.total_skills_used_on_other_teams);
-        stats_json["total_skills_received_from_own_team"] = action_to_json(stats.total_skills_received_from_own_team);
-        stats_json["total_skills_received_from_other_teams"] = action_to_json(stats.total_skills_received_from_other_teams);
-        return stats_json;
+    struct PartySnapshot {
+        uint32_t party_id = NO_PARTY;
+        std::string name;
+        std::string display_name;
+        bool is_victorious = false;
+        bool is_defeated = false;
+        uint32_t guild_id = NO_GUILD;
+        std::vector<uint32_t> agent_ids;
+        uint32_t rank = NO_RANK;
+        std::string rank_str;
+        uint32_t rating = NO_RATING;
+        ObserverModule::SharedStats stats;
     };
 
-    const std::vector<uint32_t>& guild_ids = om.GetObservableGuildIds();
-    const std::vector<uint32_t>& agent_ids = om.GetObservableAgentIds();
-    const std::vector<uint32_t>& party_ids = om.GetObservablePartyIds();
-    const std::vector<GW::Constants::SkillID>& skill_ids = om.GetObservableSkillIds();
-
-    // guilds
-    json["guilds"]["ids"] = guild_ids;
-    json["guilds"]["by_id"] = {};
-    for (uint32_t guild_id : guild_ids) {
-        std::string guild_id_s = std::to_string(guild_id);
-        ObserverModule::ObservableGuild* guild = om.GetObservableGuildById(guild_id);
-        if (!guild) {
-            json["guilds"]["by_id"][guild_id_s] = nlohmann::json::value_t::null;
-            continue;
-        }
-        json["guilds"]["by_id"][guild_id_s]["guild_id"] = guild->guild_id;
-        json["guilds"]["by_id"][guild_id_s]["key"] = guild->key.k;
-        json["guilds"]["by_id"][guild_id_s]["name"] = guild->name;
-        json["guilds"]["by_id"][guild_id_s]["tag"] = guild->tag;
-        json["guilds"]["by_id"][guild_id_s]["wrapped_tag"] = guild->wrapped_tag;
-        json["guilds"]["by_id"][guild_id_s]["rank"] = guild->rank;
-        json["guilds"]["by_id"][guild_id_s]["rating"] = guild->rating;
-        json["guilds"]["by_id"][guild_id_s]["faction"] = guild->faction;
-        json["guilds"]["by_id"][guild_id_s]["faction_point"] = guild->faction_point;
-        json["guilds"]["by_id"][guild_id_s]["qualifier_point"] = guild->qualifier_point;
-        json["guilds"]["by_id"][guild_id_s]["cape_trim"] = guild->cape_trim;
-    }
+    struct SkillSnapshot {
+        std::string name;
+        ObserverModule::ObservableSkillStats stats;
+        GW::Skill gw_skill;
+    };
+
+    struct GuildSnapshot {
+        uint32_t guild_id;
+        GW::GHKey key;
+        std::string name;
+        std::string tag;
+        std::string wrapped_tag;
+        uint32_t rank;
+        uint32_t rating;
+        uint32_t faction;
+        uint32_t faction_point;
+        uint32_t qualifier_point;
+        uint32_t cape_trim;
+    };
+
+    struct MapSnapshot {
+        std::string name;
+        std::string description;
+        bool is_pvp;
+        bool is_guild_hall;
+        GW::Constants::Campaign campaign;
+        GW::Continent continent;
+        GW::Region region;
+        GW::RegionType type;
+        uint32_t flags;
+        uint32_t name_id;
+        uint32_t description_id;
+    };
+
+    struct MatchSnapshot {
+        bool match_finished = false;
+        uint32_t winning_party_id = NO_PARTY;
+        long long match_duration_ms_total = 0;
+        long long match_duration_ms = 0;
+        long long match_duration_secs = 0;
+        long long match_duration_mins = 0;
+        std::optional<MapSnapshot> map;
+
+        // Missing entries are exported as null, like before
+        std::vector<uint32_t> guild_ids;
+        std::vector<std::optional<GuildSnapshot>> guilds;
+        std::vector<GW::Constants::SkillID> skill_ids;
+        std::vector<std::optional<SkillSnapshot>> skills;
+        std::vector<uint32_t> party_ids;
+        std::vector<std::optional<PartySnapshot>> parties;
+        std::vector<uint32_t> agent_ids;
+        std::vector<std::optional<AgentSnapshot>> agents;
+
+        // "Party A vs Party B"
+        std::string name;
+    };
 
-    // skills
-    json["skills"]["ids"] = skill_ids;
-    json["skills"]["by_id"] = {};
-    for (auto skill_id : skill_ids) {
-        std::string skill_id_s = std::to_string(std::to_underlying(skill_id));
-        ObserverModule::ObservableSkill* skill = om.GetObservableSkillById(skill_id);
-        if (!skill) {
-            json["skills"]["by_id"][skill_id_s] = nlohmann::json::value_t::null;
-            continue;
-        }
-        json["skills"]["by_id"][skill_id_s]["skill_id"] = skill->gw_skill.skill_id;
-        json["skills"]["by_id"][skill_id_s]["name"] = skill->Name();
-        json["skills"]["by_id"][skill_id_s]["stats"]["total_usages"] = action_to_json(skill->stats.total_usages);
-        json["skills"]["by_id"][skill_id_s]["stats"]["total_self_usages"] = action_to_json(skill->stats.total_self_usages);
-        json["skills"]["by_id"][skill_id_s]["stats"]["total_other_usages"] = action_to_json(skill->stats.total_other_usages);
-        json["skills"]["by_id"][skill_id_s]["stats"]["total_own_party_usages"] = action_to_json(skill->stats.total_own_party_usages);
-        json["skills"]["by_id"][skill_id_s]["stats"]["total_other_party_usages"] = action_to_json(skill->stats.total_other_party_usages);
-        json["skills"]["by_id"][skill_id_s]["stats"]["total_own_team_usages"] = action_to_json(skill->stats.total_own_team_usages);
-        json["skills"]["by_id"][skill_id_s]["stats"]["total_other_team_usages"] = action_to_json(skill->stats.total_other_team_usages);
-        json["skills"]["by_id"][skill_id_s]["campaign"] = skill->gw_skill.campaign;
-        json["skills"]["by_id"][skill_id_s]["type"] = skill->gw_skill.type;
-        json["skills"]["by_id"][skill_id_s]["sepcial"] = skill->gw_skill.special;
-        json["skills"]["by_id"][skill_id_s]["activation"] = skill->gw_skill.activation;
-        json["skills"]["by_id"][skill_id_s]["combo_req"] = skill->gw_skill.combo_req;
-        json["skills"]["by_id"][skill_id_s]["effect1"] = skill->gw_skill.effect1;
-        json["skills"]["by_id"][skill_id_s]["condition"] = skill->gw_skill.condition;
-        json["skills"]["by_id"][skill_id_s]["effect2"] = skill->gw_skill.effect2;
-        json["skills"]["by_id"][skill_id_s]["weapon_req"] = skill->gw_skill.weapon_req;
-        json["skills"]["by_id"][skill_id_s]["profession"] = skill->gw_skill.profession;
-        json["skills"]["by_id"][skill_id_s]["attribute"] = skill->gw_skill.attribute;
-        json["skills"]["by_id"][skill_id_s]["skill_id_pvp"] = skill->gw_skill.skill_id_pvp;
-        json["skills"]["by_id"][skill_id_s]["combo"] = skill->gw_skill.combo;
-        json["skills"]["by_id"][skill_id_s]["target"] = skill->gw_skill.target;
-        json["skills"]["by_id"][skill_id_s]["skill_equip_type"] = skill->gw_skill.skill_equip_type;
-        json["skills"]["by_id"][skill_id_s]["energy_cost"] = skill->gw_skill.energy_cost;
-        json["skills"]["by_id"][skill_id_s]["health_cost"] = skill->gw_skill.health_cost;
-        json["skills"]["by_id"][skill_id_s]["adrenaline"] = skill->gw_skill.adrenaline;
-        json["skills"]["by_id"][skill_id_s]["activation"] = skill->gw_skill.activation;
-        json["skills"]["by_id"][skill_id_s]["aftercast"] = skill->gw_skill.aftercast;
-        json["skills"]["by_id"][skill_id_s]["duration0"] = skill->gw_skill.duration0;
-        json["skills"]["by_id"][skill_id_s]["duration15"] = skill->gw_skill.duration15;
-        json["skills"]["by_id"][skill_id_s]["recharge"] = skill->gw_skill.recharge;
-        json["skills"]["by_id"][skill_id_s]["scale0"] = skill->gw_skill.scale0;
-        json["skills"]["by_id"][skill_id_s]["scale15"] = skill->gw_skill.scale15;
-        json["skills"]["by_id"][skill_id_s]["bonusScale0"] = skill->gw_skill.bonusScale0;
-        json["skills"]["by_id"][skill_id_s]["bonusScale15"] = skill->gw_skill.bonusScale15;
-        json["skills"]["by_id"][skill_id_s]["aoe_range"] = skill->gw_skill.aoe_range;
-        json["skills"]["by_id"][skill_id_s]["const_effect"] = skill->gw_skill.const_effect;
-        json["skills"]["by_id"][skill_id_s]["icon_file_id"] = skill->gw_skill.icon_file_id;
+    std::vector<SkillUsage> SkillUsages(const std::vector<GW::Constants::SkillID>& skill_ids, const std::function<const ObserverModule::ObservedSkill*(GW::Constants::SkillID)>& get)
+    {
+        std::vector<SkillUsage> usages;
+        usages.reserve(skill_ids.size());
+        for (const auto skill_id : skill_ids) {
+            if (const auto observed_skill = get(skill_id)) {
+                usages.push_back({skill_id, *observed_skill});
+            }
+        }
+        return usages;
     }
 
-    // parties
-    json["parties"]["ids"] = party_ids;
-    json["parties"]["by_id"] = {};
-    for (uint32_t party_id : party_ids) {
-        std::string party_id_s = std::to_string(party_id);
-        ObserverModule::ObservableParty* party = om.GetObservablePartyById(party_id);
-        if (!party) {
-            json["parties"]["by_id"][party_id_s] = nlohmann::json::value_t::null;
-            continue;
-        }
-        if (name_prepend_vs) {
-            name.append(" vs ");
-        }
-        name.append(party->display_name);
-        name_prepend_vs = true;
-        json["parties"]["by_id"][party_id_s]["party_id"] = party->party_id;
-        json["parties"]["by_id"][party_id_s]["name"] = party->name;
-        json["parties"]["by_id"][party_id_s]["display_name"] = party->display_name;
-        json["parties"]["by_id"][party_id_s]["is_victorious"] = party->is_victorious;
-        json["parties"]["by_id"][party_id_s]["is_defeated"] = party->is_defeated;
-        json["parties"]["by_id"][party_id_s]["guild_id"] = party->guild_id;
-        json["parties"]["by_id"][party_id_s]["agent_ids"] = party->agent_ids;
-        json["parties"]["by_id"][party_id_s]["rank"] = party->rank;
-        json["parties"]["by_id"][party_id_s]["rank_str"] = party->rank_str;
-        json["parties"]["by_id"][party_id_s]["rating"] = party->rating;
-        json["parties"]["by_id"][party_id_s]["stats"] = shared_stats_to_json(party->stats);
+    AgentSnapshot SnapshotAgent(ObserverModule::ObservableAgent& agent)
+    {
+        ObserverModule& om = ObserverModule::Instance();
+        const auto& stats = agent.stats;
+        AgentSnapshot snapshot;
+        snapshot.agent_id = agent.agent_id;
+        snapshot.display_name = agent.DisplayName();
+        snapshot.raw_name = agent.RawName();
+        snapshot.debug_name = agent.DebugName();
+        snapshot.sanitized_name = agent.SanitizedName();
+        snapshot.party_id = agent.party_id;
+        snapshot.party_index = agent.party_index;
+        snapshot.primary = agent.primary;
+        snapshot.secondary = agent.secondary;
+        snapshot.profession = agent.profession;
+        snapshot.guild_id = agent.guild_id;
+        snapshot.stats = stats;
+        for (const auto skill_id : stats.skill_ids_used) {
+            const auto skill = om.GetObservableSkillById(skill_id);
+            snapshot.skill_names_used.push_back(skill ? skill->Name() : "");
+        }
+        stats.attacks_dealt_to_agents.ForEach([&](const uint64_t target_id, const ObserverModule::ObservedAction* action) {
+            if (action) {
+                snapshot.attacks_dealt_to_agents.emplace_back(static_cast<uint32_t>(target_id), *action);
+            }
+        });
+        stats.attacks_received_from_agents.ForEach([&](const uint64_t caster_id, const ObserverModule::ObservedAction* action) {
+            if (action) {
+                snapshot.attacks_received_from_agents.emplace_back(static_cast<uint32_t>(caster_id), *action);
+            }
+        });
+        snapshot.skill_ids_used = stats.skill_ids_used;
+        snapshot.skills_used = SkillUsages(stats.skill_ids_used, [&stats](const GW::Constants::SkillID skill_id) {
+            return stats.skills_used.Find(std::to_underlying(skill_id));
+        });
+        snapshot.skill_ids_received = stats.skill_ids_received;
+        snapshot.skills_received = SkillUsages(stats.skill_ids_received, [&stats](const GW::Constants::SkillID skill_id) {
+            return stats.skills_received.Find(std::to_underlying(skill_id));
+        });
+        for (const auto& [target_id, skill_ids] : stats.skill_ids_used_on_agents) {
+            snapshot.skills_used_on_agents.emplace_back(target_id, SkillUsages(skill_ids, [&stats, target_id](const GW::Constants::SkillID skill_id) {
+                return stats.GetSkillUsedOn(target_id, skill_id);
+            }));
+        }
+        for (const auto& [caster_id, skill_ids] : stats.skill_ids_received_from_agents) {
+            snapshot.skills_received_from_agents.emplace_back(caster_id, SkillUsages(skill_ids, [&stats, caster_id](const GW::Constants::SkillID skill_id) {
+                return stats.GetSkillReceivedFrom(caster_id, skill_id);
+            }));
+        }
+        return snapshot;
     }
 
-    // agents
-    json["agents"]["ids"] = agent_ids;
-    json["agents"]["by_id"] = {};
-    for (uint32_t agent_id : agent_ids) {
-        std::string agent_id_s = std::to_string(agent_id);
-        ObserverModule::ObservableAgent* agent = om.GetObservableAgentById(agent_id);
-        if (!agent) {
-            json["agents"]["by_id"][agent_id_s] = nlohmann::json::value_t::null;
-            continue;
-        }
-        json["agents"]["by_id"][agent_id_s]["agent_id"] = agent->agent_id;
-        json["agents"]["by_id"][agent_id_s]["display_name"] = agent->DisplayName();
-        json["agents"]["by_id"][agent_id_s]["raw_name"] = agent->RawName();
-        json["agents"]["by_id"][agent_id_s]["debug_name"] = agent->DebugName();
-        json["agents"]["by_id"][agent_id_s]["sanitized_name"] = agent->SanitizedName();
-        json["agents"]["by_id"][agent_id_s]["party_id"] = agent->party_id;
-        json["agents"]["by_id"][agent_id_s]["party_index"] = agent->party_index;
-        json["agents"]["by_id"][agent_id_s]["primary"] = agent->primary;
-        json["agents"]["by_id"][agent_id_s]["secondary"] = agent->secondary;
-        json["agents"]["by_id"][agent_id_s]["profession"] = agent->profession;
-        json["agents"]["by_id"][agent_id_s]["guild_id"] = agent->guild_id;
-        json["agents"]["by_id"][agent_id_s]["stats"] = shared_stats_to_json(agent->stats);
-
-        // attacks
-
-        // attacks dealt (by agent)
-        for (auto& [target_id, action] : agent->stats.attacks_dealt_to_agents) {
-            std::string target_id_s = std::to_string(target_id);
-            if (!action) {
-                json["agents"]["by_id"][agent_id_s]["stats"]["attacks_dealt_to_agents"][target_id_s] = nlohmann::json::value_t::null;
+    // Call from the game thread
+    MatchSnapshot TakeSnapshot()
+    {
+        ObserverModule& om = ObserverModule::Instance();
+        MatchSnapshot snapshot;
+        snapshot.match_finished = om.match_finished;
+        snapshot.winning_party_id = om.winning_party_id;
+        snapshot.match_duration_ms_total = om.match_duration_ms_total.count();
+        snapshot.match_duration_ms = om.match_duration_ms.count();
+        snapshot.match_duration_secs = om.match_duration_secs.count();
+        snapshot.match_duration_mins = om.match_duration_mins.count();
+
+        if (const auto map = om.GetMap()) {
+            snapshot.map = MapSnapshot{
+                map->Name(), map->Description(), map->GetIsPvP(), map->GetIsGuildHall(),
+                map->campaign, map->continent, map->region, map->type, map->flags, map->name_id, map->description_id
+            };
+        }
+
+        // Agents first; looking up their skills may load skills that weren't observed yet
+        snapshot.agent_ids = om.GetObservableAgentIds();
+        for (const auto agent_id : snapshot.agent_ids) {
+            const auto agent = om.GetObservableAgentById(agent_id);
+            snapshot.agents.push_back(agent ? std::optional(SnapshotAgent(*agent)) : std::nullopt);
+        }
+
+        snapshot.guild_ids = om.GetObservableGuildIds();
+        for (const auto guild_id : snapshot.guild_ids) {
+            const auto guild = om.GetObservableGuildById(guild_id);
+            if (!guild) {
+                snapshot.guilds.emplace_back();
                 continue;
             }
-            json["agents"]["by_id"][agent_id_s]["stats"]["attacks_dealt_to_agents"][target_id_s] = action_to_json(*action);
+            snapshot.guilds.push_back(GuildSnapshot{
+                guild->guild_id, guild->key, guild->name, guild->tag, guild->wrapped_tag, guild->rank, guild->rating,
+                guild->faction, guild->faction_point, guild->qualifier_point, guild->cape_trim
+            });
         }
 
-        // attacks received (by agent)
-        for (auto& [caster_id, action] : agent->stats.attacks_received_from_agents) {
-            std::string caster_id_s = std::to_string(caster_id);
-            if (!action) {
-                json["agents"]["by_id"][agent_id_s]["stats"]["attacks_received_from_agents"][caster_id_s] = nlohmann::json::value_t::null;
+        snapshot.skill_ids = om.GetObservableSkillIds();
+        for (const auto skill_id : snapshot.skill_ids) {
+            const auto skill = om.GetObservableSkillById(skill_id);
+            if (!skill) {
+                snapshot.skills.emplace_back();
                 continue;
             }
-            json["agents"]["by_id"][agent_id_s]["stats"]["attacks_received_from_agents"][caster_id_s] = action_to_json(*action);
+            snapshot.skills.push_back(SkillSnapshot{skill->Name(), skill->stats, skill->gw_skill});
         }
 
-        // skills
-
-        // skills used
-        json["agents"]["by_id"][agent_id_s]["stats"]["skill_ids_used"] = agent->stats.skill_ids_used;
-        for (auto skill_id : agent->stats.skill_ids_used) {
-            std::string skill_id_s = std::to_string(std::to_underlying(skill_id));
-            const auto it_skill = agent->stats.skills_used.find(skill_id);
-            if (it_skill == agent->stats.skills_used.end()) {
-                json["agents"]["by_id"][agent_id_s]["stats"]["skills_used"][skill_id_s] = nlohmann::json::value_t::null;
+        snapshot.party_ids = om.GetObservablePartyIds();
+        for (const auto party_id : snapshot.party_ids) {
+            const auto party = om.GetObservablePartyById(party_id);
+            if (!party) {
+                snapshot.parties.emplace_back();
                 continue;
             }
-            json["agents"]["by_id"][agent_id_s]["stats"]["skills_used"][skill_id_s] = action_to_json(*it_skill->second);
-            json["agents"]["by_id"][agent_id_s]["stats"]["skills_used"][skill_id_s]["skill_id"] = it_skill->second->skill_id;
+            if (!snapshot.name.empty()) {
+                snapshot.name.append(" vs ");
+            }
+            snapshot.name.append(party->display_name);
+            snapshot.parties.push_back(PartySnapshot{
+                party->party_id, party->name, party->display_name, party->is_victorious, party->is_defeated, party->guild_id,
+                party->agent_ids, party->rank, party->rank_str, party->rating, party->stats
+            });
         }
+        return snapshot;
+    }
 
-        // skills received
-        json["agents"]["by_id"][agent_id_s]["stats"]["skill_ids_received"] = agent->stats.skill_ids_received;
-        for (auto skill_id : agent->stats.skill_ids_received) {
-            std::string skill_id_s = std::to_string(std::to_underlying(skill_id));
-            const auto it_skill = agent->stats.skills_received.find(skill_id);
-            if (it_skill == agent->stats.skills_received.end()) {
-                json["agents"]["by_id"][agent_id_s]["stats"]["skills_received"][skill_id_s] = nlohmann::json::value_t::null;
-                continue;
+    void WriteAction(JsonWriter& json, const ObserverModule::ObservedAction& action)
+    {
+        json.BeginObject();
+        json.Field("started", action.started);
+        json.Field("stopped", action.stopped);
+        json.Field("interrupted", action.interrupted);
+        json.Field("finished", action.finished);
+        json.Field("integrity", action.integrity);
+        json.EndObject();
+    }
+
+    void WriteBasicStats(JsonWriter& json, const ObserverModule::SharedStats& stats)
+    {
+        json.Field("total_crits_received", stats.total_crits_received);
+        json.Field("total_crits_dealt", stats.total_crits_dealt);
+        json.Field("total_party_crits_received", stats.total_party_crits_received);
+        json.Field("total_party_crits_dealt", stats.total_party_crits_dealt);
+        json.Field("knocked_down_count", stats.knocked_down_count);
+        json.Field("interrupted_count", stats.interrupted_count);
+        json.Field("interrupted_skills_count", stats.interrupted_skills_count);
+        json.Field("cancelled_count", stats.cancelled_count);
+        json.Field("cancelled_skills_count", stats.cancelled_skills_count);
+        json.Field("knocked_down_duration", stats.knocked_down_duration);
+        json.Field("deaths", stats.deaths);
+        json.Field("kills", stats.kills);
+        json.Field("kdr_str", stats.kdr_str);
+    }
+
+    // Leaves the stats object open so callers can add to it
+    void BeginSharedStats(JsonWriter& json, const ObserverModule::SharedStats& stats)
+    {
+        json.Key("stats").BeginObject();
+        WriteBasicStats(json, stats);
+        const std::pair<const char*, const ObserverModule::ObservedAction*> actions[] = {
+            {"total_attacks_dealt", &stats.total_attacks_dealt},
+            {"total_attacks_received", &stats.total_attacks_received},
+            {"total_attacks_dealt_to_other_parties", &stats.total_attacks_dealt_to_other_parties},
+            {"total_attacks_received_from_other_parties", &stats.total_attacks_received_from_other_parties},
+            {"total_skills_used", &stats.total_skills_used},
+            {"total_skills_received", &stats.total_skills_received},
+            {"total_skills_used_on_own_party", &stats.total_skills_used_on_own_party},
+            {"total_skills_used_on_other_parties", &stats.total_skills_used_on_other_parties},
+            {"total_skills_received_from_own_party", &stats.total_skills_received_from_own_party},
+            {"total_skills_received_from_other_parties", &stats.total_skills_received_from_other_parties},
+            {"total_skills_used_on_own_team", &stats.total_skills_used_on_own_team},
+            {"total_skills_used_on_other_teams", &stats.total_skills_used_on_other_teams},
+            {"total_skills_received_from_own_team", &stats.total_skills_received_from_own_team},
+            {"total_skills_received_from_other_teams", &stats.total_skills_received_from_other_teams},
+        };
+        for (const auto& [key, action] : actions) {
+            json.Key(key);
+            WriteAction(json, *action);
+        }
+    }
+
+    void WriteSkillUsages(JsonWriter& json, const std::vector<SkillUsage>& usages, const bool with_skill_id)
+    {
+        json.BeginObject();
+        for (const auto& [skill_id, action] : usages) {
+            json.Key(std::to_string(std::to_underlying(skill_id))).BeginObject();
+            json.Field("started", action.started);
+            json.Field("stopped", action.stopped);
+            json.Field("interrupted", action.interrupted);
+            json.Field("finished", action.finished);
+            json.Field("integrity", action.integrity);
+            if (with_skill_id) {
+                json.Field("skill_id", skill_id);
             }
-            json["agents"]["by_id"][agent_id_s]["stats"]["skills_received"][skill_id_s] = action_to_json(*it_skill->second);
-            json["agents"]["by_id"][agent_id_s]["stats"]["skills_received"][skill_id_s]["skill_id"] = it_skill->second->skill_id;
+            json.EndObject();
         }
+        json.EndObject();
+    }
 
-        // skills used (by agent)
-        for (auto& [target_id, agent_skill_ids] : agent->stats.skill_ids_used_on_agents) {
-            std::string target_id_s = std::to_string(target_id);
-            auto it_target = agent->stats.skills_used_on_agents.find(target_id);
-            if (it_target == agent->stats.skills_used_on_agents.end()) {
-                json["agents"]["by_id"][agent_id_s]["stats"]["skills_used_on_agents"][target_id_s] = nlohmann::json::value_t::null;
+    const AgentSnapshot* FindAgent(const MatchSnapshot& snapshot, const uint32_t agent_id)
+    {
+        const auto found = std::ranges::find(snapshot.agent_ids, agent_id);
+        if (found == snapshot.agent_ids.end()) {
+            return nullptr;
+        }
+        const auto& agent = snapshot.agents[found - snapshot.agent_ids.begin()];
+        return agent ? &*agent : nullptr;
+    }
+
+    // Version 0.1
+    void WriteMatch_V_0_1(JsonWriter& json, const MatchSnapshot& snapshot)
+    {
+        json.Key("parties").BeginArray();
+        for (const auto& party : snapshot.parties) {
+            // parties -> party
+            if (!party) {
+                json.Null();
                 continue;
             }
-            for (auto skill_id : agent_skill_ids) {
-                std::string skill_id_s = std::to_string(std::to_underlying(skill_id));
-                auto it_skill = it_target->second.find(skill_id);
-                if (it_skill == it_target->second.end()) {
-                    json["agents"]["by_id"][agent_id_s]["stats"]["skills_used_on_agents"][target_id_s][skill_id_s] = nlohmann::json::value_t::null;
+            json.BeginObject();
+            json.Field("party_id", party->party_id);
+            json.Key("stats").BeginObject();
+            WriteBasicStats(json, party->stats);
+            json.EndObject();
+            json.Key("members").BeginArray();
+            for (const auto agent_id : party->agent_ids) {
+                // parties -> party -> agents -> agent
+                const auto agent = FindAgent(snapshot, agent_id);
+                if (!agent) {
+                    json.Null();
                     continue;
                 }
-                json["agents"]["by_id"][agent_id_s]["stats"]["skills_used_on_agents"][target_id_s][skill_id_s] = action_to_json(*it_skill->second);
+                json.BeginObject();
+                json.Field("display_name", agent->display_name);
+                json.Field("raw_name", agent->raw_name);
+                json.Field("debug_name", agent->debug_name);
+                json.Field("sanitized_name", agent->sanitized_name);
+                json.Field("party_id", agent->party_id);
+                json.Field("party_index", agent->party_index);
+                json.Field("primary", agent->primary);
+                json.Field("secondary", agent->secondary);
+                json.Field("profession", agent->profession);
+                json.Key("stats").BeginObject();
+                WriteBasicStats(json, agent->stats);
+                json.EndObject();
+                json.EndObject();
             }
+            json.EndArray();
+            json.EndObject();
         }
+        json.EndArray();
 
-        // skills received (by agent)
-        for (auto& [caster_id, agent_skill_ids] : agent->stats.skill_ids_received_from_agents) {
-            std::string caster_id_s = std::to_string(caster_id);
-            auto it_target = agent->stats.skills_received_from_agents.find(caster_id);
-            if (it_target == agent->stats.skills_received_from_agents.end()) {
-                json["agents"]["by_id"][agent_id_s]["stats"]["skills_received_from_agents"][caster_id_s] = nlohmann::json::value_t::null;
+        // skills used by every party member, in party order
+        json.Key("skills").BeginArray();
+        for (const auto& party : snapshot.parties) {
+            if (!party) {
                 continue;
             }
-            for (auto skill_id : agent_skill_ids) {
-                std::string skill_id_s = std::to_string(std::to_underlying(skill_id));
-                auto it_skill = it_target->second.find(skill_id);
-                if (it_skill == it_target->second.end()) {
-                    json["agents"]["by_id"][agent_id_s]["stats"]["skills_received_from_agents"][caster_id_s][skill_id_s] = nlohmann::json::value_t::null;
+            for (const auto agent_id : party->agent_ids) {
+                const auto agent = FindAgent(snapshot, agent_id);
+                if (!agent) {
                     continue;
                 }
-                json["agents"]["by_id"][agent_id_s]["stats"]["skills_received_from_agents"][caster_id_s][skill_id_s] = action_to_json(*it_skill->second);
+                for (const auto& skill_name : agent->skill_names_used) {
+                    if (skill_name.empty()) {
+                        json.Null();
+                        continue;
+                    }
+                    json.BeginObject();
+                    json.Field("name", skill_name);
+                    json.EndObject();
+                }
+            }
+        }
+        json.EndArray();
+    }
+
+    // Version 1.0
+    void WriteMatch_V_1_0(JsonWriter& json, const MatchSnapshot& snapshot)
+    {
+        json.Field("match_finished", snapshot.match_finished);
+        json.Field("winning_party_id", snapshot.winning_party_id);
+        json.Field("match_duration_ms_total", snapshot.match_duration_ms_total);
+        json.Field("match_duration_ms", snapshot.match_duration_ms);
+        json.Field("match_duration_secs", snapshot.match_duration_secs);
+        json.Field("match_duration_mins", snapshot.match_duration_mins);
+
+        json.Key("map");
+        if (const auto& map = snapshot.map) {
+            json.BeginObject();
+            json.Field("name", map->name);
+            json.Field("description", map->description);
+            json.Field("is_pvp", map->is_pvp);
+            json.Field("is_guild_hall", map->is_guild_hall);
+            json.Field("campaign", map->campaign);
+            json.Field("continent", map->continent);
+            json.Field("region", map->region);
+            json.Field("type", map->type);
+            json.Field("flags", map->flags);
+            json.Field("name_id", map->name_id);
+            json.Field("description_id", map->description_id);
+            json.EndObject();
+        }
+        else {
+            json.Null();
+        }
+
+        // guilds
+        json.Key("guilds").BeginObject();
+        json.Key("ids").Array(snapshot.guild_ids);
+        json.Key("by_id").BeginObject();
+        for (size_t i = 0; i < snapshot.guild_ids.size(); i++) {
+            json.Key(std::to_string(snapshot.guild_ids[i]));
+            const auto& guild = snapshot.guilds[i];
+            if (!guild) {
+                json.Null();
+                continue;
+            }
+            json.BeginObject();
+            json.Field("guild_id", guild->guild_id);
+            json.Key("key").BeginArray();
+            for (const auto k : guild->key.k) {
+                json.Value(k);
+            }
+            json.EndArray();
+            json.Field("name", guild->name);
+            json.Field("tag", guild->tag);
+            json.Field("wrapped_tag", guild->wrapped_tag);
+            json.Field("rank", guild->rank);
+            json.Field("rating", guild->rating);
+            json.Field("faction", guild->faction);
+            json.Field("faction_point", guild->faction_point);
+            json.Field("qualifier_point", guild->qualifier_point);
+            json.Field("cape_trim", guild->cape_trim);
+            json.EndObject();
+        }
+        json.EndObject();
+        json.EndObject();
+
+        // skills
+        json.Key("skills").BeginObject();
+        json.Key("ids").Array(snapshot.skill_ids);
+        json.Key("by_id").BeginObject();
+        for (size_t i = 0; i < snapshot.skill_ids.size(); i++) {
+            json.Key(std::to_string(std::to_underlying(snapshot.skill_ids[i])));
+            const auto& skill = snapshot.skills[i];
+            if (!skill) {
+                json.Null();
+                continue;
+            }
+            const GW::Skill& gw_skill = skill->gw_skill;
+            json.BeginObject();
+            json.Field("skill_id", gw_skill.skill_id);
+            json.Field("name", skill->name);
+            json.Key("stats").BeginObject();
+            const std::pair<const char*, const ObserverModule::ObservedAction*> usages[] = {
+                {"total_usages", &skill->stats.total_usages},
+                {"total_self_usages", &skill->stats.total_self_usages},
+                {"total_other_usages", &skill->stats.total_other_usages},
+                {"total_own_party_usages", &skill->stats.total_own_party_usages},
+                {"total_other_party_usages", &skill->stats.total_other_party_usages},
+                {"total_own_team_usages", &skill->stats.total_own_team_usages},
+                {"total_other_team_usages", &skill->stats.total_other_team_usages},
+            };
+            for (const auto& [key, action] : usages) {
+                json.Key(key);
+                WriteAction(json, *action);
+            }
+            json.EndObject();
+            json.Field("campaign", gw_skill.campaign);
+            json.Field("type", gw_skill.type);
+            json.Field("sepcial", gw_skill.special);
+            json.Field("combo_req", gw_skill.combo_req);
+            json.Field("effect1", gw_skill.effect1);
+            json.Field("condition", gw_skill.condition);
+            json.Field("effect2", gw_skill.effect2);
+            json.Field("weapon_req", gw_skill.weapon_req);
+            json.Field("profession", gw_skill.profession);
+            json.Field("attribute", gw_skill.attribute);
+            json.Field("skill_id_pvp", gw_skill.skill_id_pvp);
+            json.Field("combo", gw_skill.combo);
+            json.Field("target", gw_skill.target);
+            json.Field("skill_equip_type", gw_skill.skill_equip_type);
+            json.Field("energy_cost", gw_skill.energy_cost);
+            json.Field("health_cost", gw_skill.health_cost);
+            json.Field("adrenaline", gw_skill.adrenaline);
+            json.Field("activation", gw_skill.activation);
+            json.Field("aftercast", gw_skill.aftercast);
+            json.Field("duration0", gw_skill.duration0);
+            json.Field("duration15", gw_skill.duration15);
+            json.Field("recharge", gw_skill.recharge);
+            json.Field("scale0", gw_skill.scale0);
+            json.Field("scale15", gw_skill.scale15);
+            json.Field("bonusScale0", gw_skill.bonusScale0);
+            json.Field("bonusScale15", gw_skill.bonusScale15);
+            json.Field("aoe_range", gw_skill.aoe_range);
+            json.Field("const_effect", gw_skill.const_effect);
+            json.Field("icon_file_id", gw_skill.icon_file_id);
+            json.EndObject();
+        }
+        json.EndObject();
+        json.EndObject();
+
+        // parties
+        json.Key("parties").BeginObject();
+        json.Key("ids").Array(snapshot.party_ids);
+        json.Key("by_id").BeginObject();
+        for (size_t i = 0; i < snapshot.party_ids.size(); i++) {
+            json.Key(std::to_string(snapshot.party_ids[i]));
+            const auto& party = snapshot.parties[i];
+            if (!party) {
+                json.Null();
+                continue;
+            }
+            json.BeginObject();
+            json.Field("party_id", party->party_id);
+            json.Field("name", party->name);
+            json.Field("display_name", party->display_name);
+            json.Field("is_victorious", party->is_victorious);
+            json.Field("is_defeated", party->is_defeated);
+            json.Field("guild_id", party->guild_id);
+            json.Key("agent_ids").Array(party->agent_ids);
+            json.Field("rank", party->rank);
+            json.Field("rank_str", party->rank_str);
+            json.Field("rating", party->rating);
+            BeginSharedStats(json, party->stats);
+            json.EndObject();
+            json.EndObject();
+        }
+        json.EndObject();
+        json.EndObject();
+
+        // agents
+        json.Key("agents").BeginObject();
+        json.Key("ids").Array(snapshot.agent_ids);
+        json.Key("by_id").BeginObject();
+        for (size_t i = 0; i < snapshot.agent_ids.size(); i++) {
+            json.Key(std::to_string(snapshot.agent_ids[i]));
+            const auto& agent = snapshot.agents[i];
+            if (!agent) {
+                json.Null();
+                continue;
+            }
+            json.BeginObject();
+            json.Field("agent_id", agent->agent_id);
+            json.Field("display_name", agent->display_name);
+            json.Field("raw_name", agent->raw_name);
+            json.Field("debug_name", agent->debug_name);
+            json.Field("sanitized_name", agent->sanitized_name);
+            json.Field("party_id", agent->party_id);
+            json.Field("party_index", agent->party_index);
+            json.Field("primary", agent->primary);
+            json.Field("secondary", agent->secondary);
+            json.Field("profession", agent->profession);
+            json.Field("guild_id", agent->guild_id);
+            BeginSharedStats(json, agent->stats);
+
+            // attacks
+            json.Key("attacks_dealt_to_agents").BeginObject();
+            for (const auto& [target_id, action] : agent->attacks_dealt_to_agents) {
+                json.Key(std::to_string(target_id));
+                WriteAction(json, action);
+            }
+            json.EndObject();
+            json.Key("attacks_received_from_agents").BeginObject();
+            for (const auto& [caster_id, action] : agent->attacks_received_from_agents) {
+                json.Key(std::to_string(caster_id));
+                WriteAction(json, action);
+            }
+            json.EndObject();
+
+            // skills
+            json.Key("skill_ids_used").Array(agent->skill_ids_used);
+            json.Key("skills_used");
+            WriteSkillUsages(json, agent->skills_used, true);
+            json.Key("skill_ids_received").Array(agent->skill_ids_received);
+            json.Key("skills_received");
+            WriteSkillUsages(json, agent->skills_received, true);
+
+            // skills by agent
+            json.Key("skills_used_on_agents").BeginObject();
+            for (const auto& [target_id, usages] : agent->skills_used_on_agents) {
+                json.Key(std::to_string(target_id));
+                WriteSkillUsages(json, usages, false);
+            }
+            json.EndObject();
+            json.Key("skills_received_from_agents").BeginObject();
+            for (const auto& [caster_id, usages] : agent->skills_received_from_agents) {
+                json.Key(std::to_string(caster_id));
+                WriteSkillUsages(json, usages, false);
+            }
+            json.EndObject();
+
+            json.EndObject(); // stats
+            json.EndObject();
+        }
+        json.EndObject();
+        json.EndObject();
+
+        json.Field("name", snapshot.name);
+    }
+
+    std::string ExportTime()
+    {
+        SYSTEMTIME time;
+        GetLocalTime(&time);
+        return ObserverExportWindow::PadLeft(std::to_string(time.wYear), 4, '0')
+               + "-"
+               + ObserverExportWindow::PadLeft(std::to_string(time.wMonth), 2, '0')
+               + "-"
+               + ObserverExportWindow::PadLeft(std::to_string(time.wDay), 2, '0')
+               + "T"
+               + ObserverExportWindow::PadLeft(std::to_string(time.wHour), 2, '0')
+               + "-"
+               + ObserverExportWindow::PadLeft(std::to_string(time.wMinute), 2, '0')
+               + "-"
+               + ObserverExportWindow::PadLeft(std::to_string(time.wSecond), 2, '0');
+    }
+
+    constexpr size_t export_buffer_size = 64 * 1024;
+
+    void AnnounceExport(const std::filesystem::path& file_location)
+    {
+        wchar_t file_location_wc[512];
+        size_t msg_len = 0;
+        const std::wstring message = file_location.wstring();
+
+        size_t max_len = _countof(file_location_wc) - 1;
+
+        for (wchar_t i : message) {
+            // Break on the end of the message
+            if (!i) {
+                break;
+            }
+            // Double escape backsashes
+            if (i == '\\') {
+                file_location_wc[msg_len++] = i;
             }
+            if (msg_len >= max_len) {
+                break;
+            }
+            file_location_wc[msg_len++] = i;
         }
+        file_location_wc[msg_len] = 0;
+        wchar_t chat_message[1024];
+        swprintf(chat_message, _countof(chat_message), L"Match exported to <a=1>\x200C%s</a>", file_location_wc);
+        WriteChat(GW::Chat::CHANNEL_GLOBAL, chat_message);
     }
 
-    json["name"] = name;
+    // Live export: one line of compact version 1.0 json per interval, appended to a file per match
+    std::mutex live_export_mutex;
+    std::filesystem::path live_export_file;
+    uint32_t live_export_instance_time = 0;
+    clock_t live_export_timer = 0;
+}
 
-    return json;
+void ObserverExportWindow::Initialize()
+{
+    ToolboxWindow::Initialize();
 }
 
 std::string ObserverExportWindow::PadLeft(std::string input, const uint8_t count, const char c)
@@ -405,46 +838,20 @@ std::string ObserverExportWindow::PadLeft(std::string input, const uint8_t count
 
 
 // Export as JSON
+// The match is copied on the calling (game) thread and written out on a worker thread, so large matches don't stall the game
 void ObserverExportWindow::ExportToJSON(Version version)
 {
-    nlohmann::json json;
-    std::string filename;
-    SYSTEMTIME time;
-    GetLocalTime(&time);
-    std::string year = std::to_string(time.wYear);
-    std::string month = std::to_string(time.wMonth);
-    std::string day = std::to_string(time.wDay);
-    std::string hour = std::to_string(time.wHour);
-    std::string minute = std::to_string(time.wMinute);
-    std::string second = std::to_string(time.wSecond);
-    std::string export_time = PadLeft(year, 4, '0')
-                              + "-"
-                              + PadLeft(month, 2, '0')
-                              + "-"
-                              + PadLeft(day, 2, '0')
-                              + "T"
-                              + PadLeft(hour, 2, '0')
-                              + "-"
-                              + PadLeft(minute, 2, '0')
-                              + "-"
-                              + PadLeft(second, 2, '0');
+    auto snapshot = std::make_shared<MatchSnapshot>(TakeSnapshot());
+    const std::string export_time = ExportTime();
 
+    std::string filename;
     switch (version) {
         case Version::V_0_1: {
-            json = ToJSON_V_0_1();
-            json["verson"] = "0.1";
-            json["exported_at_local"] = export_time;
             filename = export_time + "_observer.json";
-            json["filename"] = filename;
             break;
         }
         case Version::V_1_0: {
-            json = ToJSON_V_1_0();
-            json["verson"] = "1.0";
-            json["exported_at_local"] = export_time;
-            std::string name = json["name"].dump();
-            // remove quotation marks (come in from json.dump())
-            std::erase(name, '"');
+            std::string name = snapshot->name;
             // replace spaces with _
             std::ranges::transform(name, name.begin(), [](const unsigned char c) {
                 return static_cast<unsigned char>(c == ' ' ? '_' : c);
@@ -452,47 +859,99 @@ void ObserverExportWindow::ExportToJSON(Version version)
             // replace non-alphanumeric with "x" to make simply FS safe, but also show something is missing
             name = std::regex_replace(name, std::regex("[^A-Za-z0-9.-_]/g"), "x");
             filename = export_time + "_" + name + ".json";
-            json["filename"] = filename;
             break;
         }
         default: {
-            break;
+            return;
         }
     }
 
-    Resources::EnsureFolderExists(Resources::GetPath(L"observer"));
-    auto file_location = Resources::GetPath(L"observer\\" + TextUtils::StringToWString(filename));
-    if (exists(file_location)) {
-        std::filesystem::remove(file_location);
-    }
-
-    std::ofstream out(file_location);
-    out << json.dump();
-    out.close();
-    wchar_t file_location_wc[512];
-    size_t msg_len = 0;
-    const std::wstring message = file_location.wstring();
-
-    size_t max_len = _countof(file_location_wc) - 1;
+    Resources::EnqueueWorkerTask([snapshot, version, export_time, filename] {
+        Resources::EnsureFolderExists(Resources::GetPath(L"observer"));
+        const auto file_location = Resources::GetPath(L"observer\\" + TextUtils::StringToWString(filename));
 
-    for (wchar_t i : message) {
-        // Break on the end of the message
-        if (!i) {
-            break;
+        std::vector<char> buffer(export_buffer_size);
+        std::ofstream out(file_location, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            Log::Error("Failed to write %s", filename.c_str());
+            return;
         }
-        // Double escape backsashes
-        if (i == '\\') {
-            file_location_wc[msg_len++] = i;
+        // Only takes effect once the file is open, and before anything is written
+        out.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        JsonWriter json(out);
+        json.BeginObject();
+        switch (version) {
+            case Version::V_0_1:
+                WriteMatch_V_0_1(json, *snapshot);
+                json.Field("verson", "0.1");
+                break;
+            case Version::V_1_0:
+                WriteMatch_V_1_0(json, *snapshot);
+                json.Field("verson", "1.0");
+                break;
         }
-        if (msg_len >= max_len) {
-            break;
+        json.Field("exported_at_local", export_time);
+        json.Field("filename", filename);
+        json.EndObject();
+        out.close();
+        if (out.fail()) {
+            Log::Error("Failed to write %s", filename.c_str());
+            return;
         }
-        file_location_wc[msg_len++] = i;
+
+        GW::GameThread::Enqueue([file_location] {
+            AnnounceExport(file_location);
+        });
+    });
+}
+
+// Append the current state of the match to this match's live export file
+void ObserverExportWindow::AppendLiveExport()
+{
+    const auto instance_time = GW::Map::GetInstanceTime();
+    if (live_export_file.empty() || instance_time < live_export_instance_time) {
+        // New match
+        live_export_file = Resources::GetPath(L"observer\\" + TextUtils::StringToWString(ExportTime() + "_live.ndjson"));
+    }
+    live_export_instance_time = instance_time;
+
+    auto snapshot = std::make_shared<MatchSnapshot>(TakeSnapshot());
+    Resources::EnqueueWorkerTask([snapshot, file_location = live_export_file, instance_time, export_time = ExportTime()] {
+        std::lock_guard lock(live_export_mutex);
+        Resources::EnsureFolderExists(Resources::GetPath(L"observer"));
+
+        std::vector<char> buffer(export_buffer_size);
+        std::ofstream out(file_location, std::ios::binary | std::ios::app);
+        if (!out.is_open()) {
+            return;
+        }
+        out.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        JsonWriter json(out);
+        json.BeginObject();
+        json.Field("verson", "1.0");
+        json.Field("exported_at_local", export_time);
+        json.Field("instance_time_ms", instance_time);
+        WriteMatch_V_1_0(json, *snapshot);
+        json.EndObject();
+        out.put('\n');
+    }, Resources::TaskPriority::Low);
+}
+
+void ObserverExportWindow::Update(const float)
+{
+    if (!auto_export_interval || !ObserverModule::Instance().IsActive()) {
+        live_export_timer = 0;
+        live_export_file.clear();
+        return;
+    }
+    if (!live_export_timer) {
+        live_export_timer = TIMER_INIT();
+        return;
+    }
+    if (TIMER_DIFF(live_export_timer) >= static_cast<clock_t>(auto_export_interval) * 1000) {
+        live_export_timer = TIMER_INIT();
+        AppendLiveExport();
     }
-    file_location_wc[msg_len] = 0;
-    wchar_t chat_message[1024];
-    swprintf(chat_message, _countof(chat_message), L"Match exported to <a=1>\x200C%s</a>", file_location_wc);
-    WriteChat(GW::Chat::CHANNEL_GLOBAL, chat_message);
 }
 
 
@@ -525,6 +984,7 @@ void ObserverExportWindow::Draw(IDirect3DDevice9*)
 void ObserverExportWindow::LoadSettings(ToolboxIni* ini)
 {
     ToolboxWindow::LoadSettings(ini);
+    LOAD_UINT(auto_export_interval);
 }
 
 
@@ -532,10 +992,15 @@ void ObserverExportWindow::LoadSettings(ToolboxIni* ini)
 void ObserverExportWindow::SaveSettings(ToolboxIni* ini)
 {
     ToolboxWindow::SaveSettings(ini);
+    SAVE_UINT(auto_export_interval);
 }
 
 // Draw settings
 void ObserverExportWindow::DrawSettingsInternal()
 {
-    // No internal settings yet
+    int interval = static_cast<int>(auto_export_interval);
+    if (ImGui::InputInt("Live export interval (seconds)", &interval)) {
+        auto_export_interval = static_cast<uint32_t>(std::clamp(interval, 0, 3600));
+    }
+    ImGui::ShowHelp("While observing, append the match stats to a .ndjson file in the observer folder every this many seconds; one line of json each time.\n0 to disable.");
 }
@@ -19,14 +19,16 @@ public:
     };
 
     static std::string PadLeft(std::string input, uint8_t count, char c);
-    static nlohmann::json ToJSON_V_0_1();
-    static nlohmann::json ToJSON_V_1_0();
+    // Snapshots the match and writes it on a worker thread
     static void ExportToJSON(Version version);
+    // Appends the match as one line of compact json to this match's .ndjson file
+    static void AppendLiveExport();
 
     [[nodiscard]] const char* Name() const override { return "Observer Export"; };
     [[nodiscard]] const char* Icon() const override { return ICON_FA_EYE; }
     void Draw(IDirect3DDevice9* pDevice) override;
     void Initialize() override;
+    void Update(float delta) override;
 
     void LoadSettings(ToolboxIni* ini) override;
     void SaveSettings(ToolboxIni* ini) override;
@@ -37,4 +39,6 @@ protected:
     float text_medium = 0;
     float text_short = 0;
     float text_tiny = 0;
+
+    uint32_t auto_export_interval = 0; // Seconds between live exports while observing, 0 for none
 };
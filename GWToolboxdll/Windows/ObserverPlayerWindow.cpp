@@ -138,8 +138,8 @@ void ObserverPlayerWindow::DrawAction(const std::string& name, const ObserverMod
 }
 
 // Draw the skills of a player
-void ObserverPlayerWindow::DrawSkills(const std::unordered_map<GW::Constants::SkillID, ObserverModule::ObservedSkill*>& skills,
-                                      const std::vector<GW::Constants::SkillID>& skill_ids) const
+void ObserverPlayerWindow::DrawSkills(const std::vector<GW::Constants::SkillID>& skill_ids,
+                                      const std::function<const ObserverModule::ObservedSkill*(GW::Constants::SkillID)>& get_usages) const
 {
     auto i = 0u;
     for (auto skill_id : skill_ids) {
@@ -148,11 +148,11 @@ void ObserverPlayerWindow::DrawSkills(const std::unordered_map<GW::Constants::Sk
         if (!skill) {
             continue;
         }
-        auto it_usages = skills.find(skill_id);
-        if (it_usages == skills.end()) {
+        const auto usages = get_usages(skill_id);
+        if (!usages) {
             continue;
         }
-        DrawAction(("# " + std::to_string(i) + ". " + skill->Name()).c_str(), it_usages->second);
+        DrawAction(("# " + std::to_string(i) + ". " + skill->Name()).c_str(), usages);
     }
 }
 
@@ -193,7 +193,9 @@ void ObserverPlayerWindow::Draw(IDirect3DDevice9*)
             ImGui::Text("Skills:");
             DrawHeaders();
             ImGui::Separator();
-            DrawSkills(tracking->stats.skills_used, tracking->stats.skill_ids_used);
+            DrawSkills(tracking->stats.skill_ids_used, [tracking](const GW::Constants::SkillID skill_id) {
+                return tracking->stats.skills_used.Find(static_cast<uint32_t>(skill_id));
+            });
         }
 
         if (show_comparison && compared && !(!show_skills_used_on_self && tracking && compared->agent_id == tracking->agent_id)) {
@@ -202,11 +204,11 @@ void ObserverPlayerWindow::Draw(IDirect3DDevice9*)
             ImGui::Text(("Skills used on: "s + compared->DisplayName()).c_str());
             DrawHeaders();
             ImGui::Separator();
-            const auto it_used_on_agent_skills = tracking->stats.skills_used_on_agents.find(compared->agent_id);
             const auto it_used_on_agent_skill_ids = tracking->stats.skill_ids_used_on_agents.find(compared->agent_id);
-            if (it_used_on_agent_skills != tracking->stats.skills_used_on_agents.end() &&
-                it_used_on_agent_skill_ids != tracking->stats.skill_ids_used_on_agents.end()) {
-                DrawSkills(it_used_on_agent_skills->second, it_used_on_agent_skill_ids->second);
+            if (it_used_on_agent_skill_ids != tracking->stats.skill_ids_used_on_agents.end()) {
+                DrawSkills(it_used_on_agent_skill_ids->second, [tracking, compared](const GW::Constants::SkillID skill_id) {
+                    return tracking->stats.GetSkillUsedOn(compared->agent_id, skill_id);
+                });
             }
         }
     }
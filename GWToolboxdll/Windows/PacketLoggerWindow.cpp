@@ -17,11 +17,13 @@
 
 #include <Logger.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 
 #include <Modules/Resources.h>
 #include <Windows/PacketLoggerWindow.h>
 
 #include <GWToolbox.h>
+#include <Utils/PacketReplay.h>
 #include <Utils/TextUtils.h>
 #include <Utils/ToolboxUtils.h>
 namespace {
@@ -228,7 +230,7 @@ namespace {
         GW::HookEntry entry;
         GW::StoC::PacketCallback c;
 
-        GW::StoC::RegisterPacketCallback(&entry, 1, c);
+        FrameProfiler::RegisterPacketCallback(&entry, 1, c);
         if (original_handler_func == test_handler.handler_func) {
             GW::StoC::RemoveCallback(1, &entry);
             return; // GWCA not ready yet
@@ -524,6 +526,244 @@ namespace {
         }
     }
 
+    // Number of bytes PrintField would consume for this field
+    size_t FieldSize(const FieldType field, const uint32_t count)
+    {
+        switch (field) {
+            case FieldType::AgentId:
+            case FieldType::Float:
+            case FieldType::Byte:
+            case FieldType::Word:
+            case FieldType::Dword:
+                return 4;
+            case FieldType::Vect2:
+                return 8;
+            case FieldType::Vect3:
+                return 12;
+            case FieldType::Blob:
+            case FieldType::Array8:
+                return count;
+            case FieldType::String16:
+                return count * 2;
+            case FieldType::Array16:
+                return 4 + count * 2;
+            case FieldType::Array32:
+                return 4 + count * 4;
+            default:
+                return 0;
+        }
+    }
+
+    // Walks the fields the same way as PrintNestedField, but only counts the bytes. False if the packet would run past end.
+    bool MeasureNestedField(uint32_t* fields, const uint32_t n_fields,
+                            const uint32_t repeat, uint8_t** bytes, const uint8_t* end)
+    {
+        for (uint32_t rep = 0; rep < repeat; rep++) {
+            for (auto i = 0u; i < n_fields; i++) {
+                const uint32_t field = fields[i];
+                const uint32_t type = field >> 0 & 0xF;
+                const uint32_t size = field >> 4 & 0xF;
+                const uint32_t count = field >> 8 & 0xFFFF;
+                const FieldType field_type = GetField(type, size, count);
+
+                if (field_type != FieldType::NestedStruct) {
+                    *bytes += FieldSize(field_type, count);
+                    if (*bytes > end) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (*bytes + sizeof(uint32_t) > end) {
+                    return false;
+                }
+                uint32_t struct_count;
+                Serialize<uint32_t>(bytes, &struct_count);
+                if (!MeasureNestedField(fields + i + 1, n_fields - (i + 1), struct_count, bytes, end)) {
+                    return false;
+                }
+                break;
+            }
+        }
+        return true;
+    }
+
+    // Binary packet capture.
+    // PacketHandler copies raw packets into a single producer/single consumer ring buffer on the game thread,
+    // and a writer thread streams them to a .gwpcap file (see PacketReplay.h for the layout).
+    // Decoding happens later, against the handler field tables saved in the file.
+    using PacketReplay::capture_magic;
+    using PacketReplay::capture_version;
+    using PacketReplay::capture_max_packet_size;
+    using PacketReplay::CaptureRecord;
+    constexpr size_t capture_ring_size = 4 * 1024 * 1024; // Must be a power of 2
+
+    std::unique_ptr<uint8_t[]> capture_ring;
+    // Both only ever grow; wrap around is fine as long as capture_ring_size divides SIZE_MAX + 1
+    std::atomic<size_t> capture_write_pos = 0; // Written by the game thread
+    std::atomic<size_t> capture_read_pos = 0;  // Written by the writer thread
+    std::atomic<bool> capture_active = false;
+    std::atomic<uint32_t> capture_packets = 0;
+    std::atomic<uint32_t> capture_dropped = 0;
+    std::chrono::steady_clock::time_point capture_started;
+    std::filesystem::path capture_path;
+    std::jthread capture_thread;
+    bool capture_to_file = false;
+
+    void CaptureRingWrite(const size_t pos, const void* data, const size_t len)
+    {
+        const size_t offset = pos & (capture_ring_size - 1);
+        const size_t first = std::min(len, capture_ring_size - offset);
+        memcpy(capture_ring.get() + offset, data, first);
+        memcpy(capture_ring.get(), static_cast<const uint8_t*>(data) + first, len - first);
+    }
+
+    void CapturePacket(const uint32_t header, const uint8_t* content, const size_t size)
+    {
+        const auto write_pos = capture_write_pos.load(std::memory_order_relaxed);
+        const auto read_pos = capture_read_pos.load(std::memory_order_acquire);
+        if (capture_ring_size - (write_pos - read_pos) < sizeof(CaptureRecord) + size) {
+            capture_dropped++; // Writer thread can't keep up
+            return;
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - capture_started;
+        const CaptureRecord record = {
+            header,
+            static_cast<uint32_t>(size),
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count())
+        };
+        CaptureRingWrite(write_pos, &record, sizeof(record));
+        CaptureRingWrite(write_pos + sizeof(record), content, size);
+        capture_write_pos.store(write_pos + sizeof(record) + size, std::memory_order_release);
+        capture_packets++;
+    }
+
+    void CaptureWriter(const std::stop_token& stop_token, std::ofstream file)
+    {
+        while (true) {
+            // Check before draining, so that anything pushed before the stop request still makes it to the file
+            const bool stopping = stop_token.stop_requested();
+            const auto write_pos = capture_write_pos.load(std::memory_order_acquire);
+            const auto read_pos = capture_read_pos.load(std::memory_order_relaxed);
+            if (const size_t available = write_pos - read_pos) {
+                const size_t offset = read_pos & (capture_ring_size - 1);
+                const size_t first = std::min(available, capture_ring_size - offset);
+                file.write(reinterpret_cast<const char*>(capture_ring.get() + offset), static_cast<std::streamsize>(first));
+                file.write(reinterpret_cast<const char*>(capture_ring.get()), static_cast<std::streamsize>(available - first));
+                capture_read_pos.store(write_pos, std::memory_order_release);
+            }
+            if (stopping) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+
+    void WriteUInt32(std::ofstream& file, const uint32_t value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    bool ReadUInt32(std::ifstream& file, uint32_t* value)
+    {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(value), sizeof(*value)));
+    }
+
+    void StopCapture()
+    {
+        capture_active = false;
+        if (capture_thread.joinable()) {
+            capture_thread.request_stop();
+            capture_thread.join();
+            Log::Info("Captured %u packets to %s (%u dropped)", capture_packets.load(), capture_path.filename().string().c_str(), capture_dropped.load());
+        }
+    }
+
+    bool StartCapture()
+    {
+        StopCapture();
+        if (!game_server_handler.m_buffer) {
+            return false;
+        }
+        const auto folder = Resources::GetPath("captures");
+        if (!Resources::EnsureFolderExists(folder)) {
+            Log::Error("Failed to create %s", folder.string().c_str());
+            return false;
+        }
+        const auto now = std::time(nullptr);
+        char file_name[64];
+        std::strftime(file_name, sizeof(file_name), "%Y%m%d_%H%M%S.gwpcap", std::localtime(&now));
+        capture_path = folder / file_name;
+        std::ofstream file(capture_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            Log::Error("Failed to open %s", capture_path.string().c_str());
+            return false;
+        }
+        WriteUInt32(file, capture_magic);
+        WriteUInt32(file, capture_version);
+        WriteUInt32(file, game_server_handler.size());
+        for (const auto& handler : game_server_handler) {
+            WriteUInt32(file, handler.field_count);
+            file.write(reinterpret_cast<const char*>(handler.fields), handler.field_count * sizeof(*handler.fields));
+        }
+
+        if (!capture_ring) {
+            capture_ring = std::make_unique<uint8_t[]>(capture_ring_size);
+        }
+        capture_read_pos = capture_write_pos.load();
+        capture_packets = 0;
+        capture_dropped = 0;
+        capture_started = std::chrono::steady_clock::now();
+        capture_thread = std::jthread([file = std::move(file)](const std::stop_token& stop_token) mutable {
+            CaptureWriter(stop_token, std::move(file));
+        });
+        capture_active = true;
+        return true;
+    }
+
+    // Prints a .gwpcap file to the debug console, in the same format as live logging
+    void DecodeCapture(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        uint32_t magic = 0, version = 0, handler_count = 0;
+        if (!(ReadUInt32(file, &magic) && ReadUInt32(file, &version) && ReadUInt32(file, &handler_count))
+            || magic != capture_magic || version != capture_version) {
+            Log::Error("%s is not a valid packet capture", path.filename().string().c_str());
+            return;
+        }
+        std::vector<std::vector<uint32_t>> handler_fields(handler_count);
+        for (auto& fields : handler_fields) {
+            uint32_t field_count = 0;
+            if (!ReadUInt32(file, &field_count) || field_count > 0x1000) {
+                Log::Error("%s is not a valid packet capture", path.filename().string().c_str());
+                return;
+            }
+            fields.resize(field_count);
+            file.read(reinterpret_cast<char*>(fields.data()), field_count * sizeof(uint32_t));
+        }
+
+        printf("Packet capture %s {\n", path.filename().string().c_str());
+        CaptureRecord record;
+        std::vector<uint8_t> content;
+        while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+            if (record.size > capture_max_packet_size) {
+                break;
+            }
+            // Zero padded, so a field table that doesn't quite match the content can't read past the buffer
+            content.assign(record.size + 0x100, 0);
+            if (!file.read(reinterpret_cast<char*>(content.data()), record.size)) {
+                break;
+            }
+            printf("[%.3f] StoC packet(%u 0x%X) {\n", static_cast<double>(record.time_us) / 1000000.0, record.header, record.header);
+            if (record.header < handler_fields.size() && !handler_fields[record.header].empty()) {
+                auto& fields = handler_fields[record.header];
+                auto bytes = content.data();
+                PrintNestedField(fields.data() + 1, static_cast<uint32_t>(fields.size() - 1), 1, &bytes, 4);
+            }
+            printf("} endpacket(%u 0x%X)\n", record.header, record.header);
+        }
+        printf("} end of capture\n");
+    }
+
 }
 
 
@@ -566,6 +806,19 @@ void PacketLoggerWindow::PacketHandler(GW::HookStatus* status, GW::Packet::StoC:
     Serialize<uint32_t>(bytes, &header);
     ASSERT(packet->header == header);
 
+    if (capture_active) {
+        // Just copy the packet; formatting it here is what stalls the frame during busy fights
+        uint8_t* content = *bytes;
+        uint8_t* content_end = content;
+        if (MeasureNestedField(handler.fields + 1, handler.field_count - 1, 1, &content_end, content + capture_max_packet_size)) {
+            CapturePacket(header, content, static_cast<size_t>(content_end - content));
+        }
+        else {
+            capture_dropped++;
+        }
+        return;
+    }
+
     if (log_packet_content) {
         printf(PrefixTimestamp("StoC packet(%u 0x%X) {\n").c_str(), packet->header, packet->header);
         PrintNestedField(handler.fields + 1, handler.field_count - 1, 1, bytes, 4);
@@ -745,6 +998,47 @@ void PacketLoggerWindow::Draw(IDirect3DDevice9*)
     */
     ImGui::Checkbox("Log NPC Dialogs", &log_npc_dialogs);
     ImGui::ShowHelp("Log encoded strings and their translated output to debug console");
+    if (ImGui::Checkbox("Capture packets to file", &capture_to_file)) {
+        if (capture_to_file) {
+            capture_to_file = StartCapture();
+            if (capture_to_file && !logger_enabled) {
+                Enable();
+            }
+        }
+        else {
+            StopCapture();
+        }
+    }
+    ImGui::ShowHelp("Write raw incoming packets to a .gwpcap file in the captures folder instead of logging them to the debug console.\n"
+                    "Use this to record busy fights without dropping frames, then decode the file afterwards.");
+    if (capture_active) {
+        ImGui::SameLine();
+        ImGui::Text("%u packets captured, %u dropped", capture_packets.load(), capture_dropped.load());
+    }
+    else if (!capture_path.empty()) {
+        ImGui::SameLine();
+        if (ImGui::Button("Decode last capture")) {
+            Resources::EnqueueWorkerTask([path = capture_path] {
+                DecodeCapture(path);
+            }, Resources::TaskPriority::Low);
+        }
+        ImGui::ShowHelp("Print the contents of the last capture file to the debug console");
+        ImGui::SameLine();
+        if (ImGui::Button("Replay last capture")) {
+            GW::GameThread::Enqueue([path = capture_path] {
+                const auto result = PacketReplay::Replay(path);
+                if (!result.loaded) {
+                    Log::Error("%s is not a valid packet capture", path.filename().string().c_str());
+                    return;
+                }
+                Log::Info("Replayed %zu packets (%zu callbacks) in %.3f ms, %.0f packets/sec, %zu allocations",
+                          result.packets, result.dispatched, result.seconds * 1000.0,
+                          result.seconds > 0.0 ? static_cast<double>(result.packets) / result.seconds : 0.0, result.allocations);
+            });
+        }
+        ImGui::ShowHelp("Feed the last capture file through toolbox's observer and skill/damage monitor packet handlers, without passing it to the game.\n"
+                        "Allocations are only counted in debug builds.");
+    }
     if (ImGui::CollapsingHeader("Ignored Packets")) {
         if (ImGui::Button("Select All")) {
             for (size_t i = 0; i < game_server_handler.size(); i++) {
@@ -820,14 +1114,14 @@ void PacketLoggerWindow::Initialize()
         logger_enabled = false;
         Enable();
     }
-    GW::StoC::RegisterPacketCallback(&hook_entry, GAME_SMSG_DIALOG_BODY, OnMessagePacket);
-    GW::StoC::RegisterPacketCallback(&hook_entry, GAME_SMSG_DOA_COMPLETE_ZONE, OnMessagePacket);
-    GW::StoC::RegisterPacketCallback(&hook_entry, GAME_SMSG_SPEECH_BUBBLE, OnMessagePacket);
-    GW::StoC::RegisterPacketCallback(&hook_entry, GAME_SMSG_DIALOG_BUTTON, OnMessagePacket);
-    GW::StoC::RegisterPacketCallback(&hook_entry, GAME_SMSG_MISSION_OBJECTIVE_UPDATE_STRING, OnMessagePacket);
-    GW::StoC::RegisterPacketCallback(&hook_entry, GAME_SMSG_MISSION_OBJECTIVE_ADD, OnMessagePacket);
-    GW::StoC::RegisterPacketCallback(&hook_entry, GAME_SMSG_AGENT_DISPLAY_DIALOG, OnMessagePacket);
-    GW::StoC::RegisterPacketCallback(&hook_entry, GAME_SMSG_CHAT_MESSAGE_NPC, OnMessagePacket);
+    FrameProfiler::RegisterPacketCallback(&hook_entry, GAME_SMSG_DIALOG_BODY, OnMessagePacket);
+    FrameProfiler::RegisterPacketCallback(&hook_entry, GAME_SMSG_DOA_COMPLETE_ZONE, OnMessagePacket);
+    FrameProfiler::RegisterPacketCallback(&hook_entry, GAME_SMSG_SPEECH_BUBBLE, OnMessagePacket);
+    FrameProfiler::RegisterPacketCallback(&hook_entry, GAME_SMSG_DIALOG_BUTTON, OnMessagePacket);
+    FrameProfiler::RegisterPacketCallback(&hook_entry, GAME_SMSG_MISSION_OBJECTIVE_UPDATE_STRING, OnMessagePacket);
+    FrameProfiler::RegisterPacketCallback(&hook_entry, GAME_SMSG_MISSION_OBJECTIVE_ADD, OnMessagePacket);
+    FrameProfiler::RegisterPacketCallback(&hook_entry, GAME_SMSG_AGENT_DISPLAY_DIALOG, OnMessagePacket);
+    FrameProfiler::RegisterPacketCallback(&hook_entry, GAME_SMSG_CHAT_MESSAGE_NPC, OnMessagePacket);
 }
 
 void PacketLoggerWindow::OnMessagePacket(GW::HookStatus*, GW::Packet::StoC::PacketBase* packet)
@@ -938,6 +1232,8 @@ void PacketLoggerWindow::Disable()
     logger_enabled = false;
 }
 void PacketLoggerWindow::Terminate() {
+    StopCapture();
+    capture_to_file = false;
     ClearMessageLog();
 }
 void PacketLoggerWindow::Enable()
@@ -946,7 +1242,7 @@ void PacketLoggerWindow::Enable()
         return;
     }
     for (size_t i = 0; i < game_server_handler.size(); i++) {
-        GW::StoC::RegisterPacketCallback(
+        FrameProfiler::RegisterPacketCallback(
             &hook_entry, i, [this](GW::HookStatus* status, GW::Packet::StoC::PacketBase* packet) -> void {
                 PacketHandler(status, packet);
             }, -0x9000
@@ -24,6 +24,7 @@
 
 #include <Logger.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 
 #include <Modules/Resources.h>
 #include <Windows/PartySearchWindow.h>
@@ -264,23 +265,23 @@ void PartySearchWindow::Initialize()
         }
     });
     // local messages
-    GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_SEARCH_REMOVE, OnRegionPartyUpdated);
-    GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_SEARCH_SIZE, OnRegionPartyUpdated);
-    GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_SEARCH_ADVERTISEMENT, OnRegionPartyUpdated);
-    GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_SEARCH_TYPE, OnRegionPartyUpdated);
-
-    //GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_RE, OnRegionPartyUpdated);
-    GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_PLAYER_ADD, OnRegionPartyUpdated);
-    GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_PLAYER_REMOVE, OnRegionPartyUpdated);
-    GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_HENCHMAN_ADD, OnRegionPartyUpdated);
-    GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_HENCHMAN_REMOVE, OnRegionPartyUpdated);
-    GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_HERO_ADD, OnRegionPartyUpdated);
-    GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_HERO_REMOVE, OnRegionPartyUpdated);
-
-    GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_UPDATE_AGENT_PARTYSIZE, OnRegionPartyUpdated);
-    GW::StoC::RegisterPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_AGENT_DESTROY_PLAYER, OnRegionPartyUpdated);
-
-    GW::StoC::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_INSTANCE_LOADED, [](GW::HookStatus*, GW::Packet::StoC::PacketBase*) {
+    FrameProfiler::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_SEARCH_REMOVE, OnRegionPartyUpdated);
+    FrameProfiler::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_SEARCH_SIZE, OnRegionPartyUpdated);
+    FrameProfiler::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_SEARCH_ADVERTISEMENT, OnRegionPartyUpdated);
+    FrameProfiler::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_SEARCH_TYPE, OnRegionPartyUpdated);
+
+    //FrameProfiler::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_RE, OnRegionPartyUpdated);
+    FrameProfiler::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_PLAYER_ADD, OnRegionPartyUpdated);
+    FrameProfiler::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_PLAYER_REMOVE, OnRegionPartyUpdated);
+    FrameProfiler::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_HENCHMAN_ADD, OnRegionPartyUpdated);
+    FrameProfiler::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_HENCHMAN_REMOVE, OnRegionPartyUpdated);
+    FrameProfiler::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_HERO_ADD, OnRegionPartyUpdated);
+    FrameProfiler::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_PARTY_HERO_REMOVE, OnRegionPartyUpdated);
+
+    FrameProfiler::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_UPDATE_AGENT_PARTYSIZE, OnRegionPartyUpdated);
+    FrameProfiler::RegisterPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_AGENT_DESTROY_PLAYER, OnRegionPartyUpdated);
+
+    FrameProfiler::RegisterPostPacketCallback(&OnMessageLocal_Entry, GAME_SMSG_INSTANCE_LOADED, [](GW::HookStatus*, GW::Packet::StoC::PacketBase*) {
         Instance().refresh_parties = clock() + 2000;
     });
     refresh_parties = clock();
@@ -567,28 +568,7 @@ bool PartySearchWindow::IsLfpAlert(std::string& message) const
     if (!filter_alerts) {
         return true;
     }
-    std::regex word_regex;
-    std::smatch m;
-    static const auto regex_check = std::regex("^/(.*)/[a-z]?$", std::regex::ECMAScript | std::regex::icase);
-    for (const auto& word : alert_words) {
-        if (std::regex_search(word, m, regex_check)) {
-            try {
-                word_regex = std::regex(m._At(1).str(), std::regex::ECMAScript | std::regex::icase);
-            } catch (const std::exception&) {
-                // Silent fail; invalid regex
-            }
-            if (std::regex_search(message, word_regex)) {
-                return true;
-            }
-        }
-        else {
-            auto found = std::ranges::search(message, word, [](const char c1, const char c2) -> bool { return tolower(c1) == c2; }).begin();
-            if (found != message.end()) {
-                return true;
-            }
-        }
-    }
-    return false;
+    return alert_rules.Matches(message);
 }
 
 void PartySearchWindow::Draw(IDirect3DDevice9*)
@@ -759,6 +739,7 @@ void PartySearchWindow::DrawAlertsWindowContent(bool)
     if (ImGui::InputTextMultiline("##alertfilter", alert_buf, ALERT_BUF_SIZE,
                                   ImVec2(-1.0f, 0.0f))) {
         ParseBuffer(alert_buf, alert_words);
+        alert_rules.Build(alert_words);
         alertfile_dirty = true;
     }
 }
@@ -780,6 +761,7 @@ void PartySearchWindow::LoadSettings(ToolboxIni* ini)
         alert_file.get(alert_buf, ALERT_BUF_SIZE, '\0');
         alert_file.close();
         ParseBuffer(alert_buf, alert_words);
+        alert_rules.Build(alert_words);
     }
     alert_file.close();
 }
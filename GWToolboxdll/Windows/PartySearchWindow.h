@@ -3,6 +3,7 @@
 #include <CircurlarBuffer.h>
 #include <ToolboxWindow.h>
 #include <Utils/RateLimiter.h>
+#include <Utils/AlertRules.h>
 
 class PartySearchWindow : public ToolboxWindow {
 public:
@@ -91,6 +92,7 @@ private:
     bool filter_alerts = false;
     char search_buffer[256] = {0};
     std::vector<std::string> alert_words{};
+    AlertRules alert_rules;
     std::vector<std::string> searched_words{};
     // tasks to be done async by the worker thread
     std::queue<std::function<void()>> thread_jobs{};
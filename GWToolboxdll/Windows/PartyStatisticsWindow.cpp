@@ -19,6 +19,7 @@
 
 #include <Modules/Resources.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 #include <Timer.h>
 #include <Windows/PartyStatisticsWindow.h>
 #include <Utils/TextUtils.h>
@@ -556,10 +557,10 @@ void PartyStatisticsWindow::Initialize()
 
     GW::Chat::CreateCommand(&ChatCmd_HookEntry,L"skillstats", CmdSkillStatistics);
 
-    GW::StoC::RegisterPostPacketCallback<GW::Packet::StoC::MapLoaded>(&MapLoaded_Entry, &MapLoadedCallback);
+    FrameProfiler::RegisterPostPacketCallback<GW::Packet::StoC::MapLoaded>(&MapLoaded_Entry, &MapLoadedCallback);
 
     /* Skill on self or party player */
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericValue>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::GenericValue>(
         &GenericValueSelf_Entry, [this](const GW::HookStatus*, const GW::Packet::StoC::GenericValue* packet) -> void {
             const uint32_t value_id = packet->value_id;
             const uint32_t caster_id = packet->agent_id;
@@ -570,7 +571,7 @@ void PartyStatisticsWindow::Initialize()
         });
 
     /* Skill on enemy player */
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericValueTarget>(
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::GenericValueTarget>(
         &GenericValueTarget_Entry,
         [this](const GW::HookStatus*, const GW::Packet::StoC::GenericValueTarget* packet) -> void {
             const uint32_t value_id = packet->Value_id;
@@ -41,6 +41,8 @@ namespace {
     }
 
     Pathing::AStar* astar = nullptr;
+    // Cancels the previous search if another one is requested before it starts
+    Resources::CancellationToken pending_search;
     size_t draw_pos = 0;
     clock_t last_draw = 0;
 
@@ -80,6 +82,10 @@ namespace {
             return;
         delete astar;
         astar = nullptr;
+        if (pending_search) {
+            *pending_search = true;
+        }
+        pending_search = Resources::CreateCancellationToken();
         Resources::EnqueueWorkerTask([from, to] {
             const auto milepath = GetMilepathForCurrentMap();
             if (!milepath) {
@@ -101,7 +107,7 @@ namespace {
             draw_pos = 0;
             last_draw = 0;
             astar = tmpAstar;
-        });
+        }, Resources::TaskPriority::High, pending_search);
     }
 
 }
@@ -139,6 +145,8 @@ void PathfindingWindow::Draw(IDirect3DDevice9*)
         ImGui::ProgressBar(static_cast<float>(current_milepath->progress()) * 0.01f, ImVec2(-1.0f, 0.0f));
         return ImGui::End();
     }
+    const auto& vis_graph = current_milepath->m_visGraph;
+    ImGui::Text("Visibility graph: %d points, %d edges, %.2f MB", vis_graph.NodeCount(), vis_graph.EdgeCount(), static_cast<float>(vis_graph.MemoryUsage()) / (1024.f * 1024.f));
 
     auto player = GW::Agents::GetObservingAgent();
     if (!player) {
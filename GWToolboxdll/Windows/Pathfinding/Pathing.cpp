@@ -5,6 +5,7 @@
 #include <GWCA/Context/MapContext.h>
 
 #include <Logger.h>
+#include <Modules/Resources.h>
 #include "MathUtility.h"
 #include "Pathing.h"
 
@@ -58,6 +59,347 @@ namespace {
         return FileHashToFileId((wchar_t*)sub_deets[1]);
     };
 
+    // [begin, end) range of indices, packed into one atomic so that the owner (claiming from the front) and
+    // other threads (stealing the back half) can both claim work with a single compare-exchange.
+    class WorkRange {
+        std::atomic<uint64_t> range = 0;
+
+        static uint64_t Pack(const uint32_t begin, const uint32_t end)
+        {
+            return static_cast<uint64_t>(end) << 32 | begin;
+        }
+
+    public:
+        void Reset(const uint32_t begin, const uint32_t end)
+        {
+            range = Pack(begin, end);
+        }
+
+        // Claim up to count indices from the front of the range. False if the range is empty.
+        bool Take(const uint32_t count, uint32_t& begin, uint32_t& end)
+        {
+            auto current = range.load();
+            while (true) {
+                const auto b = static_cast<uint32_t>(current);
+                const auto e = static_cast<uint32_t>(current >> 32);
+                if (b >= e)
+                    return false;
+                const auto n = std::min(b + count, e);
+                if (range.compare_exchange_weak(current, Pack(n, e))) {
+                    begin = b;
+                    end = n;
+                    return true;
+                }
+            }
+        }
+
+        // Claim the back half of the range (all of it, if only one index is left). False if the range is empty.
+        bool Steal(uint32_t& begin, uint32_t& end)
+        {
+            auto current = range.load();
+            while (true) {
+                const auto b = static_cast<uint32_t>(current);
+                const auto e = static_cast<uint32_t>(current >> 32);
+                if (b >= e)
+                    return false;
+                const auto mid = b + (e - b) / 2;
+                if (range.compare_exchange_weak(current, Pack(b, mid))) {
+                    begin = mid;
+                    end = e;
+                    return true;
+                }
+            }
+        }
+    };
+
+    // Min pairing heap of point ids with decrease-key. Node storage is indexed by id and kept between searches.
+    class PairingHeap {
+        struct Node {
+            float key = 0.f;
+            int32_t child = -1;
+            int32_t sibling = -1;
+            int32_t prev = -1; // parent if this is the leftmost child, otherwise the left sibling
+        };
+
+        std::vector<Node> nodes;          // [id]
+        std::vector<uint32_t> heap_stamp; // [id], == generation while the id is in the heap
+        std::vector<int32_t> pairs;       // scratch for Pop()
+        uint32_t generation = 0;
+        int32_t root = -1;
+
+        // Links two roots, returns the new root
+        int32_t Meld(int32_t a, int32_t b)
+        {
+            if (a < 0) return b;
+            if (b < 0) return a;
+            if (nodes[b].key < nodes[a].key)
+                std::swap(a, b);
+            auto& parent = nodes[a];
+            auto& child = nodes[b];
+            child.prev = a;
+            child.sibling = parent.child;
+            if (parent.child >= 0)
+                nodes[parent.child].prev = b;
+            parent.child = b;
+            return a;
+        }
+
+    public:
+        // Empties the heap and makes room for ids up to count - 1
+        void Reset(const size_t count)
+        {
+            if (nodes.size() < count) {
+                nodes.resize(count);
+                heap_stamp.resize(count, 0);
+            }
+            if (++generation == 0) {
+                std::ranges::fill(heap_stamp, 0u);
+                generation = 1;
+            }
+            root = -1;
+        }
+
+        [[nodiscard]] bool Empty() const { return root < 0; }
+        [[nodiscard]] bool Contains(const int32_t id) const { return heap_stamp[id] == generation; }
+
+        void Push(const int32_t id, const float key)
+        {
+            nodes[id] = {key, -1, -1, -1};
+            heap_stamp[id] = generation;
+            root = Meld(root, id);
+        }
+
+        void PushOrDecrease(const int32_t id, const float key)
+        {
+            if (!Contains(id))
+                return Push(id, key);
+            auto& node = nodes[id];
+            if (key >= node.key)
+                return;
+            node.key = key;
+            if (id == root)
+                return;
+            // Cut the subtree loose and meld it back in at the root
+            auto& prev = nodes[node.prev];
+            if (prev.child == id)
+                prev.child = node.sibling;
+            else
+                prev.sibling = node.sibling;
+            if (node.sibling >= 0)
+                nodes[node.sibling].prev = node.prev;
+            node.sibling = node.prev = -1;
+            root = Meld(root, id);
+        }
+
+        int32_t Pop()
+        {
+            const auto top = root;
+            heap_stamp[top] = 0;
+            // Two pass merge of the children: pair them left to right, then meld the pairs right to left
+            pairs.clear();
+            for (auto child = nodes[top].child; child >= 0;) {
+                const auto next = nodes[child].sibling;
+                nodes[child].sibling = nodes[child].prev = -1;
+                pairs.push_back(child);
+                child = next;
+            }
+            size_t paired = 0;
+            for (size_t i = 0; i + 1 < pairs.size(); i += 2) {
+                pairs[paired++] = Meld(pairs[i], pairs[i + 1]);
+            }
+            if (pairs.size() % 2)
+                pairs[paired++] = pairs.back();
+            root = -1;
+            while (paired) {
+                root = Meld(root, pairs[--paired]);
+            }
+            if (root >= 0)
+                nodes[root].prev = -1;
+            return top;
+        }
+    };
+
+    // Per search arrays, reused between searches (guarded by pathing_mutex).
+    // cost and came_from entries are only meaningful for ids whose stamp matches the current generation.
+    struct SearchState {
+        std::vector<float> cost;
+        std::vector<int32_t> came_from;
+        std::vector<uint32_t> stamp;
+        std::vector<int> goal_edge; // [point.id] -> index into the goal's edges, -1 if none. Left all -1 after a search.
+        std::vector<float> goal_landmark_from;
+        std::vector<float> goal_landmark_to;
+        PairingHeap open;
+        uint32_t generation = 0;
+
+        void Reset(const size_t node_count)
+        {
+            if (cost.size() < node_count) {
+                cost.resize(node_count);
+                came_from.resize(node_count);
+                stamp.resize(node_count, 0);
+                goal_edge.resize(node_count, -1);
+            }
+            if (++generation == 0) {
+                std::ranges::fill(stamp, 0u);
+                generation = 1;
+            }
+            open.Reset(node_count);
+        }
+
+        [[nodiscard]] bool Visited(const int32_t id) const { return stamp[id] == generation; }
+
+        void SetCost(const int32_t id, const float c, const int32_t from)
+        {
+            stamp[id] = generation;
+            cost[id] = c;
+            came_from[id] = from;
+        }
+    };
+
+    SearchState search_state;
+
+    // Bump when the layout of the pathing cache, or anything that changes the generated graph, changes
+    constexpr uint32_t pathing_cache_version = 1;
+    constexpr uint32_t pathing_cache_magic = 0x50545747; // "GWTP"
+
+    struct PathingCacheHeader {
+        uint32_t magic = pathing_cache_magic;
+        uint32_t version = pathing_cache_version;
+        uint32_t map_id = 0;
+        uint32_t aabb_count = 0;
+        uint64_t geometry_hash = 0;
+        float max_visibility_range = 0.f;
+    };
+
+    struct CachedPortal {
+        GW::Vec2f start, goal;
+        uint32_t box1, box2;
+    };
+
+    struct CachedPoint {
+        GW::Vec2f pos;
+        int32_t box, box2, portal; // -1 if none
+    };
+
+    // Appends trivially copyable values and count-prefixed arrays to a byte buffer
+    class CacheWriter {
+    public:
+        std::vector<uint8_t> buffer;
+
+        template <typename T>
+        void Write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+        }
+
+        template <typename T>
+        void WriteArray(const std::vector<T>& values)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            Write(static_cast<uint32_t>(values.size()));
+            const auto bytes = reinterpret_cast<const uint8_t*>(values.data());
+            buffer.insert(buffer.end(), bytes, bytes + values.size() * sizeof(T));
+        }
+    };
+
+    // Reads back what CacheWriter wrote; every read fails once the data runs out
+    class CacheReader {
+        const uint8_t* cursor;
+        const uint8_t* end;
+
+    public:
+        CacheReader(const uint8_t* data, const size_t size)
+            : cursor(data),
+              end(data + size) {}
+
+        template <typename T>
+        bool Read(T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            if (static_cast<size_t>(end - cursor) < sizeof(T))
+                return false;
+            memcpy(&value, cursor, sizeof(T));
+            cursor += sizeof(T);
+            return true;
+        }
+
+        template <typename T>
+        bool ReadArray(std::vector<T>& values)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            uint32_t count = 0;
+            if (!Read(count) || static_cast<size_t>(end - cursor) / sizeof(T) < count)
+                return false;
+            values.resize(count);
+            memcpy(values.data(), cursor, count * sizeof(T));
+            cursor += count * sizeof(T);
+            return true;
+        }
+
+        [[nodiscard]] bool AtEnd() const { return cursor == end; }
+    };
+
+    // CSR offsets from a cache file: one more than the number of rows, never decreasing and ending at the size of the array they index
+    bool IsValidOffsets(const std::vector<uint32_t>& offsets, const size_t rows, const size_t indexed_size)
+    {
+        if (offsets.size() != rows + 1 || offsets.front() != 0 || offsets.back() != indexed_size)
+            return false;
+        return std::ranges::is_sorted(offsets);
+    }
+
+    // Read-only view of a whole file, memory mapped
+    class MappedFile {
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+        const uint8_t* view = nullptr;
+        size_t view_size = 0;
+
+    public:
+        MappedFile(const std::filesystem::path& path)
+        {
+            file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                return;
+            LARGE_INTEGER file_size;
+            if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0)
+                return;
+            mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping)
+                return;
+            view = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (view)
+                view_size = static_cast<size_t>(file_size.QuadPart);
+        }
+
+        ~MappedFile()
+        {
+            if (view)
+                UnmapViewOfFile(view);
+            if (mapping)
+                CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE)
+                CloseHandle(file);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] const uint8_t* data() const { return view; }
+        [[nodiscard]] size_t size() const { return view_size; }
+    };
+
+    // FNV-1a over the raw bytes of a value
+    template <typename T>
+    void HashBytes(uint64_t& hash, const T& value)
+    {
+        const auto bytes = reinterpret_cast<const uint8_t*>(&value);
+        for (size_t i = 0; i < sizeof(T); i++) {
+            hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+        }
+    }
+
     bool IsTravelPortal(GW::MapProp* prop)
     {
         switch (GetMapPropModelFileId(prop)) {
@@ -239,7 +581,8 @@ namespace Pathing {
 
     void MilePath::LoadMapSpecificData()
     {
-        m_msd = MapSpecific::MapSpecificData(Map::GetMapID());
+        m_map_id = Map::GetMapID();
+        m_msd = MapSpecific::MapSpecificData(m_map_id);
         m_teleports = m_msd.m_teleports;
     }
 
@@ -266,6 +609,23 @@ namespace Pathing {
             LoadMapSpecificData();
             LoadTravelPortals();
             GenerateAABBs();
+            if (LoadFromCache()) {
+                GenerateTeleportGraph();
+                GeneratePointGrid();
+#ifdef _DEBUG
+                Log::Flash("Pathing loaded from cache in %d ms", clock() - start);
+#endif
+                m_done = true;
+                m_progress = 100;
+                // Paths can be searched right away; landmarks only tighten the heuristic once the worker has them in
+                ASSERT(!worker_thread);
+                worker_thread = new std::thread([&] {
+                    GenerateLandmarks();
+                    m_processing = false;
+                });
+                worker_thread->detach();
+                return;
+            }
             GenerateAABBGraph(); //not threaded because it relies on gw client Query altitude.
             ASSERT(!worker_thread);
             worker_thread = new std::thread([&, start] {
@@ -273,18 +633,209 @@ namespace Pathing {
                 GenerateVisibilityGraph();
                 GenerateTeleportGraph();
                 InsertTeleportsIntoVisibilityGraph();
+                CompactVisibilityGraph();
+                GeneratePointGrid();
+                if (!m_terminateThread)
+                    SaveToCache();
 #ifdef _DEBUG
                 const clock_t stop = clock();
                 Log::Flash("Processing %s in %d ms", m_terminateThread ? "terminated" : "done", stop - start);
 #endif
-                m_processing = false;
                 m_done = true;
                 m_progress = 100;
+                // Paths can be searched from here on; landmarks only tighten the heuristic once they're in
+                GenerateLandmarks();
+                m_processing = false;
             });
             worker_thread->detach();
         });
     }
 
+    std::filesystem::path MilePath::GetCachePath() const
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (const auto& t : m_trapezoids) {
+            HashBytes(hash, t.id);
+            HashBytes(hash, t.layer);
+            HashBytes(hash, t.a);
+            HashBytes(hash, t.b);
+            HashBytes(hash, t.c);
+            HashBytes(hash, t.d);
+        }
+        return Resources::GetPath("cache") / "pathing" / std::format("{}_{:016x}.bin", static_cast<uint32_t>(m_map_id), hash);
+    }
+
+    bool MilePath::LoadFromCache()
+    {
+        if (m_aabbs.empty())
+            return false;
+        const auto path = GetCachePath();
+        if (!std::filesystem::exists(path))
+            return false;
+
+        const MappedFile file(path);
+        if (!file.data())
+            return false;
+        CacheReader reader(file.data(), file.size());
+
+        PathingCacheHeader header;
+        if (!reader.Read(header)
+            || header.magic != pathing_cache_magic
+            || header.version != pathing_cache_version
+            || header.map_id != static_cast<uint32_t>(m_map_id)
+            || header.aabb_count != m_aabbs.size()
+            || header.max_visibility_range != max_visibility_range) {
+            return false;
+        }
+
+        std::vector<CachedPortal> portals;
+        std::vector<uint32_t> aabb_graph_offsets;
+        std::vector<uint32_t> aabb_graph_ids;
+        std::vector<CachedPoint> points;
+        VisGraph vis_graph;
+        if (!(reader.ReadArray(portals)
+              && reader.ReadArray(aabb_graph_offsets)
+              && reader.ReadArray(aabb_graph_ids)
+              && reader.ReadArray(points)
+              && reader.ReadArray(vis_graph.m_offsets)
+              && reader.ReadArray(vis_graph.m_edges)
+              && reader.ReadArray(vis_graph.m_blocking_spans)
+              && reader.ReadArray(vis_graph.m_blocking_pool)
+              && reader.AtEnd())) {
+            Log::Warning("Pathing cache %s is truncated", path.filename().string().c_str());
+            return false;
+        }
+
+        // Validate every index before handing out pointers
+        const auto aabb_count = m_aabbs.size();
+        if (!IsValidOffsets(aabb_graph_offsets, aabb_count, aabb_graph_ids.size())
+            || !IsValidOffsets(vis_graph.m_offsets, points.size(), vis_graph.m_edges.size())
+            || vis_graph.m_blocking_spans.empty()) {
+            return false;
+        }
+        for (const auto& portal : portals) {
+            if (portal.box1 >= aabb_count || portal.box2 >= aabb_count)
+                return false;
+        }
+        for (const auto id : aabb_graph_ids) {
+            if (id >= aabb_count)
+                return false;
+        }
+        const auto valid_index = [](const int32_t idx, const size_t size) { return idx >= -1 && idx < static_cast<int32_t>(size); };
+        for (const auto& p : points) {
+            if (!(valid_index(p.box, aabb_count) && valid_index(p.box2, aabb_count) && valid_index(p.portal, portals.size())))
+                return false;
+        }
+        for (const auto& edge : vis_graph.m_edges) {
+            if (edge.point_id < 0 || static_cast<size_t>(edge.point_id) >= points.size() || edge.blocking_span >= vis_graph.m_blocking_spans.size())
+                return false;
+        }
+        for (const auto& [offset, count] : vis_graph.m_blocking_spans) {
+            if (static_cast<size_t>(offset) + count > vis_graph.m_blocking_pool.size())
+                return false;
+        }
+
+        m_portals.clear();
+        m_portals.reserve(portals.size());
+        m_PTPortalGraph.clear();
+        m_PTPortalGraph.resize(aabb_count * 2);
+        for (const auto& portal : portals) {
+            const auto& portal_obj = m_portals.emplace_back(portal.start, portal.goal, &m_aabbs[portal.box1], &m_aabbs[portal.box2]);
+            m_PTPortalGraph[portal_obj.m_box1->m_t->id].emplace_back(&portal_obj);
+            m_PTPortalGraph[portal_obj.m_box2->m_t->id].emplace_back(&portal_obj);
+        }
+
+        m_AABBgraph.clear();
+        m_AABBgraph.resize(aabb_count);
+        for (size_t i = 0; i < aabb_count; i++) {
+            for (auto j = aabb_graph_offsets[i]; j < aabb_graph_offsets[i + 1]; j++) {
+                m_AABBgraph[i].emplace_back(&m_aabbs[aabb_graph_ids[j]]);
+            }
+        }
+
+        m_points.clear();
+        m_points.reserve(points.size());
+        for (const auto& p : points) {
+            auto& pt = m_points.emplace_back();
+            pt.id = static_cast<point::Id>(m_points.size() - 1);
+            pt.pos = p.pos;
+            pt.box = p.box >= 0 ? &m_aabbs[p.box] : nullptr;
+            pt.box2 = p.box2 >= 0 ? &m_aabbs[p.box2] : nullptr;
+            pt.portal = p.portal >= 0 ? &m_portals[p.portal] : nullptr;
+        }
+
+        m_visGraph = std::move(vis_graph);
+        return true;
+    }
+
+    bool MilePath::SaveToCache() const
+    {
+        CacheWriter writer;
+        PathingCacheHeader header;
+        header.map_id = static_cast<uint32_t>(m_map_id);
+        header.aabb_count = static_cast<uint32_t>(m_aabbs.size());
+        header.max_visibility_range = max_visibility_range;
+        writer.Write(header);
+
+        const auto box_index = [this](const AABB* box) {
+            return box ? static_cast<int32_t>(box - m_aabbs.data()) : -1;
+        };
+
+        std::vector<CachedPortal> portals;
+        portals.reserve(m_portals.size());
+        for (const auto& portal : m_portals) {
+            portals.push_back({portal.m_start, portal.m_goal, static_cast<uint32_t>(box_index(portal.m_box1)), static_cast<uint32_t>(box_index(portal.m_box2))});
+        }
+        writer.WriteArray(portals);
+
+        std::vector<uint32_t> aabb_graph_offsets;
+        std::vector<uint32_t> aabb_graph_ids;
+        aabb_graph_offsets.push_back(0);
+        for (const auto& neighbours : m_AABBgraph) {
+            for (const auto box : neighbours) {
+                aabb_graph_ids.push_back(static_cast<uint32_t>(box_index(box)));
+            }
+            aabb_graph_offsets.push_back(static_cast<uint32_t>(aabb_graph_ids.size()));
+        }
+        writer.WriteArray(aabb_graph_offsets);
+        writer.WriteArray(aabb_graph_ids);
+
+        std::vector<CachedPoint> points;
+        points.reserve(m_points.size());
+        for (const auto& p : m_points) {
+            const auto portal = p.portal ? static_cast<int32_t>(p.portal - m_portals.data()) : -1;
+            points.push_back({p.pos, box_index(p.box), box_index(p.box2), portal});
+        }
+        writer.WriteArray(points);
+
+        writer.WriteArray(m_visGraph.m_offsets);
+        writer.WriteArray(m_visGraph.m_edges);
+        writer.WriteArray(m_visGraph.m_blocking_spans);
+        writer.WriteArray(m_visGraph.m_blocking_pool);
+
+        // Write to a temporary file and swap it in, so a half written cache is never picked up
+        const auto path = GetCachePath();
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+        auto tmp_path = path;
+        tmp_path += ".tmp";
+        {
+            std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+                return false;
+            file.write(reinterpret_cast<const char*>(writer.buffer.data()), static_cast<std::streamsize>(writer.buffer.size()));
+            if (!file.good())
+                return false;
+        }
+        std::filesystem::rename(tmp_path, path, ec);
+        if (ec) {
+            Log::Warning("Failed to write pathing cache %s: %s", path.filename().string().c_str(), ec.message().c_str());
+            std::filesystem::remove(tmp_path, ec);
+            return false;
+        }
+        return true;
+    }
+
     MilePath::Portal::Portal(const Vec2f& start, const Vec2f& goal, const AABB* box1, const AABB* box2)
         : m_start(start),
           m_goal(goal),
@@ -390,6 +941,11 @@ namespace Pathing {
             box.m_id = id++;
         }
         m_aabbs.shrink_to_fit();
+
+        m_aabbGrid.Build(m_aabbs.size(), [this](const size_t i, Vec2f& min, Vec2f& max) {
+            min = m_aabbs[i].m_pos - m_aabbs[i].m_half;
+            max = m_aabbs[i].m_pos + m_aabbs[i].m_half;
+        });
     }
 
     bool MilePath::CreatePortal(const AABB* box1, const AABB* box2, const SimplePT::adjacentSide& ts)
@@ -494,11 +1050,19 @@ namespace Pathing {
         m_PTPortalGraph.clear();
         m_PTPortalGraph.resize(m_aabbs.size() * 2);
 
-        for (size_t i = 0; i < m_aabbs.size(); ++i) {
-            for (size_t j = i + 1; j < m_aabbs.size(); ++j) {
-                if (m_terminateThread) return;
+#ifdef _DEBUG
+        const clock_t start = clock();
+#endif
+        // Sweep and prune: m_aabbs is sorted by descending lower y, so walking backwards from box j towards the front
+        // visits boxes whose lower y is at or above box j's; once that lower y clears the top of box j, no further box can touch it.
+        constexpr Vec2f padding = {1.0f, 1.0f};
+        for (size_t j = m_aabbs.size(); j-- > 0;) {
+            if (m_terminateThread) return;
+            const float top = m_aabbs[j].m_pos.y + m_aabbs[j].m_half.y + padding.y;
+            for (size_t i = j; i-- > 0;) {
+                if (m_aabbs[i].m_pos.y - m_aabbs[i].m_half.y >= top) break;
                 // coarse intersection
-                if (!m_aabbs[i].intersect(m_aabbs[j], {1.0f, 1.0f})) continue;
+                if (!m_aabbs[i].intersect(m_aabbs[j], padding)) continue;
                 auto* a = &m_aabbs[i],* b = &m_aabbs[j];
 
                 // fine intersection
@@ -515,7 +1079,7 @@ namespace Pathing {
             }
         }
 #ifdef _DEBUG
-        Log::Flash("Portal count: %d", m_portals.size());
+        Log::Flash("Portal count: %d in %d ms", m_portals.size(), clock() - start);
 #endif
     }
 
@@ -542,32 +1106,28 @@ namespace Pathing {
         m_points.shrink_to_fit();
     }
 
+    void MilePath::GeneratePointGrid()
+    {
+        if (m_terminateThread) return;
+
+        m_pointGrid.Build(m_points.size(), [this](const size_t i, Vec2f& min, Vec2f& max) {
+            min = max = m_points[i].pos;
+        });
+    }
+
     bool MilePath::IsOnPathingTrapezoid(const Vec2f& p, const SimplePT** ppt)
     {
-        //note: maybe use GW client O(logn) algorithm?
-        //constexpr float tolerance = 2.0f;
-        //auto lower = std::lower_bound(aabbs.begin(), aabbs.end(), p.y,
-        //    [](const AABB &box, const float &val) { return box.m_pos.y - box.m_half.y - tolerance < val; });
-        //auto upper = std::upper_bound(lower, aabbs.end(), p.y,
-        //    [](const float &val, const AABB &box) { return val < box.m_pos.y + box.m_half.y + tolerance; });
-
-        //for (auto it = lower; it < aabbs.end()/*upper*/; ++it) {
-        //    const SimplePT *pt = (*it).m_t;
-        //    if (IsOnPathingTrapezoid(pt, p)) {
-        //        if (ppt) *ppt = pt;
-        //        return true;
-        //    }
-        //}
-        const auto& aabbs = m_aabbs;
-        for (const auto& box : aabbs) {
-            const SimplePT* pt = box.m_t;
-            if (pt->IsOnPathingTrapezoid(p)) {
-                if (ppt) *ppt = pt;
-                return true;
-            }
-        }
-        if (ppt) *ppt = nullptr;
-        return false;
+        // A trapezoid can only contain p if its AABB does, so only the boxes bucketed in p's grid cell need checking
+        const SimplePT* found = nullptr;
+        m_aabbGrid.ForEachAt(p, [&](const SpatialGrid::id_type box_id) {
+            const SimplePT* pt = m_aabbs[box_id].m_t;
+            if (!pt->IsOnPathingTrapezoid(p))
+                return false;
+            found = pt;
+            return true;
+        });
+        if (ppt) *ppt = found;
+        return found != nullptr;
     }
 
     bool IntersectPt(const SimplePT& pt, const Vec2f& start, const Vec2f& goal)
@@ -581,12 +1141,15 @@ namespace Pathing {
 
     const AABB* MilePath::FindAABB(const GamePos& pos)
     {
-        const auto& aabbs = m_aabbs;
-        for (const auto& a : aabbs) {
-            if (pos.zplane == a.m_t->layer && a.m_t->IsOnPathingTrapezoid(pos))
-                return &a;
-        }
-        return nullptr;
+        const AABB* found = nullptr;
+        m_aabbGrid.ForEachAt(pos, [&](const SpatialGrid::id_type box_id) {
+            const auto& a = m_aabbs[box_id];
+            if (pos.zplane != a.m_t->layer || !a.m_t->IsOnPathingTrapezoid(pos))
+                return false;
+            found = &a;
+            return true;
+        });
+        return found;
     }
 
     inline void addBlockingId(std::vector<uint32_t>* blocking_ids, const AABB* box)
@@ -673,9 +1236,9 @@ namespace Pathing {
         // note: naive VG generation is O(n^3)
         // TODO: great speedup if only checking visibility of convex points.
 
-        m_visGraph.clear();
-        m_visGraph.resize(m_portals.size() * 2 + m_teleports.size() * 2 + 2);
-        for (auto& it : m_visGraph) {
+        m_visGraphAdjacency.clear();
+        m_visGraphAdjacency.resize(m_portals.size() * 2 + m_teleports.size() * 2 + 2);
+        for (auto& it : m_visGraphAdjacency) {
             it.reserve(0x100);
         }
         float range = max_visibility_range;
@@ -705,15 +1268,15 @@ namespace Pathing {
                     continue;
 
                 if (std::any_of(
-                    std::begin(m_visGraph[p1->id]),
-                    std::end(m_visGraph[p1->id]),
+                    std::begin(m_visGraphAdjacency[p1->id]),
+                    std::end(m_visGraphAdjacency[p1->id]),
                     [p2](const PointVisElement& a) { return a.point_id == p2->id; })) continue;
 
                 blocking_ids.clear();
                 if (HasLineOfSight(*p1, *p2, open, visited, &blocking_ids)) {
                     dist = sqrtf(sqdist);
-                    m_visGraph[p1->id].emplace_back(p2->id, dist, blocking_ids);
-                    m_visGraph[p2->id].emplace_back(p1->id, dist, blocking_ids);
+                    m_visGraphAdjacency[p1->id].emplace_back(p2->id, dist, blocking_ids);
+                    m_visGraphAdjacency[p2->id].emplace_back(p1->id, dist, blocking_ids);
                 }
             }
             m_progress = (i * 100) / size;
@@ -730,13 +1293,21 @@ namespace Pathing {
         float min_distance = std::numeric_limits<float>::max();
         const MilePath::point* closest = nullptr;
 
-        for (const auto& point : m_points) {
-            float sq_dist = GetSquareDistance(pos, point.pos);
-
-            if (sq_dist < min_distance) {
-                min_distance = sq_dist;
-                closest = &point;
-            }
+        // Widen the search square until the closest point found so far is inside the searched circle
+        for (float radius = m_pointGrid.CellSize(); m_pointGrid.Size(); radius *= 2.f) {
+            const Vec2f min = {pos.x - radius, pos.y - radius};
+            const Vec2f max = {pos.x + radius, pos.y + radius};
+            m_pointGrid.ForEachInRect(min, max, [&](const SpatialGrid::id_type point_id) {
+                const auto& point = m_points[point_id];
+                const float sq_dist = GetSquareDistance(pos, point.pos);
+                if (sq_dist < min_distance) {
+                    min_distance = sq_dist;
+                    closest = &point;
+                }
+                return false;
+            });
+            if (min_distance <= radius * radius || m_pointGrid.Covers(min, max))
+                break;
         }
 
         return closest ? *closest : GW::GamePos();
@@ -749,101 +1320,184 @@ namespace Pathing {
 
         const size_t vis_graph_size = m_portals.size() * 2 + m_teleports.size() * 2 + 2;
 
-        m_visGraph.clear();
-        m_visGraph.resize(vis_graph_size);
-        for (auto& it : m_visGraph) {
-            it.reserve(0x50);
-        }
+        m_visGraphAdjacency.clear();
+        m_visGraphAdjacency.resize(vis_graph_size);
 
         const float range = max_visibility_range;
         const float sqrange = range * range;
 
-        const size_t size = m_points.size();
-        std::mutex visGraphMutex;
-        std::mutex progressMutex;
-        std::mutex terminateMutex;
+        const auto size = static_cast<uint32_t>(m_points.size());
+        const uint32_t num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+#ifdef _DEBUG
+        const clock_t start_timestamp = clock();
+#endif
 
         struct VisGraphUpdate {
-            size_t id1{};
-            size_t id2{};
+            point::Id id1{};
+            point::Id id2{};
             float distl{};
             std::vector<uint32_t> blocks{};
         };
 
+        // Points are sorted by y, so the amount of work per point varies a lot across the array.
+        // Each thread starts with an even share of point indices, and steals half of another thread's remaining range once its own runs dry.
+        std::vector<WorkRange> ranges(num_threads);
+        for (uint32_t t = 0; t < num_threads; ++t) {
+            ranges[t].Reset(size * t / num_threads, size * (t + 1) / num_threads);
+        }
+        std::atomic<uint32_t> points_done = 0;
+        // Edges found by each thread; merged into m_visGraphAdjacency once all threads are finished, so no locking is needed
+        std::vector<std::vector<VisGraphUpdate>> thread_updates(num_threads);
+
         // Function to be executed by each thread
-        auto worker = [&](const size_t start, const size_t end) {
+        auto worker = [&](const uint32_t thread_idx) {
             std::vector<const AABB*> open;
-            auto visited = std::vector<bool>(0xd00, false);
-            auto blocking_ids = std::vector<uint32_t>(0);
-            auto local_updates = std::vector<VisGraphUpdate>();
-            local_updates.reserve(vis_graph_size * 2);
-
-            for (size_t i = start; i < end; ++i) {
-                {
-                    std::lock_guard lock(terminateMutex);
-                    if (m_terminateThread) return; // Check termination flag
-                }
+            std::vector<bool> visited;
+            std::vector<uint32_t> blocking_ids;
+            auto& local_updates = thread_updates[thread_idx];
+            local_updates.reserve(vis_graph_size * 2 / num_threads);
 
-                point* p1 = &m_points[i];
-                float min_range = p1->pos.y - range;
-                float max_range = p1->pos.y + range;
+            const auto process_point = [&](const uint32_t i) {
+                const point* p1 = &m_points[i];
+                const float min_range = p1->pos.y - range;
 
+                // Only visit points "below" p1; the pair is stored both ways below
                 for (size_t j = i + 1; j < size; ++j) {
-                    point* p2 = &m_points[j];
-
-                    if (min_range > p2->pos.y || max_range < p2->pos.y)
-                        continue;
+                    const point* p2 = &m_points[j];
+                    if (min_range > p2->pos.y)
+                        break; // sorted by descending y; everything from here on is out of range
 
                     const float sqdist = GetSquareDistance(p1->pos, p2->pos);
                     if (sqdist > sqrange)
                         continue;
 
-                    {
-                        std::lock_guard lock(visGraphMutex);
-                        if (std::ranges::any_of(m_visGraph[p1->id], [p2](const PointVisElement& a) { return a.point_id == p2->id; })) {
-                            continue;
-                        }
-                    }
-
                     blocking_ids.clear();
                     if (HasLineOfSight(*p1, *p2, open, visited, &blocking_ids)) {
                         const float dist = sqrtf(sqdist);
-
-                        // Collect updates (copy in worker thread)
                         local_updates.emplace_back(p2->id, p1->id, dist, blocking_ids);
-                        local_updates.emplace_back(p1->id, p2->id, dist, std::move(blocking_ids));
+                        local_updates.emplace_back(p1->id, p2->id, dist, blocking_ids);
                     }
                 }
-
-                {
-                    std::lock_guard lock(progressMutex);
-                    m_progress = (i * 100) / size;
+            };
+
+            constexpr uint32_t batch_size = 8;
+            uint32_t begin = 0, end = 0;
+            while (!m_terminateThread) {
+                if (!ranges[thread_idx].Take(batch_size, begin, end)) {
+                    // Own range is empty; try to steal from the others
+                    bool stolen = false;
+                    for (uint32_t t = 1; t < num_threads && !stolen; ++t) {
+                        stolen = ranges[(thread_idx + t) % num_threads].Steal(begin, end);
+                    }
+                    if (!stolen)
+                        break; // no work left anywhere
+                    ranges[thread_idx].Reset(begin, end);
+                    continue;
                 }
-            }
-
-            // Apply collected updates
-            {
-                std::lock_guard lock(visGraphMutex);
-                for (auto& [id1, id2, distl, blocks] : local_updates) {
-                    m_visGraph[id1].emplace_back(id2, distl, std::move(blocks));
+                for (auto i = begin; i < end; ++i) {
+                    process_point(i);
                 }
+                const auto done = points_done.fetch_add(end - begin, std::memory_order_relaxed) + (end - begin);
+                // 100 is reserved for "ready"
+                m_progress = static_cast<int>(std::min<uint64_t>(static_cast<uint64_t>(done) * 100 / size, 99));
             }
         };
 
-        const size_t num_threads = std::thread::hardware_concurrency(); // Get number of supported hardware threads
-        std::vector<std::jthread> threads;
-        // Determine the range of work each thread will handle
-        size_t chunk_size = size / num_threads;
+        {
+            std::vector<std::jthread> threads;
+            threads.reserve(num_threads);
+            for (uint32_t t = 0; t < num_threads; ++t) {
+                threads.emplace_back(worker, t);
+            }
+        } // jthreads join here
 
-        for (size_t t = 0; t < num_threads; ++t) {
-            size_t start = t * chunk_size;
-            size_t end = (t == num_threads - 1) ? size : (t + 1) * chunk_size;
-            threads.emplace_back(worker, start, end);
+        if (m_terminateThread) return;
+
+        // Apply collected updates
+        std::vector<size_t> degree(vis_graph_size, 0);
+        for (const auto& updates : thread_updates) {
+            for (const auto& update : updates) {
+                degree[update.id1]++;
+            }
         }
+        for (size_t i = 0; i < vis_graph_size; ++i) {
+            m_visGraphAdjacency[i].reserve(degree[i]);
+        }
+        for (auto& updates : thread_updates) {
+            for (auto& [id1, id2, distl, blocks] : updates) {
+                m_visGraphAdjacency[id1].emplace_back(id2, distl, std::move(blocks));
+            }
+            updates = {};
+        }
+#ifdef _DEBUG
+        const auto elapsed = std::max<clock_t>(clock() - start_timestamp, 1);
+        Log::Flash("Visibility graph: %u points in %d ms (%.0f points/s) on %u threads", size, elapsed, size * 1000.0 / elapsed, num_threads);
+#endif
     }
 #pragma optimize("", on) // Restore global optimizations to project default
 #endif
 
+    void MilePath::VisGraph::Build(const std::vector<std::vector<PointVisElement>>& adjacency)
+    {
+        Clear();
+
+        size_t edge_count = 0;
+        for (const auto& edges : adjacency) {
+            edge_count += edges.size();
+        }
+        m_offsets.reserve(adjacency.size() + 1);
+        m_edges.reserve(edge_count);
+
+        std::map<std::vector<uint32_t>, uint32_t> span_by_blocking_ids;
+        m_blocking_spans.push_back({0, 0});
+        span_by_blocking_ids.emplace(std::vector<uint32_t>{}, 0);
+
+        m_offsets.push_back(0);
+        for (const auto& edges : adjacency) {
+            for (const auto& [point_id, distance, blocking_ids] : edges) {
+                auto found = span_by_blocking_ids.find(blocking_ids);
+                if (found == span_by_blocking_ids.end()) {
+                    m_blocking_spans.push_back({static_cast<uint32_t>(m_blocking_pool.size()), static_cast<uint32_t>(blocking_ids.size())});
+                    m_blocking_pool.insert(m_blocking_pool.end(), blocking_ids.begin(), blocking_ids.end());
+                    found = span_by_blocking_ids.emplace(blocking_ids, static_cast<uint32_t>(m_blocking_spans.size() - 1)).first;
+                }
+                m_edges.push_back({point_id, distance, found->second});
+            }
+            m_offsets.push_back(static_cast<uint32_t>(m_edges.size()));
+        }
+        m_blocking_spans.shrink_to_fit();
+        m_blocking_pool.shrink_to_fit();
+    }
+
+    void MilePath::VisGraph::Clear()
+    {
+        m_offsets.clear();
+        m_edges.clear();
+        m_blocking_spans.clear();
+        m_blocking_pool.clear();
+    }
+
+    size_t MilePath::VisGraph::MemoryUsage() const
+    {
+        return m_offsets.capacity() * sizeof(m_offsets[0])
+               + m_edges.capacity() * sizeof(m_edges[0])
+               + m_blocking_spans.capacity() * sizeof(m_blocking_spans[0])
+               + m_blocking_pool.capacity() * sizeof(m_blocking_pool[0]);
+    }
+
+    void MilePath::CompactVisibilityGraph()
+    {
+        if (m_terminateThread) return;
+
+        // Adjacency is sized for the search's start/goal too; they aren't stored in the graph anymore
+        m_visGraphAdjacency.resize(m_points.size());
+        m_visGraph.Build(m_visGraphAdjacency);
+        m_visGraphAdjacency = {};
+#ifdef _DEBUG
+        Log::Flash("Visibility graph: %d edges, %d blocking lists, %d KB", m_visGraph.EdgeCount(), m_visGraph.BlockingSpanCount(), m_visGraph.MemoryUsage() / 1024);
+#endif
+    }
+
     void MilePath::insertTeleportPointIntoVisGraph(point& point, teleport_point_type type)
     {
         std::vector<const AABB*> open;
@@ -854,14 +1508,14 @@ namespace Pathing {
 
             float distance = GetDistance(point.pos, p.pos);
             if (type == teleport_point_type::both) {
-                m_visGraph[p.id].emplace_back(point.id, distance, blocking_ids);
-                m_visGraph[point.id].emplace_back(p.id, distance, blocking_ids);
+                m_visGraphAdjacency[p.id].emplace_back(point.id, distance, blocking_ids);
+                m_visGraphAdjacency[point.id].emplace_back(p.id, distance, blocking_ids);
             }
             else if (type == teleport_point_type::enter) {
-                m_visGraph[p.id].emplace_back(point.id, distance, blocking_ids);
+                m_visGraphAdjacency[p.id].emplace_back(point.id, distance, blocking_ids);
             }
             else if (type == teleport_point_type::exit) {
-                m_visGraph[point.id].emplace_back(p.id, distance, blocking_ids);
+                m_visGraphAdjacency[point.id].emplace_back(p.id, distance, blocking_ids);
             }
         }
     }
@@ -887,9 +1541,9 @@ namespace Pathing {
 
             // although the distance between teleports is 0, a tiny value is used as a penalty for various reasons.
             float dist = GetDistance(teleport.m_enter, teleport.m_exit) * 0.01f;
-            m_visGraph[point_enter.id].emplace_back(m_points[point_exit.id].id, dist);
+            m_visGraphAdjacency[point_enter.id].emplace_back(m_points[point_exit.id].id, dist);
             if (bidir)
-                m_visGraph[point_exit.id].emplace_back(m_points[point_enter.id].id, dist * 0.01f);
+                m_visGraphAdjacency[point_exit.id].emplace_back(m_points[point_enter.id].id, dist * 0.01f);
         }
     }
 
@@ -903,6 +1557,95 @@ namespace Pathing {
         }
     };
 
+    void MilePath::GenerateLandmarks()
+    {
+        if (m_terminateThread || !use_landmark_heuristic) return;
+
+        const size_t size = m_points.size();
+        if (!size) return;
+        constexpr uint32_t max_landmarks = 4;
+
+        // Reverse of the visibility graph, for distances towards a landmark; teleport edges are one way
+        std::vector<uint32_t> reverse_offsets(size + 1, 0);
+        for (size_t i = 0; i < size; ++i) {
+            for (const auto& edge : m_visGraph.Edges(static_cast<point::Id>(i))) {
+                reverse_offsets[edge.point_id + 1]++;
+            }
+        }
+        for (size_t i = 1; i <= size; ++i) {
+            reverse_offsets[i] += reverse_offsets[i - 1];
+        }
+        std::vector<PQElement> reverse_edges(reverse_offsets.back()); // (distance, point id)
+        std::vector<uint32_t> cursor(reverse_offsets.begin(), reverse_offsets.end() - 1);
+        for (size_t i = 0; i < size; ++i) {
+            for (const auto& edge : m_visGraph.Edges(static_cast<point::Id>(i))) {
+                reverse_edges[cursor[edge.point_id]++] = {edge.distance, static_cast<point::Id>(i)};
+            }
+        }
+
+        // Blocked layers are ignored; that can only make distances shorter, so they stay lower bounds
+        const auto dijkstra = [&](const point::Id source, const bool reverse, float* dist) {
+            std::fill(dist, dist + size, INFINITY);
+            MyPQueue open(size);
+            dist[source] = 0.f;
+            open.emplace(0.f, source);
+            while (!open.empty() && !m_terminateThread) {
+                const auto [cost, current] = open.top();
+                open.pop();
+                if (cost > dist[current])
+                    continue;
+                const auto relax = [&](const point::Id to, const float distance) {
+                    if (cost + distance < dist[to]) {
+                        dist[to] = cost + distance;
+                        open.emplace(dist[to], to);
+                    }
+                };
+                if (reverse) {
+                    for (auto i = reverse_offsets[current]; i < reverse_offsets[current + 1]; ++i) {
+                        relax(reverse_edges[i].second, reverse_edges[i].first);
+                    }
+                }
+                else {
+                    for (const auto& edge : m_visGraph.Edges(current)) {
+                        relax(edge.point_id, edge.distance);
+                    }
+                }
+            }
+        };
+
+        // Farthest point selection: each landmark is the point furthest from the ones already picked, unreachable points first
+        std::vector<float> from(max_landmarks * size), to(max_landmarks * size);
+        std::vector<float> min_distance(size, INFINITY);
+        uint32_t count = 0;
+        point::Id landmark = 0;
+        while (count < max_landmarks) {
+            dijkstra(landmark, false, &from[count * size]);
+            dijkstra(landmark, true, &to[count * size]);
+            if (m_terminateThread) return;
+
+            const float* landmark_from = &from[count * size];
+            count++;
+            point::Id next = -1;
+            float furthest = 0.f;
+            for (size_t i = 0; i < size; ++i) {
+                min_distance[i] = std::min(min_distance[i], landmark_from[i]);
+                if (min_distance[i] > furthest) {
+                    furthest = min_distance[i];
+                    next = static_cast<point::Id>(i);
+                }
+            }
+            if (next < 0) break;
+            landmark = next;
+        }
+
+        from.resize(count * size);
+        to.resize(count * size);
+        m_landmarkFrom = std::move(from);
+        m_landmarkTo = std::move(to);
+        m_landmarkCount = count;
+        m_landmarksReady.store(true, std::memory_order_release);
+    }
+
     AStar::AStar(MilePath* mp)
         : m_path(this),
           m_mp(mp)
@@ -927,34 +1670,40 @@ namespace Pathing {
         int visited_index{};
     };
 
-    void AStar::InsertPointIntoVisGraph(MilePath::point& point) const
+    void AStar::ConnectPoint(const MilePath::point& point, std::vector<MilePath::PointVisElement>& edges) const
     {
-        auto& vis_graph = m_mp->m_visGraph;
         const float sqrange = max_visibility_range * max_visibility_range;
         std::vector<const AABB*> open;
         std::vector<bool> visited;
-        for (const auto& it : m_mp->m_points) {
+        const Vec2f range = {max_visibility_range, max_visibility_range};
+        m_mp->m_pointGrid.ForEachInRect(point.pos - range, point.pos + range, [&](const SpatialGrid::id_type point_id) {
+            const auto& it = m_mp->m_points[point_id];
             const float sqdistance = GetSquareDistance(it.pos, point.pos);
             if (sqdistance > sqrange)
-                continue;
+                return false;
 
             std::vector<uint32_t> blocking_ids;
             if (!m_mp->HasLineOfSight(it, point, open, visited, &blocking_ids))
-                continue;
+                return false;
 
-            float distance = sqrtf(sqdistance);
-            vis_graph[point.id].emplace_back(it.id, distance, blocking_ids);
-            vis_graph[it.id].emplace_back(point.id, distance, std::move(blocking_ids));
-        }
+            edges.emplace_back(it.id, sqrtf(sqdistance), std::move(blocking_ids));
+            return false;
+        });
     }
 
     // https://github.com/Rikora/A-star/blob/master/src/AStar.cpp
     Error AStar::BuildPath(const MilePath::point& start, const MilePath::point& goal,
                            const std::vector<MilePath::point::Id>& came_from)
+    {
+        return BuildPath(start, goal, came_from, m_path);
+    }
+
+    Error AStar::BuildPath(const MilePath::point& start, const MilePath::point& goal,
+                           const std::vector<MilePath::point::Id>& came_from, Path& path)
     {
         MilePath::point current(goal);
 
-        m_path.clear();
+        path.clear();
 
         int count = 0;
         while (current.id != start.id) {
@@ -965,14 +1714,14 @@ namespace Pathing {
             if (current.id < 0) {
                 break;
             }
-            m_path.insertPoint(current);
+            path.insertPoint(current);
             auto& id = came_from[current.id];
             if (id == start.id)
                 break;
             current = m_mp->m_points[id];
         }
-        m_path.insertPoint(start);
-        m_path.finalize();
+        path.insertPoint(start);
+        path.finalize();
         return Error::OK;
     }
 
@@ -1027,10 +1776,14 @@ namespace Pathing {
 
         if (res != Error::OK)
             return res;
+        return Search(_start_pos, _goal_pos, block, m_path);
+    }
+
+    Error AStar::Search(const GamePos& _start_pos, const GamePos& _goal_pos, const std::vector<uint32_t>& block, Path& path)
+    {
         MilePath::point::Id point_id = m_mp->m_points.size();
         MilePath::point start;
-        bool new_start = false;
-        m_path.clear();
+        path.clear();
 
         // Start or goal may not actually be in the pmap e.g. objective marker leading to portal
         const auto start_pos = m_mp->GetClosestPoint(_start_pos);
@@ -1044,11 +1797,9 @@ namespace Pathing {
             if (!start.box)
                 return Error::FailedToFindStartBox;
             start.id = point_id++;
-            new_start = true;
         }
 
         MilePath::point goal;
-        bool new_goal = false;
         //if (m_mp->m_pointLookup.contains(goal_pos)) {
         //    goal = *m_mp->m_pointLookup.at(goal_pos);
         //} else
@@ -1057,19 +1808,22 @@ namespace Pathing {
             if (!goal.box)
                 return Error::FailedToFindGoalBox;
             goal.id = point_id;
-            new_goal = true;
         }
 
+        const auto is_blocked = [&block](const std::span<const uint32_t> blocking_ids) {
+            return std::ranges::any_of(blocking_ids, [&block](auto& id) { return block[id]; });
+        };
+
         {
             std::vector<const AABB*> open;
             std::vector<bool> visited;
             std::vector<uint32_t> blocking_ids;
             if (m_mp->HasLineOfSight(start, goal, open, visited, &blocking_ids)) {
-                if (!std::ranges::any_of(blocking_ids, [&block](auto& id) { return block[id]; })) {
-                    m_path.insertPoint(start);
-                    m_path.insertPoint(goal);
-                    m_path.setCost(GetDistance(start_pos, goal_pos));
-                    m_path.finalize();
+                if (!is_blocked(blocking_ids)) {
+                    path.insertPoint(start);
+                    path.insertPoint(goal);
+                    path.setCost(GetDistance(start_pos, goal_pos));
+                    path.finalize();
                     return Error::OK;
                 }
             }
@@ -1079,85 +1833,110 @@ namespace Pathing {
         const clock_t start_timestamp = clock();
 #endif
 
-        // TODO: Maybe I'm not using milepath for its intended purpose, but this function will ALWAYS add more points to the graph!!
-        if (new_start) {
-            m_mp->m_points.push_back(start);
-            InsertPointIntoVisGraph(start);
+        // Start and goal aren't part of the visibility graph; connect them for this search only.
+        // Only edges leaving the start and edges arriving at the goal can be part of a path.
+        // Line of sight is symmetric, so the same connections serve either role.
+        std::vector<MilePath::PointVisElement> start_edges, goal_edges;
+        ConnectPoint(start, start_edges);
+        ConnectPoint(goal, goal_edges);
+
+        const size_t node_count = m_mp->m_points.size() + 2;
+        search_state.Reset(node_count);
+        auto& goal_edge_by_point = search_state.goal_edge;
+        for (size_t i = 0; i < goal_edges.size(); ++i) {
+            goal_edge_by_point[goal_edges[i].point_id] = static_cast<int>(i);
         }
-        if (new_goal) {
-            m_mp->m_points.push_back(goal);
-            InsertPointIntoVisGraph(goal);
+
+        // Landmark lower bound: d(v, goal) >= d(L, goal) - d(L, v) and >= d(v, L) - d(goal, L), for every landmark L.
+        // The goal isn't in the graph, so its landmark distances go through the points it can see.
+        const bool landmarks = use_landmark_heuristic && m_mp->m_landmarksReady.load(std::memory_order_acquire);
+        const size_t landmark_stride = m_mp->m_points.size();
+        auto& goal_from = search_state.goal_landmark_from;
+        auto& goal_to = search_state.goal_landmark_to;
+        if (landmarks) {
+            goal_from.assign(m_mp->m_landmarkCount, INFINITY);
+            goal_to.assign(m_mp->m_landmarkCount, INFINITY);
+            for (uint32_t l = 0; l < m_mp->m_landmarkCount; ++l) {
+                for (const auto& vis : goal_edges) {
+                    goal_from[l] = std::min(goal_from[l], m_mp->m_landmarkFrom[l * landmark_stride + vis.point_id] + vis.distance);
+                    goal_to[l] = std::min(goal_to[l], vis.distance + m_mp->m_landmarkTo[l * landmark_stride + vis.point_id]);
+                }
+            }
         }
 
-        std::vector<float> cost_so_far(m_mp->m_points.size() + 2, -INFINITY);
-        std::vector<MilePath::point::Id> came_from(m_mp->m_points.size() + 2);
-        MyPQueue open(m_mp->m_points.size() + 2);
+        const bool teleports = !m_mp->m_teleports.empty();
+        const auto heuristic = [&](const MilePath::point::Id point_id) {
+            const auto& point = m_mp->m_points[point_id];
+            // Straight line distance is only a lower bound when there are no teleports
+            float h = GetDistance(point.pos, goal.pos);
+            if (teleports)
+                h = std::min(h, TeleporterHeuristic(point, goal));
+            if (!landmarks)
+                return h;
+            for (uint32_t l = 0; l < m_mp->m_landmarkCount; ++l) {
+                const float from = m_mp->m_landmarkFrom[l * landmark_stride + point_id];
+                const float to = m_mp->m_landmarkTo[l * landmark_stride + point_id];
+                if (std::isfinite(from) && std::isfinite(goal_from[l]))
+                    h = std::max(h, goal_from[l] - from);
+                if (std::isfinite(to) && std::isfinite(goal_to[l]))
+                    h = std::max(h, to - goal_to[l]);
+            }
+            return h;
+        };
 
-        cost_so_far[start.id] = 0.0f;
-        came_from[start.id] = start.id;
-        open.emplace(0.0f, start.id);
+        auto& open = search_state.open;
+        search_state.SetCost(start.id, 0.0f, start.id);
+        open.Push(start.id, 0.0f);
 
-        const bool teleports = !m_mp->m_teleports.empty();
         MilePath::point::Id current = 0;
-        while (!open.empty()) {
-            current = open.top().second;
-            open.pop();
+        const auto visit = [&](const MilePath::point::Id point_id, const float distance) {
+            const float new_cost = search_state.cost[current] + distance;
+            if (search_state.Visited(point_id) && new_cost >= search_state.cost[point_id])
+                return;
+            search_state.SetCost(point_id, new_cost, current);
+            const float priority = point_id == goal.id ? new_cost : new_cost + heuristic(point_id);
+            open.PushOrDecrease(point_id, priority);
+        };
+
+        const auto& vis_graph = m_mp->m_visGraph;
+        while (!open.Empty()) {
+            current = open.Pop();
             if (current == goal.id)
                 break;
 
-            for (const auto& vis : m_mp->m_visGraph[current]) {
-                if (std::ranges::any_of(vis.blocking_ids, [&block](auto& id) { return block[id]; }))
-                    continue;
-
-                const float new_cost = cost_so_far[current] + vis.distance;
-                if (cost_so_far[vis.point_id] == -INFINITY || new_cost < cost_so_far[vis.point_id]) {
-                    cost_so_far[vis.point_id] = new_cost;
-                    came_from[vis.point_id] = current;
-
-                    float priority = new_cost;
-                    if (teleports) {
-                        const auto& point = m_mp->m_points[vis.point_id];
-                        float tp_cost = TeleporterHeuristic(point, goal);
-                        priority += std::min(GetDistance(point.pos, goal.pos), tp_cost);
-                    }
-                    open.emplace(priority, vis.point_id);
+            if (current == start.id) {
+                for (const auto& vis : start_edges) {
+                    if (!is_blocked(vis.blocking_ids))
+                        visit(vis.point_id, vis.distance);
                 }
+                continue;
             }
-        }
-
-        if (current == goal.id) {
-            BuildPath(start, goal, came_from);
-            m_path.setCost(cost_so_far[current]);
-        }
 
-        // TODO: Implement a pop list so there is no need to search every node?
-        if (new_goal) {
-            auto& other_elements = m_mp->m_visGraph[goal.id];
-
-            for (const auto& elem : other_elements) {
-                auto& points = m_mp->m_visGraph[elem.point_id];
-                std::erase_if(points, [&goal](const auto& elem) { return elem.point_id == goal.id; });
+            for (const auto& edge : vis_graph.Edges(current)) {
+                if (!is_blocked(vis_graph.BlockingIds(edge)))
+                    visit(edge.point_id, edge.distance);
+            }
+            if (const auto goal_edge = goal_edge_by_point[current]; goal_edge >= 0) {
+                const auto& vis = goal_edges[goal_edge];
+                if (!is_blocked(vis.blocking_ids))
+                    visit(goal.id, vis.distance);
             }
-            m_mp->m_points.pop_back();
-            m_mp->m_visGraph[goal.id].clear();
         }
-        if (new_start) {
-            const auto& other_elements = m_mp->m_visGraph[start.id];
 
-            for (const auto& elem : other_elements) {
-                auto& points = m_mp->m_visGraph[elem.point_id];
-                std::erase_if(points, [&start](const auto& point) { return point.point_id == start.id; });
-            }
-            m_mp->m_points.pop_back();
-            m_mp->m_visGraph[start.id].clear();
+        if (current == goal.id) {
+            BuildPath(start, goal, search_state.came_from, path);
+            path.setCost(search_state.cost[current]);
+        }
+        for (const auto& vis : goal_edges) {
+            goal_edge_by_point[vis.point_id] = -1;
         }
 
 #ifdef DEBUG_PATHING
         const clock_t stop_timestamp = clock();
         Log::Log("Find path: %d ms\n", stop_timestamp - start_timestamp);
 #endif
-        m_path.finalize();
-        return m_path.ready() ? Error::OK : Error::FailedToFinializePath;
+        path.finalize();
+        return path.ready() ? Error::OK : Error::FailedToFinializePath;
     }
 
     GamePos AStar::GetClosestPoint(const Vec2f& pos)
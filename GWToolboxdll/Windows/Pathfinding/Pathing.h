@@ -1,12 +1,16 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
+#include <span>
 #include <GWCA/GameContainers/GamePos.h>
 #include <GWCA/GameEntities/Pathing.h>
 #include "MapSpecificData.h"
 
 namespace Pathing {
     inline static auto max_visibility_range = 5000.0f;
+    // Use precomputed landmark distances (ALT) as an A* lower bound once they're available for the current map
+    inline static auto use_landmark_heuristic = true;
 
     enum class Error : uint32_t {
         OK,
@@ -54,11 +58,152 @@ namespace Pathing {
         const SimplePT* m_t;
     };
 
+    // Uniform grid over axis aligned extents, used to replace linear scans over boxes and points.
+    // Ids are bucketed into every cell their extents overlap, stored contiguously per cell (offsets + ids).
+    // NB: Items with an extent can be returned more than once by ForEachInRect; items built with zero extent (points) can't.
+    class SpatialGrid {
+    public:
+        using id_type = uint32_t;
+
+        // get_bounds(i, min, max) fills in the extents of item i
+        template <typename GetBounds>
+        void Build(const size_t count, GetBounds&& get_bounds)
+        {
+            Clear();
+            if (!count) return;
+
+            std::vector<GW::Vec2f> mins(count), maxs(count);
+            m_min = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+            GW::Vec2f max = {std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest()};
+            for (size_t i = 0; i < count; i++) {
+                get_bounds(i, mins[i], maxs[i]);
+                m_min = {std::min(m_min.x, mins[i].x), std::min(m_min.y, mins[i].y)};
+                max = {std::max(max.x, maxs[i].x), std::max(max.y, maxs[i].y)};
+            }
+
+            // Aim for a handful of items per cell, within sane limits for a GW map
+            const float width = std::max(max.x - m_min.x, 1.f);
+            const float height = std::max(max.y - m_min.y, 1.f);
+            m_cell_size = std::max(sqrtf(width * height * items_per_cell / static_cast<float>(count)), min_cell_size);
+            m_cols = std::min(static_cast<uint32_t>(width / m_cell_size) + 1, max_cells_per_axis);
+            m_rows = std::min(static_cast<uint32_t>(height / m_cell_size) + 1, max_cells_per_axis);
+            m_cell_size = std::max(width / static_cast<float>(m_cols), height / static_cast<float>(m_rows));
+
+            // Count, prefix sum, then fill
+            m_offsets.assign(static_cast<size_t>(m_cols) * m_rows + 1, 0);
+            for (size_t i = 0; i < count; i++) {
+                ForEachCell(mins[i], maxs[i], [&](const size_t cell) { m_offsets[cell + 1]++; });
+            }
+            for (size_t i = 1; i < m_offsets.size(); i++) {
+                m_offsets[i] += m_offsets[i - 1];
+            }
+            m_ids.resize(m_offsets.back());
+            std::vector<id_type> cursor(m_offsets.begin(), m_offsets.end() - 1);
+            for (size_t i = 0; i < count; i++) {
+                ForEachCell(mins[i], maxs[i], [&](const size_t cell) { m_ids[cursor[cell]++] = static_cast<id_type>(i); });
+            }
+            m_count = count;
+        }
+
+        void Clear()
+        {
+            m_offsets.clear();
+            m_ids.clear();
+            m_cols = m_rows = 0;
+            m_count = 0;
+        }
+
+        // Number of items the grid was built with; ids are in the range [0, Size())
+        [[nodiscard]] size_t Size() const { return m_count; }
+        [[nodiscard]] float CellSize() const { return m_cell_size; }
+
+        // Calls func(id) for each item bucketed in the cell containing p, in ascending id order. Return true from func to stop early.
+        template <typename Func>
+        bool ForEachAt(const GW::Vec2f& p, Func&& func) const
+        {
+            if (!m_count) return false;
+            const size_t cell = CellIndex(Col(p.x), Row(p.y));
+            for (auto i = m_offsets[cell]; i < m_offsets[cell + 1]; i++) {
+                if (func(m_ids[i])) return true;
+            }
+            return false;
+        }
+
+        // Calls func(id) for each item bucketed in any cell overlapping the rectangle. Return true from func to stop early.
+        template <typename Func>
+        bool ForEachInRect(const GW::Vec2f& min, const GW::Vec2f& max, Func&& func) const
+        {
+            if (!m_count) return false;
+            bool stopped = false;
+            ForEachCell(min, max, [&](const size_t cell) {
+                for (auto i = m_offsets[cell]; !stopped && i < m_offsets[cell + 1]; i++) {
+                    stopped = func(m_ids[i]);
+                }
+                return stopped;
+            });
+            return stopped;
+        }
+
+        // True if the rectangle covers every cell of the grid
+        [[nodiscard]] bool Covers(const GW::Vec2f& min, const GW::Vec2f& max) const
+        {
+            return Col(min.x) == 0 && Row(min.y) == 0 && Col(max.x) == m_cols - 1 && Row(max.y) == m_rows - 1;
+        }
+
+    private:
+        static constexpr float items_per_cell = 4.f;
+        static constexpr float min_cell_size = 64.f;
+        static constexpr uint32_t max_cells_per_axis = 512;
+
+        [[nodiscard]] uint32_t Col(const float x) const
+        {
+            const float c = (x - m_min.x) / m_cell_size;
+            return c <= 0.f ? 0 : std::min(static_cast<uint32_t>(c), m_cols - 1);
+        }
+
+        [[nodiscard]] uint32_t Row(const float y) const
+        {
+            const float r = (y - m_min.y) / m_cell_size;
+            return r <= 0.f ? 0 : std::min(static_cast<uint32_t>(r), m_rows - 1);
+        }
+
+        [[nodiscard]] size_t CellIndex(const uint32_t col, const uint32_t row) const
+        {
+            return static_cast<size_t>(row) * m_cols + col;
+        }
+
+        // func(cell) may return bool; true stops the iteration
+        template <typename Func>
+        void ForEachCell(const GW::Vec2f& min, const GW::Vec2f& max, Func&& func) const
+        {
+            const auto col_min = Col(min.x), col_max = Col(max.x);
+            const auto row_min = Row(min.y), row_max = Row(max.y);
+            for (auto row = row_min; row <= row_max; row++) {
+                for (auto col = col_min; col <= col_max; col++) {
+                    if constexpr (std::is_same_v<std::invoke_result_t<Func, size_t>, bool>) {
+                        if (func(CellIndex(col, row))) return;
+                    }
+                    else {
+                        func(CellIndex(col, row));
+                    }
+                }
+            }
+        }
+
+        GW::Vec2f m_min;
+        float m_cell_size = 0.f;
+        uint32_t m_cols = 0;
+        uint32_t m_rows = 0;
+        size_t m_count = 0;
+        std::vector<id_type> m_offsets; // [cell], size cols * rows + 1
+        std::vector<id_type> m_ids;
+    };
+
     class MilePath {
         volatile bool m_processing = false;
         volatile bool m_done = false;
         volatile bool m_terminateThread = false;
-        volatile int m_progress = 0;
+        std::atomic<int> m_progress = 0;
 
         std::thread* worker_thread = nullptr;
 
@@ -128,13 +273,62 @@ namespace Pathing {
             std::vector<uint32_t> blocking_ids; // Holds all layer changes; for checking if it's passable or blocked.
         } ;
 
+        // Visibility graph in compressed sparse row form; the edges of point i are m_edges[m_offsets[i]..m_offsets[i + 1]).
+        // Blocking layer lists repeat a lot between edges, so each distinct list is stored once and edges refer to it by index.
+        class VisGraph {
+        public:
+            struct Edge {
+                point::Id point_id;     // other point
+                float distance;
+                uint32_t blocking_span; // index into m_blocking_spans; 0 is the empty list
+            };
+
+            // Compacts adjacency lists indexed by point id
+            void Build(const std::vector<std::vector<PointVisElement>>& adjacency);
+            void Clear();
+
+            [[nodiscard]] std::span<const Edge> Edges(point::Id id) const
+            {
+                if (id < 0 || static_cast<size_t>(id) + 1 >= m_offsets.size())
+                    return {};
+                return {m_edges.data() + m_offsets[id], m_edges.data() + m_offsets[id + 1]};
+            }
+
+            [[nodiscard]] std::span<const uint32_t> BlockingIds(const Edge& edge) const
+            {
+                const auto& [offset, count] = m_blocking_spans[edge.blocking_span];
+                return {m_blocking_pool.data() + offset, count};
+            }
+
+            [[nodiscard]] size_t NodeCount() const { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+            [[nodiscard]] size_t EdgeCount() const { return m_edges.size(); }
+            [[nodiscard]] size_t BlockingSpanCount() const { return m_blocking_spans.size(); }
+            // Bytes held by the graph
+            [[nodiscard]] size_t MemoryUsage() const;
+
+        private:
+            friend class MilePath; // cache (de)serialisation
+
+            struct BlockingSpan {
+                uint32_t offset;
+                uint32_t count;
+            };
+
+            std::vector<uint32_t> m_offsets; // [point.id], size NodeCount() + 1
+            std::vector<Edge> m_edges;
+            std::vector<BlockingSpan> m_blocking_spans;
+            std::vector<uint32_t> m_blocking_pool;
+        };
+
         std::vector<AABB> m_aabbs;
         std::vector<SimplePT> m_trapezoids;
-        std::vector<std::vector<PointVisElement>> m_visGraph;    // [point.id]
+        VisGraph m_visGraph;                                     // [point.id]
         std::vector<std::vector<const AABB*>> m_AABBgraph;       // [box.id]
         std::vector<Portal> m_portals;                           // [portal.id]
         std::vector<std::vector<const Portal*>> m_PTPortalGraph; // [simple_pt.id]
         std::vector<point> m_points;                             // [point.id]
+        SpatialGrid m_aabbGrid;                                  // over m_aabbs, ids are box.m_id
+        SpatialGrid m_pointGrid;                                 // over m_points, ids are point.id
         MapSpecific::Teleports m_teleports;
         std::vector<GW::MapProp*> travel_portals;
         std::vector<MapSpecific::teleport_node> m_teleportGraph;
@@ -153,9 +347,24 @@ namespace Pathing {
         // Get the nearest point on the map that is within a trapezoid
         GW::GamePos GetClosestPoint(const GW::GamePos& pos);
 
+        // Graph distances between a few landmark points and every point, ignoring blocked layers; used as an A* lower bound.
+        // Generated in the background after the map is ready; only read once m_landmarksReady is set.
+        std::atomic<bool> m_landmarksReady = false;
+        uint32_t m_landmarkCount = 0;
+        std::vector<float> m_landmarkFrom; // [landmark * point count + point.id], distance landmark -> point
+        std::vector<float> m_landmarkTo;   // [landmark * point count + point.id], distance point -> landmark
+
     private:
+        GW::Constants::MapID m_map_id = GW::Constants::MapID::None;
+
         void LoadMapSpecificData();
 
+        // Precomputed portals, points and visibility graph are cached on disk per map, keyed by the map's trapezoid data.
+        // GenerateAABBs() must have been run first; the cache refers to boxes by their sorted index.
+        [[nodiscard]] std::filesystem::path GetCachePath() const;
+        bool LoadFromCache();
+        bool SaveToCache() const;
+
         // Traverse map props and copy an array of valid in-game portals; later used for travel calcs
         void LoadTravelPortals();
 
@@ -172,10 +381,20 @@ namespace Pathing {
 
         void GenerateVisibilityGraph();
 
+        // Move m_visGraphAdjacency into m_visGraph once all edges are known
+        void CompactVisibilityGraph();
+
+        void GenerateLandmarks();
+
+        // Bucket points into m_pointGrid; done once all static points (incl. teleports) are in place.
+        void GeneratePointGrid();
+
         enum class teleport_point_type : uint8_t { enter, exit, both } ;
 
         void insertTeleportPointIntoVisGraph(MilePath::point& point, teleport_point_type type);
         void InsertTeleportsIntoVisibilityGraph();
+
+        std::vector<std::vector<PointVisElement>> m_visGraphAdjacency; // [point.id], only used while building m_visGraph
     };
 
     class AStar {
@@ -235,9 +454,11 @@ namespace Pathing {
 
         AStar(MilePath* mp);
 
-        void InsertPointIntoVisGraph(MilePath::point& point) const;
+        // Collects the points of the visibility graph that can see the given point, e.g. the start or goal of a search
+        void ConnectPoint(const MilePath::point& point, std::vector<MilePath::PointVisElement>& edges) const;
 
         Error BuildPath(const MilePath::point& start, const MilePath::point& goal, const std::vector<MilePath::point::Id>& came_from);
+        Error BuildPath(const MilePath::point& start, const MilePath::point& goal, const std::vector<MilePath::point::Id>& came_from, Path& path);
 
         inline float TeleporterHeuristic(const MilePath::point& start, const MilePath::point& goal) const;
 
@@ -247,7 +468,8 @@ namespace Pathing {
         static GW::GamePos GetClosestPoint(Path& path, const GW::Vec2f& pos);
 
     private:
-        std::vector<std::vector<MilePath::PointVisElement>> m_visGraph{};
+        Error Search(const GW::GamePos& start_pos, const GW::GamePos& goal_pos, const std::vector<uint32_t>& block, Path& path);
+
         MilePath* m_mp;
     };
 }
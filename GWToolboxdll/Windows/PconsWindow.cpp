@@ -16,6 +16,7 @@
 #include <Color.h>
 #include <Logger.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 #include <Utils/TextUtils.h>
 #include <Widgets/AlcoholWidget.h>
 #include <Windows/HotkeysWindow.h>
@@ -400,8 +401,8 @@ void PconsWindow::Initialize()
         GW::UI::RegisterUIMessageCallback(&OnUIMessage_HookEntry, message_id, OnUIMessage);
     }
 
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::GenericValue>(&GenericValue_Entry, &OnGenericValue);
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::AgentState>(&AgentState_Entry, &OnAgentState);
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::GenericValue>(&GenericValue_Entry, &OnGenericValue);
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::AgentState>(&AgentState_Entry, &OnAgentState);
     GW::Chat::CreateCommand(&ChatCmd_HookEntry, L"pcons", &CmdPcons);
 }
 
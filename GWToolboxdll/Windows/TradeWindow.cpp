@@ -18,12 +18,16 @@
 #include <GWCA/Managers/PartyMgr.h>
 
 #include <Logger.h>
+#include <Timer.h>
 #include <Utils/GuiUtils.h>
+#include <Utils/FrameProfiler.h>
 
 #include <Modules/Resources.h>
 #include <Windows/TradeWindow.h>
 #include <GWToolbox.h>
 #include <Utils/TextUtils.h>
+#include <Utils/AlertRules.h>
+#include <Utils/TradeIndex.h>
 
 namespace {
     GW::HookEntry ChatCmd_HookEntry;
@@ -48,11 +52,7 @@ namespace {
         return buff ? buff->begin() : nullptr;
     }
 
-    struct Message {
-        uint32_t timestamp = 0;
-        std::string name;
-        std::string message;
-    };
+    using Message = TradeIndex::Message;
 
     GW::HookEntry OnMessageLocal_Entry;
     GW::HookEntry OnPartySearch_Entry;
@@ -91,13 +91,34 @@ namespace {
     char search_buffer[256] = {};
 
     std::vector<std::string> alert_words{};
-    std::vector<std::string> searched_words{};
+    AlertRules alert_rules;
 
+    // Messages shown in the window
+    constexpr size_t max_shown_messages = 100;
     CircularBuffer<Message> messages;
+    // Live messages are only added to the window if they match this
+    TradeIndex::Query searched_query;
+    // Contents of search_buffer the window last searched for while typing
+    std::string typed_query;
+    // Set by search(); the next Update answers from the local index before deciding whether to ask the server
+    bool local_search_pending = false;
+
+    // Every message received for each channel (Kamadan, Ascalon), searched locally before asking the server
+    constexpr size_t max_indexed_messages = 20000;
+    TradeIndex trade_indexes[2] = {TradeIndex(max_indexed_messages), TradeIndex(max_indexed_messages)};
+    // if enabled, received messages are also kept on disk, so they can be searched offline after a restart
+    bool keep_trade_history = false;
+    bool history_loaded = false;
+    std::vector<Message> unsaved_history[2];
+    // Held while a worker reads or writes that channel's history file
+    std::mutex history_mutexes[2];
+    clock_t history_saved = 0;
 
     bool ws_window_connecting = false;
 
     easywsclient::WebSocket* ws_window = nullptr;
+    // Channel ws_window was opened for; may differ from ChannelIndex() until a switch has reconnected. Main thread only.
+    size_t ws_window_channel = 0;
 
     RateLimiter window_rate_limiter;
 
@@ -106,6 +127,114 @@ namespace {
         pending_query_string = query.empty() ? " " : query;
         print_search_results = print_results_in_chat;
         pending_query_sent = 0;
+        local_search_pending = true;
+    }
+
+    size_t ChannelIndex()
+    {
+        return is_kamadan_chat ? 0 : 1;
+    }
+
+    std::filesystem::path HistoryPath(const size_t channel)
+    {
+        return Resources::GetPath(L"trade", channel == 0 ? L"kamadan.txt" : L"ascalon.txt");
+    }
+
+    void IndexMessage(const Message& msg, const size_t channel)
+    {
+        if (trade_indexes[channel].Add(msg) && keep_trade_history) {
+            unsaved_history[channel].push_back(msg);
+        }
+    }
+
+    // Appends messages received since the last save on a worker thread, or right away when shutting down
+    void SaveHistory(const bool blocking = false)
+    {
+        history_saved = TIMER_INIT();
+        for (size_t channel = 0; channel < _countof(unsaved_history); channel++) {
+            if (unsaved_history[channel].empty()) {
+                continue;
+            }
+            const auto append = [channel, to_save = std::move(unsaved_history[channel])] {
+                std::lock_guard lock(history_mutexes[channel]);
+                Resources::EnsureFolderExists(Resources::GetPath(L"trade"));
+                TradeIndex::AppendHistory(HistoryPath(channel), to_save);
+            };
+            unsaved_history[channel].clear();
+            if (blocking) {
+                append();
+            }
+            else {
+                Resources::EnqueueWorkerTask(append);
+            }
+        }
+    }
+
+    void LoadHistory()
+    {
+        if (history_loaded) {
+            return;
+        }
+        history_loaded = true;
+        for (size_t channel = 0; channel < _countof(trade_indexes); channel++) {
+            Resources::EnqueueWorkerTask([channel] {
+                std::unique_lock lock(history_mutexes[channel]);
+                const auto path = HistoryPath(channel);
+                size_t line_count = 0;
+                auto loaded = TradeIndex::LoadHistory(path, max_indexed_messages, &line_count);
+                if (line_count > loaded.size() * 2) {
+                    TradeIndex::SaveHistory(path, loaded); // Trim the file down to what we keep
+                }
+                lock.unlock();
+                Resources::EnqueueMainTask([channel, history = std::move(loaded)] {
+                    for (const auto& msg : history) {
+                        trade_indexes[channel].Add(msg);
+                    }
+                });
+            });
+        }
+    }
+
+    // Shows the newest messages in the local index that match query; newest first
+    std::vector<const Message*> ShowLocalResults(const TradeIndex::Query& query)
+    {
+        searched_query = query;
+        auto results = trade_indexes[ChannelIndex()].Search(query, max_shown_messages);
+        messages.clear();
+        for (auto it = results.rbegin(); it != results.rend(); ++it) {
+            messages.add(**it);
+        }
+        return results;
+    }
+
+    void PrintSearchResult(const Message& msg)
+    {
+        const std::wstring name_ws = TextUtils::StringToWString(msg.name);
+        const std::wstring msg_ws = TextUtils::StringToWString(msg.message);
+        const time_t ts = msg.timestamp;
+        const tm* local_tm = localtime(&ts);
+        if (local_tm) {
+            wchar_t buf[512];
+            swprintf(buf, 512, L"<a=1>%s</a> @ %S %d, %02d:%02d: <c=#f96677><quote>%s", name_ws.c_str(), months[local_tm->tm_mon], local_tm->tm_mday, local_tm->tm_hour, local_tm->tm_min, msg_ws.c_str());
+            WriteChat(GW::Chat::Channel::CHANNEL_TRADE, buf, nullptr, true);
+        }
+    }
+
+    // Answers the pending search from the local index. The server is still asked for the latest messages, or when it may have older matches than we do.
+    void AnswerSearchLocally()
+    {
+        const auto query = TradeIndex::ParseQuery(pending_query_string);
+        const auto results = ShowLocalResults(query);
+        if (query.empty() || results.size() < max_shown_messages) {
+            return;
+        }
+        if (print_search_results) {
+            for (size_t i = std::min<size_t>(results.size(), 12) - 1; i < results.size(); i--) {
+                PrintSearchResult(*results[i]);
+            }
+        }
+        pending_query_string.clear();
+        print_search_results = false;
     }
 
     bool parse_json_message(const json& js, Message* msg)
@@ -206,7 +335,7 @@ void TradeWindow::Initialize()
 {
     ToolboxWindow::Initialize();
 
-    messages = CircularBuffer<Message>(100);
+    messages = CircularBuffer<Message>(max_shown_messages);
 
     should_stop = false;
     worker = new std::thread([this] {
@@ -222,8 +351,8 @@ void TradeWindow::Initialize()
     });
     GW::Chat::CreateCommand(&ChatCmd_HookEntry, L"pc", CmdPricecheck);
     // local messages
-    GW::StoC::RegisterPacketCallback<GW::Packet::StoC::MessageLocal>(&OnMessageLocal_Entry, OnMessageLocal);
-    GW::StoC::RegisterPostPacketCallback(&OnPartySearch_Entry, GAME_SMSG_PARTY_SEARCH_ADVERTISEMENT, [](GW::HookStatus*, void* pak) {
+    FrameProfiler::RegisterPacketCallback<GW::Packet::StoC::MessageLocal>(&OnMessageLocal_Entry, OnMessageLocal);
+    FrameProfiler::RegisterPostPacketCallback(&OnPartySearch_Entry, GAME_SMSG_PARTY_SEARCH_ADVERTISEMENT, [](GW::HookStatus*, void* pak) {
         const struct Packet {
             uint32_t header;
             uint32_t other_atts[7];
@@ -235,14 +364,15 @@ void TradeWindow::Initialize()
             FindPlayerPartySearch();
         }
     });
-    GW::StoC::RegisterPostPacketCallback(&OnPartySearch_Entry, GAME_SMSG_PARTY_SEARCH_REMOVE, FindPlayerPartySearch);
-    GW::StoC::RegisterPostPacketCallback(&OnPartySearch_Entry, GAME_SMSG_TRANSFER_GAME_SERVER_INFO, FindPlayerPartySearch);
+    FrameProfiler::RegisterPostPacketCallback(&OnPartySearch_Entry, GAME_SMSG_PARTY_SEARCH_REMOVE, FindPlayerPartySearch);
+    FrameProfiler::RegisterPostPacketCallback(&OnPartySearch_Entry, GAME_SMSG_TRANSFER_GAME_SERVER_INFO, FindPlayerPartySearch);
     FindPlayerPartySearch();
 
 }
 void TradeWindow::Terminate()
 {
     ToolboxWindow::Terminate();
+    SaveHistory(true);
     should_stop = true;
     if (worker) {
         ASSERT(worker->joinable());
@@ -286,10 +416,20 @@ bool TradeWindow::GetInAscalonAE1(const bool check_district)
 
 void TradeWindow::Update(const float)
 {
+    if (local_search_pending) {
+        local_search_pending = false;
+        AnswerSearchLocally();
+    }
+    if (TIMER_DIFF(history_saved) > 30000) {
+        SaveHistory();
+    }
     if (ws_window && ws_window->getReadyState() == WebSocket::CLOSED) {
         delete ws_window;
         ws_window = nullptr;
     }
+    if (ws_window && !ws_window_connecting && ws_window_channel != ChannelIndex()) {
+        SwitchSockets(); // Channel was switched while the old one was still connecting
+    }
     if (ws_window && ws_window->getReadyState() != WebSocket::CLOSED) {
         ws_window->poll();
     }
@@ -313,9 +453,7 @@ void TradeWindow::fetch()
     }
     const bool search_pending = !pending_query_sent && !pending_query_string.empty();
     if (search_pending) {
-        //strcpy(search_buffer, pending_query_string.c_str());
-        // Fill searched_words; query to lower to ease on-the-fly search in ::fetch
-        ParseBuffer(search_buffer, searched_words);
+        searched_query = TradeIndex::ParseQuery(pending_query_string);
 
         // Send request
         json request;
@@ -325,12 +463,16 @@ void TradeWindow::fetch()
     }
 
     ws_window->dispatch([this](const std::string& data) {
+        const auto channel = ws_window_channel;
         const json& res = json::parse(data.c_str(), nullptr, false);
         if (res == json::value_t::discarded) {
             Log::Log("ERROR: Failed to parse res JSON from response in ws_window->dispatch\n");
             return;
         }
         if (res.find("query") != res.end() && res["query"].is_string()) {
+            if (channel != ChannelIndex()) {
+                return; // Answer from the channel we switched away from
+            }
             auto query_string = res["query"].get<std::string>();
             if (query_string != pending_query_string) {
                 return; // Different query has been made since this search.
@@ -365,17 +507,10 @@ void TradeWindow::fetch()
                 if (!parse_json_message(results[i], &msg)) {
                     continue;
                 }
+                IndexMessage(msg, channel);
                 messages.add(msg);
                 if (print_search_results && i < 12) {
-                    std::wstring name_ws = TextUtils::StringToWString(msg.name);
-                    std::wstring msg_ws = TextUtils::StringToWString(msg.message);
-                    time_t ts = msg.timestamp;
-                    tm* local_tm = localtime(&ts);
-                    if (local_tm) {
-                        wchar_t buf[512];
-                        swprintf(buf, 512, L"<a=1>%s</a> @ %S %d, %02d:%02d: <c=#f96677><quote>%s", name_ws.c_str(), months[local_tm->tm_mon], local_tm->tm_mday, local_tm->tm_hour, local_tm->tm_min, msg_ws.c_str());
-                        WriteChat(GW::Chat::Channel::CHANNEL_TRADE, buf,nullptr,true);
-                    }
+                    PrintSearchResult(msg);
                 }
             }
             print_search_results = false;
@@ -386,24 +521,12 @@ void TradeWindow::fetch()
         if (!parse_json_message(res, &msg)) {
             return; // Not valid message object
         }
-        bool add_to_window = searched_words.empty();
-        if (!add_to_window) {
-            // Currently showing a search term in-window. Only add if it matches all words.
-            add_to_window = true;
-            std::string input(msg.message);
-            std::ranges::transform(input, input.begin(),
-                                   [](const char c) -> char {
-                                       return static_cast<char>(tolower(c));
-                                   });
-            for (auto& term : searched_words) {
-                if (input.find(term) != std::string::npos) {
-                    continue; // Searched word no found; drop out
-                }
-                add_to_window = false;
-                break;
-            }
+        IndexMessage(msg, channel);
+        if (channel != ChannelIndex()) {
+            return; // Still connected to the channel we switched away from
         }
-        if (add_to_window) {
+        // Currently showing a search term in-window. Only add if it matches all words.
+        if (TradeIndex::Matches(searched_query, msg)) {
             messages.add(msg);
         }
 
@@ -426,28 +549,7 @@ bool TradeWindow::IsTradeAlert(std::string& message) const
     if (!filter_alerts) {
         return true;
     }
-    std::regex word_regex;
-    std::smatch m;
-    static const auto regex_check = std::regex("^/(.*)/[a-z]?$", std::regex::ECMAScript | std::regex::icase);
-    for (const auto& word : alert_words) {
-        if (std::regex_search(word, m, regex_check)) {
-            try {
-                word_regex = std::regex(m._At(1).str(), std::regex::ECMAScript | std::regex::icase);
-            } catch (const std::exception&) {
-                // Silent fail; invalid regex
-            }
-            if (std::regex_search(message, word_regex)) {
-                return true;
-            }
-        }
-        else {
-            auto found = std::ranges::search(message, word, [](const char c1, const char c2) -> bool { return tolower(c1) == c2; }).begin();
-            if (found != message.end()) {
-                return true;
-            }
-        }
-    }
-    return false;
+    return alert_rules.Matches(message);
 }
 
 void TradeWindow::FindPlayerPartySearch(GW::HookStatus*, void*)
@@ -551,10 +653,17 @@ void TradeWindow::Draw(IDirect3DDevice9*)
     }
     else if (do_search) {
         search(search_buffer);
+        typed_query = search_buffer;
+    }
+    else if (typed_query != search_buffer) {
+        // Search as you type; only the local index, the server is asked on enter
+        typed_query = search_buffer;
+        ShowLocalResults(TradeIndex::ParseQuery(typed_query));
     }
     ImGui::SameLine();
     if (ImGui::Button("Clear", ImVec2(btn_width, 0))) {
         std::snprintf(search_buffer, _countof(search_buffer), "");
+        typed_query.clear();
         search("");
     }
     ImGui::SameLine();
@@ -705,6 +814,7 @@ void TradeWindow::DrawAlertsWindowContent(bool)
     if (ImGui::InputTextMultiline("##alertfilter", alert_buf, ALERT_BUF_SIZE,
                                   ImVec2(-1.0f, 0.0f))) {
         ParseBuffer(alert_buf, alert_words);
+        alert_rules.Build(alert_words);
         alertfile_dirty = true;
     }
     DrawChatSettings(true);
@@ -725,6 +835,10 @@ void TradeWindow::DrawChatSettings(const bool ownwindow)
 void TradeWindow::DrawSettingsInternal()
 {
     DrawAlertsWindowContent(false);
+    if (ImGui::Checkbox("Keep trade chat history", &keep_trade_history) && keep_trade_history) {
+        LoadHistory();
+    }
+    ImGui::ShowHelp("Saves received trade messages to disk, so searches can be answered without waiting for the server, even after a restart");
 }
 
 void TradeWindow::LoadSettings(ToolboxIni* ini)
@@ -735,6 +849,10 @@ void TradeWindow::LoadSettings(ToolboxIni* ini)
     LOAD_BOOL(filter_alerts);
     LOAD_BOOL(filter_local_trade);
     LOAD_BOOL(is_kamadan_chat);
+    LOAD_BOOL(keep_trade_history);
+    if (keep_trade_history) {
+        LoadHistory();
+    }
 
     strncpy(player_party_search_text, ini->GetValue(Name(), "player_party_search_text", ""), _countof(player_party_search_text) - 1);
 
@@ -744,6 +862,7 @@ void TradeWindow::LoadSettings(ToolboxIni* ini)
         alert_file.get(alert_buf, ALERT_BUF_SIZE, '\0');
         alert_file.close();
         ParseBuffer(alert_buf, alert_words);
+        alert_rules.Build(alert_words);
     }
     alert_file.close();
     SwitchSockets();
@@ -758,6 +877,8 @@ void TradeWindow::SaveSettings(ToolboxIni* ini)
     SAVE_BOOL(filter_alerts);
     SAVE_BOOL(filter_local_trade);
     SAVE_BOOL(is_kamadan_chat);
+    SAVE_BOOL(keep_trade_history);
+    SaveHistory();
 
     ini->SetValue(Name(), "player_party_search_text", player_party_search_text);
 
@@ -814,9 +935,11 @@ void TradeWindow::AsyncWindowConnect(const bool force)
         return;
     }
     ws_window_connecting = true;
-    thread_jobs.push([this] {
-        if ((ws_window = WebSocket::from_url(is_kamadan_chat ? ws_host_kmd : ws_host_asc)) == nullptr) {
-            printf("Couldn't connect to the host '%s'", is_kamadan_chat ? ws_host_kmd : ws_host_asc);
+    ws_window_channel = ChannelIndex();
+    thread_jobs.push([this, channel = ws_window_channel] {
+        const auto host = channel == 0 ? ws_host_kmd : ws_host_asc;
+        if ((ws_window = WebSocket::from_url(host)) == nullptr) {
+            printf("Couldn't connect to the host '%s'", host);
         }
         ws_window_connecting = false;
         if (messages.size() == 0 && pending_query_string.empty()) {
@@ -528,6 +528,30 @@ void CurlMulti::Perform() const
     }
 }
 
+void CurlMulti::Poll(const int timeout_ms) const
+{
+    const CURLMcode code = curl_multi_poll(m_Handle, nullptr, 0, timeout_ms, nullptr);
+    if (code != CURLM_OK) {
+        fprintf(stderr, "Error in 'CurlMulti::Poll': %s\n", curl_multi_strerror(code));
+    }
+}
+
+void CurlMulti::Wakeup() const
+{
+    const CURLMcode code = curl_multi_wakeup(m_Handle);
+    if (code != CURLM_OK) {
+        fprintf(stderr, "Error in 'CurlMulti::Wakeup': %s\n", curl_multi_strerror(code));
+    }
+}
+
+void CurlMulti::SetMaxHostConnections(const long max) const
+{
+    const CURLMcode code = curl_multi_setopt(m_Handle, CURLMOPT_MAX_HOST_CONNECTIONS, max);
+    if (code != CURLM_OK) {
+        fprintf(stderr, "Error in 'CurlMulti::SetMaxHostConnections': %s\n", curl_multi_strerror(code));
+    }
+}
+
 void ComposeUrl(std::string& url, const char* host, const char* path)
 {
     url.append(host);
@@ -193,6 +193,13 @@ public:
     void RemoveHandle(CurlEasy* Handle) const;
 
     void Perform() const;
+    // Blocks until there's activity on a transfer, Wakeup is called or timeout_ms passes
+    void Poll(int timeout_ms) const;
+    // Makes the current (or next) Poll return early; safe to call from any thread
+    void Wakeup() const;
+
+    // Transfers to a host beyond this many connections wait in curl until one frees up; 0 means no limit
+    void SetMaxHostConnections(long max) const;
 
 protected:
     CURLM* m_Handle;
@@ -1,5 +1,8 @@
 #include "stdafx.h"
 
+#include <condition_variable>
+#include <thread>
+
 #include <Thread.h>
 
 #include "RestClient.h"
@@ -7,6 +10,9 @@
 class CurlMultiThread : public Thread {
     using Container = std::deque<AsyncRestClient*>;
 
+    // Keeps a burst of requests to one host (e.g. the wiki) from opening a connection each
+    static constexpr long MaxHostConnections = 6;
+
 public:
     CurlMultiThread()
         : m_pMulti(nullptr)
@@ -30,35 +36,76 @@ public:
     void Stop()
     {
         m_Running = false;
+        m_pMulti->Wakeup();
         Join();
     }
 
+    // The multi handle is only touched on the curl thread, so it can wait in Poll without holding m_Mutex.
+    // Other threads queue their changes and wake it up.
     void Execute(AsyncRestClient* pClient)
     {
         std::lock_guard Lock(m_Mutex);
-        m_Clients.push_back(pClient);
-        m_pMulti->AddHandle(pClient);
+        m_Added.push_back(pClient);
+        m_pMulti->Wakeup();
     }
 
     void Abort(AsyncRestClient* pClient)
     {
-        std::lock_guard Lock(m_Mutex);
+        std::unique_lock Lock(m_Mutex);
+        const auto added = std::ranges::find(m_Added, pClient);
+        if (added != m_Added.end()) {
+            m_Added.erase(added);
+            return;
+        }
         const auto it = Search(pClient);
-        if (it != m_Clients.end()) {
+        if (it == m_Clients.end()) {
+            return;
+        }
+        if (std::this_thread::get_id() == m_ThreadId) {
+            // Called from a completion callback; the loop isn't polling
             m_pMulti->RemoveHandle(pClient);
             m_Clients.erase(it);
+            return;
         }
+        // The caller may free the client as soon as this returns, so wait for the curl thread to let go of it
+        m_Removed.push_back(pClient);
+        m_pMulti->Wakeup();
+        m_Aborted.wait(Lock, [&] {
+            return std::ranges::find(m_Removed, pClient) == m_Removed.end();
+        });
     }
 
 private:
+    // Longest time the loop sleeps when nothing happens; it's woken up early for new requests, aborts and curl activity
+    static constexpr int MaxPollMs = 1000;
+
     void Run() override
     {
         CurlMulti m_Multi;
+        m_Multi.SetMaxHostConnections(MaxHostConnections);
+        m_ThreadId = std::this_thread::get_id();
         m_pMulti = &m_Multi;
 
         while (m_Running) {
             {
                 std::lock_guard Lock(m_Mutex);
+                for (const auto pClient : m_Added) {
+                    m_Clients.push_back(pClient);
+                    m_Multi.AddHandle(pClient);
+                }
+                m_Added.clear();
+                if (!m_Removed.empty()) {
+                    for (const auto pClient : m_Removed) {
+                        const auto it = Search(pClient);
+                        if (it != m_Clients.end()) {
+                            m_Multi.RemoveHandle(pClient);
+                            m_Clients.erase(it);
+                        }
+                    }
+                    m_Removed.clear();
+                    m_Aborted.notify_all();
+                }
+
                 m_Multi.Perform();
 
                 int MsgsLeft;
@@ -70,9 +117,12 @@ private:
 
                     pMsg = curl_multi_info_read(m_Multi.GetHandle(), &MsgsLeft);
                 }
+                if (!m_Added.empty() || !m_Removed.empty()) {
+                    continue; // Queued from a completion callback
+                }
             }
 
-            Sleep(16);
+            m_Multi.Poll(MaxPollMs);
         }
 
         m_pMulti = nullptr;
@@ -111,7 +161,11 @@ private:
         return pClient;
     }
 
-    Container m_Clients;
+    Container m_Clients; // Added to the multi handle; only changed on the curl thread
+    Container m_Added;   // Waiting to be added by the curl thread
+    Container m_Removed; // Waiting to be removed by the curl thread; Abort blocks until it's done
+    std::condition_variable_any m_Aborted;
+    std::thread::id m_ThreadId;
     CurlMulti* m_pMulti;
     std::atomic<bool> m_Running;
     std::recursive_mutex m_Mutex;